@@ -946,6 +946,42 @@ static void compare()
     }
 }
 
+// Prints the throughput of `fastHash::hash` for each length bucket. Lengths at or above `fastHash::bulkLength` take the
+// four lane path
+static void timeStringHashing()
+{
+    static constexpr std::array<u64, 9u> lengths{8u, 16u, 32u, 64u, 128u, 256u, 512u, 1024u, 2048u};
+    static constexpr u64 totalBytes{u64(1u) << 30};
+
+    qc::Random<u64> random{};
+    std::vector<std::byte> data(lengths.back());
+    for (std::byte & b : data)
+    {
+        b = std::byte(random.next<u8>());
+    }
+
+    std::cout << std::setw(8) << "Length" << std::setw(12) << "Per hash" << std::setw(12) << "GB/s" << std::endl;
+
+    for (const u64 length : lengths)
+    {
+        const u64 roundN{totalBytes / length};
+
+        // Feed each hash into the next round's data so the hashes can't be overlapped or skipped
+        u64 h{0u};
+        const s64 t0{now()};
+        for (u64 round{0u}; round < roundN; ++round)
+        {
+            data[round & (length - 1u)] ^= std::byte(h);
+            h = qc::hash::fastHash::hash<u64>(data.data(), length);
+        }
+        const s64 t1{now()};
+
+        std::cout << std::setw(8) << length;
+        printTime((t1 - t0) / s64(roundN), 12u);
+        std::cout << std::setw(12) << std::fixed << std::setprecision(2) << f64(totalBytes) / f64(t1 - t0) << std::endl;
+    }
+}
+
 template <typename K, bool sizeMode = false, bool doTrivialComplex = false>
 struct QcHashSetInfo
 {
@@ -956,6 +992,15 @@ struct QcHashSetInfo
     static inline const std::string name{sizeMode ? std::format("{}{}", (doTrivialComplex ? isTrivial ? "Trivial " : "Complex " : ""), sizeof(K)) : "qc::hash::RawSet"};
 };
 
+template <typename K>
+struct QcHashHugePageSetInfo
+{
+    using Container = qc::hash::RawSet<K, typename qc::hash::RawSet<K>::hasher, qc::hash::HugePageAllocator<K>>;
+    using AllocatorContainer = void;
+
+    static inline const std::string name{"qc::hash::RawSet (huge pages)"};
+};
+
 template <typename K, typename V, bool sizeMode = false, bool doTrivialComplex = false>
 struct QcHashMapInfo
 {
@@ -1110,6 +1155,18 @@ s32 main()
             TslRobinMapInfo<K, V>,
             TslSparseMapInfo<K, V>>();
     }
+    // Huge pages vs normal pages. Only the largest sizes outgrow the last level cache and TLB reach, so that is where
+    // AccessPresent should differ. Run under `perf stat -e dTLB-load-misses` to see the misses themselves
+    else if constexpr (false)
+    {
+        using K = u64;
+        compare<CompareMode::oneVsOne, K, QcHashSetInfo<K>, QcHashHugePageSetInfo<K>>();
+    }
+    // String hashing throughput by length
+    else if constexpr (false)
+    {
+        timeStringHashing();
+    }
     // Architecture comparison
     else if constexpr (false)
     {
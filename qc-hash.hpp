@@ -17,32 +17,72 @@
 ///   - Vacant: Indicates the slot has never had an element
 ///   - Grave: Means the slot used to have an element, but it was erased
 ///   - Size: The number of elements in the map/set
-///   - Capacity: The number of elements that the map/set can currently hold without growing. Exactly half the number of
-///       slots and always a power of two
+///   - Capacity: The number of elements that the map/set can currently hold without growing. The number of slots
+///       scaled by the max load factor, which is one half by default
 ///   - Special Slots: Two slots tacked on to the end of the backing array in addition to the reported capacity. Used to
 ///       hold the special elements if they are present
 ///   - Special Elements: The elements whose keys match the "vacant" or "grave" constants. Stored in the special slots
 ///
+/// SIMD instructions are used where the target supports them. Define `QC_HASH_DISABLE_SIMD` to force scalar code
+///
 
 #if defined _CPPUNWIND || defined __cpp_exceptions
     #define QC_HASH_EXCEPTIONS_ENABLED
 #endif
 
+#ifndef QC_HASH_DISABLE_SIMD
+    #if defined __AVX512F__ && defined __AVX512DQ__
+        #define QC_HASH_AVX512_ENABLED
+    #endif
+    #if defined __AVX2__
+        #define QC_HASH_AVX2_ENABLED
+    #endif
+    #if defined __SSE2__ || defined _M_X64
+        #define QC_HASH_SSE2_ENABLED
+    #endif
+#endif
+
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
+#if defined __linux__
+    #define QC_HASH_MMAP_ENABLED
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#if defined QC_HASH_AVX2_ENABLED
+    #include <immintrin.h>
+#elif defined QC_HASH_SSE2_ENABLED
+    #include <emmintrin.h>
+#endif
+
+#include <atomic>
 #include <bit>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <span>
 #ifdef QC_HASH_EXCEPTIONS_ENABLED
     #include <stdexcept>
+    #include <system_error>
 #endif
 #include <string>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace qc::hash
 {
@@ -73,6 +113,34 @@ namespace qc::hash
         /// Must be a power of two
         ///
         inline constexpr u64 minMapCapacity{16u};
+
+        ///
+        /// The number of shards a `ShardedRawMap` is split into by default
+        ///
+        inline constexpr u64 defaultShardN{64u};
+
+        ///
+        /// The size of the huge pages `HugePageAllocator` asks for, and the allocation size at or above which it maps
+        /// memory directly rather than going through `operator new`
+        ///
+        inline constexpr u64 hugePageSize{u64{1u} << 21};
+
+        ///
+        /// The share of bucket slots a `FrozenRawMap` is built to fill. Buckets are only added when cuckoo insertion
+        /// fails to place enough of the elements
+        ///
+        inline constexpr f32 frozenLoadFactor{0.95f};
+
+        ///
+        /// The value size at or above which `Map` stores values apart from keys, see `RawPolicy::splitStorage`
+        ///
+        inline constexpr u64 splitValueSize{64u};
+
+        ///
+        /// The most memory `Map` will spend on the value array of a `DirectMap`, which has one value per possible key.
+        /// Maps with one or two byte keys whose value array would be larger fall back to `RawMap`
+        ///
+        inline constexpr u64 directValueMemory{u64{1u} << 19};
     }
 
     ///
@@ -128,6 +196,47 @@ namespace qc::hash
     template <typename T1, typename T2> struct IsUniquelyRepresentable<std::pair<T1, T2>> : std::bool_constant<IsUniquelyRepresentable<T1>::value && IsUniquelyRepresentable<T2>::value> {};
     template <typename CharT, typename Traits> struct IsUniquelyRepresentable<std::basic_string_view<CharT, Traits>> : std::false_type{};
 
+    ///
+    /// Key adapter that gives a `float` or `double` a unique representation so it may be used as a raw key
+    ///
+    /// Negative zero is stored as positive zero and every NaN is stored as the same quiet NaN, so all values that should
+    /// be the same key have the same bits. A plain float may also be used as a key for lookup and insertion, and is
+    /// canonicalized first
+    ///
+    /// @tparam T the floating point type
+    ///
+    template <typename T>
+    class CanonicalFloat
+    {
+        static_assert(std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4u || sizeof(T) == 8u));
+
+      public:
+
+        ///
+        /// Default constructs to positive zero
+        ///
+        constexpr CanonicalFloat() = default;
+
+        ///
+        /// @param v the value to canonicalize
+        ///
+        constexpr CanonicalFloat(T v);
+
+        ///
+        /// @returns the canonical value
+        ///
+        [[nodiscard]] constexpr operator T() const;
+
+        ///
+        /// Unlike floating point comparison, NaN is equal to NaN and the zeros are not distinct
+        ///
+        [[nodiscard]] constexpr bool operator==(const CanonicalFloat &) const = default;
+
+      private:
+
+        Unsigned<sizeof(T)> _bits{};
+    };
+
     ///
     /// A key type must meet this requirement to work with this map/set implementation. Essentially there must be a
     /// one-to-one mapping between the raw binary and the logical value of a key
@@ -176,6 +285,12 @@ namespace qc::hash
     ///
     template <typename T> struct IdentityHash<std::shared_ptr<T>>;
 
+    ///
+    /// Specialization of `IdentityHash` for `CanonicalFloat`. Floats commonly have all zero low mantissa bits, so the bits
+    /// are mixed rather than used directly
+    ///
+    template <typename T> struct IdentityHash<CanonicalFloat<T>>;
+
     ///
     /// A very fast/minimal non-crytographic hash purely to improve collision rates for keys with poor low-order entropy
     ///
@@ -213,6 +328,20 @@ namespace qc::hash
     ///
     template <> struct FastHash<std::string_view>;
 
+    ///
+    /// Hashes as `IdentityHash` until told to switch, from then on hashing as `FastHash`
+    ///
+    /// A `RawMap` or `RawSet` using this hasher watches the probe length of each insertion. Once one reaches
+    /// `P::adaptiveProbeLimit`, which identity hashing makes likely for keys that share their low bits, such as multiples
+    /// of a power of two, it switches the hasher and rehashes. Well distributed keys keep identity hashing for good
+    ///
+    /// Whether a map/set has switched may be seen with `hash_function().isMixing()`. The choice is copied and moved
+    /// along with the hasher
+    ///
+    /// Any hasher providing `isMixing()` and `startMixing()` in the same manner is treated as adaptive
+    ///
+    template <Rawable T> class AdaptiveHash;
+
     namespace fastHash
     {
         ///
@@ -234,11 +363,31 @@ namespace qc::hash
         ///
         /// Direct FastHash function that hashes the given data
         ///
+        /// A 64 bit hash of at least `bulkLength` bytes mixes four words at a time into four independent lanes, so their
+        /// multiplies overlap. This roughly doubles throughput for long strings, but yields different hashes than the one
+        /// word at a time loop used below that length
+        ///
         /// @param data the data to hash
         /// @param length the length of the data in bytes
         /// @return the hash of the data
         ///
         template <UnsignedInteger H> [[nodiscard]] H hash(const void * data, u64 length);
+
+        ///
+        /// The length in bytes at or above which a 64 bit hash takes the four lane path
+        ///
+        inline constexpr u64 bulkLength{64u};
+
+        ///
+        /// Hashes each value exactly as `hash<u64>` would, many at once
+        ///
+        /// Values of four or eight bytes are mixed eight at a time with AVX-512, or four at a time with AVX2, whose lack
+        /// of a 64 bit multiply makes for a smaller gain. Other values, and other targets, are hashed one at a time
+        ///
+        /// @param vs the values to hash
+        /// @param out receives the hash of each value; must be at least as long as `vs`
+        ///
+        template <typename T> void hash_n(std::span<const T> vs, std::span<u64> out);
     }
 
     ///
@@ -253,15 +402,285 @@ namespace qc::hash
     template <typename T, typename TOther> requires (std::is_same_v<std::decay_t<T>, std::decay_t<TOther>> || std::is_base_of_v<T, TOther>) struct IsCompatible<T *, TOther *> : std::true_type {};
     template <typename T, typename TOther> requires (std::is_same_v<std::decay_t<T>, std::decay_t<TOther>> || std::is_base_of_v<T, TOther>) struct IsCompatible<std::unique_ptr<T>, TOther *> : std::true_type {};
     template <typename T, typename TOther> requires (std::is_same_v<std::decay_t<T>, std::decay_t<TOther>> || std::is_base_of_v<T, TOther>) struct IsCompatible<std::shared_ptr<T>, TOther *> : std::true_type {};
+    template <typename T> struct IsCompatible<CanonicalFloat<T>, T> : std::true_type {};
 
     ///
-    /// Specifies whether a key of type `KOther` may be used for lookup operations on a map/set with key type `K`
+    /// Specifies whether a key of type `KOther` may be used for lookup operations on a map/set with key type `K`. The
+    /// one key that need not be rawable is a plain float for a `CanonicalFloat`, which is canonicalized first
     ///
-    template <typename KOther, typename K> concept Compatible = Rawable<K> && Rawable<KOther> && IsCompatible<K, KOther>::value;
+    template <typename KOther, typename K> concept Compatible = Rawable<K> && (Rawable<KOther> || std::is_same_v<K, CanonicalFloat<KOther>>) && IsCompatible<K, KOther>::value;
+
+    #ifdef QC_HASH_SSE2_ENABLED
+        namespace _private::simd
+        {
+            #ifdef QC_HASH_AVX2_ENABLED
+                using Block = __m256i;
+            #else
+                using Block = __m128i;
+            #endif
+
+            inline constexpr u64 blockSize{sizeof(Block)};
+
+            // Loads a block from unaligned memory
+            Block load(const void * data);
+
+            // Returns a byte mask of the block with only the lowest bit of each lane equal to `v` set
+            template <UnsignedInteger U> u32 matchMask(const Block & block, U v);
+
+            // Returns the mask `matchMask` would return were every lane to match
+            template <UnsignedInteger U> constexpr u32 fullMask();
+
+            // Returns whether any lane of the `blockN` consecutive blocks at `data` equals `v`. Needs only one movemask
+            template <u64 blockN, UnsignedInteger U> bool matchAny(const void * data, U v);
+
+            #ifdef QC_HASH_AVX2_ENABLED
+                // Hashes as many whole vectors' worth of the `n` words of `wordSize` bytes as `fastHash::hash<u64>` would,
+                // returning how many were hashed
+                template <u64 wordSize> u64 hashWords(const void * words, u64 n, u64 * out);
+            #endif
+        }
+    #endif
+
+    namespace _private
+    {
+        // Iterator state in addition to the slot pointer. Empty unless values are stored separately from keys
+        template <typename V> struct IteratorValue { V * _value; };
+        template <> struct IteratorValue<void> {};
+
+        // Hints that the memory at the address will soon be read
+        void prefetch(const void * address);
+
+        // Operation counts kept by a `RawMap` whose policy sets `countOperations`
+        struct RawCounts
+        {
+            u64 hashN;
+            u64 lookupN;
+            u64 probeN;
+            u64 rehashN;
+        };
+
+        // Stands in for `RawCounts` when not counting, taking no space
+        struct NoRawCounts {};
+
+        // A hasher that can hash a span of keys at once, see `FastHash::hash_n`
+        template <typename H, typename K> concept BatchHasher = requires (const H & hash, std::span<const K> keys, std::span<u64> out) { hash.hash_n(keys, out); };
+
+        // Whether a hasher's output is already well mixed across all its bits, and so needs no further mixing
+        template <typename H> struct IsMixingHasher : std::false_type {};
+        template <typename T> struct IsMixingHasher<FastHash<T>> : std::true_type {};
+
+        // A hasher that may be told to switch from identity to mixing, see `AdaptiveHash`
+        template <typename H> concept AdaptiveHasher = requires (H & hash, const H & constHash) { bool{constHash.isMixing()}; hash.startMixing(); };
+
+        // Keys and values whose bytes may be written out and read back in as they are
+        template <typename K, typename V> concept Snapshottable = std::is_trivially_copyable_v<K> && (std::is_same_v<V, void> || std::is_trivially_copyable_v<V>);
+
+        // Leads every snapshot file. The slot array follows at `snapshotDataOffset`
+        struct SnapshotHeader
+        {
+            u64 magic;
+            u32 version;
+            u32 isSplit;
+            u64 keySize;
+            u64 valueSize;
+            u64 elementSize;
+            u64 slotN;
+            u64 size;
+            u64 graveN;
+            u64 hashFingerprint;
+            f32 maxLoadFactor;
+            u8 haveSpecial[2];
+            u8 isRobinHood;
+        };
+
+        // "QCHSNAP" in ASCII. Not a palindrome, so a snapshot from a machine of the other byte order is caught too
+        inline constexpr u64 snapshotMagic{0x51'43'48'53'4E'41'50'00u};
+        inline constexpr u32 snapshotVersion{2u};
+        inline constexpr u64 snapshotDataOffset{128u};
+        static_assert(sizeof(SnapshotHeader) <= snapshotDataOffset);
+
+        // A slot of a concurrent map. The state says whether the value has been published
+        template <typename RawKey, typename V> struct ConcurrentSlot
+        {
+            static_assert(std::atomic<V>::is_always_lock_free);
+
+            std::atomic<RawKey> key;
+            std::atomic<u8> state;
+            std::atomic<V> value;
+
+            ConcurrentSlot(RawKey key);
+        };
+
+        // Returns an index unique to the calling thread, handed out in order of first call
+        u64 threadIndex();
+    }
 
     // Used for testing
     struct RawFriend;
 
+    ///
+    /// Compile-time configuration of `RawMap` and `RawSet`
+    ///
+    /// To customize, derive from this struct and shadow the desired members. Any member not shadowed keeps its default
+    ///
+    struct RawPolicy
+    {
+        ///
+        /// The ratio of elements to slots above which the map/set grows. Must be within (0, 1]. Regardless, at least one
+        /// slot is always kept vacant
+        ///
+        /// Higher values save memory at the cost of longer probe sequences. Serves as the initial value for each map/set,
+        /// which may then be changed at run time via `max_load_factor(f32)`
+        ///
+        inline static constexpr f32 maxLoadFactor{0.5f};
+
+        ///
+        /// Whether a map stores its keys and values in two separate parallel arrays instead of together as pairs. Has no
+        /// effect on sets
+        ///
+        /// Probing then only touches keys, and a value is only touched once its key is found. Worthwhile for large value
+        /// types. Iterators then dereference to a `std::pair<const K &, V &>` proxy rather than a `std::pair<K, V> &`
+        ///
+        inline static constexpr bool splitStorage{false};
+
+        ///
+        /// Whether erasing an element shifts the following elements of its probe sequence back to fill the hole, rather
+        /// than leaving a grave behind
+        ///
+        /// No graves are ever created, so probe sequences stay short under sustained insertion and erasure. Erasing costs
+        /// more, and invalidates iterators to elements other than the erased one
+        ///
+        inline static constexpr bool backwardShiftErase{false};
+
+        ///
+        /// The ratio of elements plus graves to slots at which inserting into a vacant slot first purges the graves in
+        /// place. Must be within (0, 1]. Effectively never less than the max load factor, and at least one slot is always
+        /// kept vacant
+        ///
+        /// Lower values keep probe sequences shorter under sustained insertion and erasure at the cost of purging more
+        /// often. Has no effect with `backwardShiftErase`, as no graves are created
+        ///
+        inline static constexpr f32 gravePurgeThreshold{0.75f};
+
+        ///
+        /// Whether to use Robin Hood probing. An inserted element takes the slot of the first element it finds that is
+        /// closer to its own ideal slot, shifting the rest of the probe sequence forward
+        ///
+        /// Probe lengths vary much less, and a lookup for an absent key stops as soon as it reaches an element closer to
+        /// its ideal slot, rather than running on to the next vacant slot. Ideal slots are recomputed by hashing, so it
+        /// best suits cheap hashers. Implies `backwardShiftErase`. Block probing is not used
+        ///
+        inline static constexpr bool robinHood{false};
+
+        ///
+        /// The slot count at or above which growing rehashes are split across `std::thread::hardware_concurrency()`
+        /// threads, as with `rehash(u64, u64)`. Zero never does
+        ///
+        inline static constexpr u64 parallelRehashSlotN{0u};
+
+        ///
+        /// Whether the map/set counts its hash calls, lookups, probes, and rehashes, as reported by `stats()`
+        ///
+        /// Costs a few increments per operation and 32 bytes per map/set. Counting is not synchronized, so a map/set may
+        /// then no longer be read by several threads at once
+        ///
+        inline static constexpr bool countOperations{false};
+
+        ///
+        /// The probe length of an insertion at or above which a map/set whose hasher is adaptive, such as `AdaptiveHash`,
+        /// switches it from identity hashing to mixing and rehashes. Has no effect with other hashers
+        ///
+        /// Well distributed keys almost never probe this far below the default max load factor
+        ///
+        inline static constexpr u64 adaptiveProbeLimit{64u};
+    };
+
+    ///
+    /// Probe and occupancy statistics of a `RawMap` or `RawSet`, as returned by `stats()`
+    ///
+    struct RawStats
+    {
+        ///
+        /// Element `i` is the number of elements `i` slots past their ideal slot, each of which takes `i + 1` probes to
+        /// find. Excludes the special elements
+        ///
+        std::vector<u64> probeLengths;
+
+        ///
+        /// The mean and greatest number of slots the elements are past their ideal slots
+        ///
+        f64 meanDisplacement;
+        u64 maxDisplacement;
+
+        ///
+        /// The number of graves
+        ///
+        u64 graveN;
+
+        ///
+        /// The longest run of consecutive slots holding elements or graves. Bounds the probes of a lookup for an absent key
+        ///
+        u64 largestCluster;
+
+        ///
+        /// The number of special elements, those whose raw keys are the vacant or grave key, which are kept apart from the
+        /// slots
+        ///
+        u64 specialN;
+
+        ///
+        /// The number of hasher calls, lookups of keys not being inserted, probes of those lookups, and rehashes since
+        /// construction. Zero unless `P::countOperations` is set
+        ///
+        u64 hashN;
+        u64 lookupN;
+        u64 probeN;
+        u64 rehashN;
+    };
+
+    ///
+    /// An allocator for very large slot arrays. Allocations of at least `hugePageSize` bytes are mapped directly, backed
+    /// by huge pages where the system allows, and pre-faulted so that clearing the keys and the first probes don't fault
+    /// a page at a time. Smaller allocations go through `operator new`
+    ///
+    /// Huge pages cut the number of TLB entries a large table needs by a factor of 512, which keeps random probes of a
+    /// table far larger than the last level cache from also missing the TLB
+    ///
+    /// Explicit huge pages are tried first, followed by transparent huge pages, followed by normal pages. Only Linux is
+    /// supported; elsewhere every allocation goes through `operator new`
+    ///
+    /// Stateless, so all instances compare equal
+    ///
+    /// @tparam T the element type
+    ///
+    template <typename T> class HugePageAllocator
+    {
+      public:
+
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        constexpr HugePageAllocator() noexcept = default;
+
+        template <typename U> constexpr HugePageAllocator(const HugePageAllocator<U> &) noexcept {}
+
+        ///
+        /// @param n the number of elements to allocate
+        /// @returns the uninitialized memory
+        /// @throws `std::bad_alloc` if the memory could not be allocated
+        ///
+        [[nodiscard]] T * allocate(u64 n);
+
+        ///
+        /// @param p the memory to free, as returned by `allocate`
+        /// @param n the number of elements, as passed to `allocate`
+        ///
+        void deallocate(T * p, u64 n) noexcept;
+
+        template <typename U> [[nodiscard]] constexpr bool operator==(const HugePageAllocator<U> &) const noexcept { return true; }
+    };
+
     ///
     /// An associative container that stores unique-key key-pair values. Uses a flat memory model, linear probing, and a
     /// whole lot of optimizations that make this an extremely fast map for small elements
@@ -273,10 +692,16 @@ namespace qc::hash
     /// @tparam K the key type
     /// @tparam V the mapped value type
     /// @tparam H the functor type for hashing keys
-    /// @tparam KE the functor type for checking key equality
     /// @tparam A the allocator type
+    /// @tparam P the compile-time policy, see `RawPolicy`
     ///
-    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>> class RawMap;
+    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>, typename P = RawPolicy> class RawMap;
+
+    template <Rawable K, typename V, typename H, typename A, typename P> class IncrementalRawMap;
+
+    template <Rawable K, typename V, typename H, typename A, typename P> class RawMapView;
+
+    template <Rawable K, typename V, typename H, typename A> class FrozenRawMap;
 
     ///
     /// An associative container that stores unique-key key-pair values. Uses a flat memory model, linear probing, and a
@@ -292,23 +717,34 @@ namespace qc::hash
     /// @tparam K the key type
     /// @tparam H the functor type for hashing keys
     /// @tparam A the allocator type
+    /// @tparam P the compile-time policy, see `RawPolicy`
     ///
-    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>> using RawSet = RawMap<K, void, H, A>;
+    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>, typename P = RawPolicy> using RawSet = RawMap<K, void, H, A, P>;
 
-    template <Rawable K, typename V, typename H, typename A> class RawMap
+    template <Rawable K, typename V, typename H, typename A, typename P> class RawMap
     {
         inline static constexpr bool _isSet{std::is_same_v<V, void>};
         inline static constexpr bool _isMap{!_isSet};
+        inline static constexpr bool _isSplit{_isMap && P::splitStorage};
+        inline static constexpr bool _isBackwardShift{P::backwardShiftErase || P::robinHood};
+        inline static constexpr bool _isAdaptive{_private::AdaptiveHasher<H>};
 
         ///
         /// Element type
         ///
         using E = std::conditional_t<_isSet, K, std::pair<K, V>>;
 
+        ///
+        /// Slot type. The element itself, or just the key if values are stored separately
+        ///
+        using _Slot = std::conditional_t<_isSplit, K, E>;
+
         // Internal iterator class forward declaration. Prefer `iterator` and `const_iterator`
         template <bool constant> class _Iterator;
 
         friend ::qc::hash::RawFriend;
+        friend ::qc::hash::IncrementalRawMap<K, V, H, A, P>;
+        friend ::qc::hash::RawMapView<K, V, H, A, P>;
 
       public:
 
@@ -325,13 +761,16 @@ namespace qc::hash
         static_assert(std::is_move_assignable_v<A> || !std::allocator_traits<A>::propagate_on_container_move_assignment::value);
         static_assert(std::is_swappable_v<A> || !std::allocator_traits<A>::propagate_on_container_swap::value);
 
+        static_assert(P::maxLoadFactor > 0.0f && P::maxLoadFactor <= 1.0f);
+        static_assert(P::gravePurgeThreshold > 0.0f && P::gravePurgeThreshold <= 1.0f);
+
         using key_type = K;
         using mapped_type = V;
         using value_type = E;
         using hasher = H;
         using allocator_type = A;
-        using reference = E &;
-        using const_reference = const E &;
+        using reference = std::conditional_t<_isSplit, std::pair<const K &, std::add_lvalue_reference_t<V>>, E &>;
+        using const_reference = std::conditional_t<_isSplit, std::pair<const K &, std::add_lvalue_reference_t<const V>>, const E &>;
         using pointer = E *;
         using const_pointer = const E *;
         using size_type = u64;
@@ -343,7 +782,8 @@ namespace qc::hash
         ///
         /// Constructs a new map/set
         ///
-        /// The number of backing slots will be the smallest power of two greater than or equal to twice `capacity`
+        /// The number of backing slots will be the smallest power of two that can hold `capacity` elements without
+        /// exceeding the max load factor
         ///
         /// Memory is not allocated until the first element is inserted
         ///
@@ -358,8 +798,8 @@ namespace qc::hash
         ///
         /// Constructs a new map/set from copies of the elements within the iterator range
         ///
-        /// The number of backing slots will be the smallest power of two greater than or equal to twice the larger of
-        /// `capacity` or the number of elements within the iterator range
+        /// The number of backing slots will be the smallest power of two that can hold the larger of `capacity` or the
+        /// number of elements within the iterator range without exceeding the max load factor
         ///
         /// @param first iterator to the first element to copy, inclusive
         /// @param last iterator to the last element to copy, exclusive
@@ -373,8 +813,8 @@ namespace qc::hash
         ///
         /// Constructs a new map/set from copies of the elements in the initializer list
         ///
-        /// The number of backing slots will be the smallest power of two greater than or equal to twice the larger of
-        /// `capacity` or the number of elements in the initializer list
+        /// The number of backing slots will be the smallest power of two that can hold the larger of `capacity` or the
+        /// number of elements in the initializer list without exceeding the max load factor
         ///
         /// @param elements the elements to copy
         /// @param capacity the minumum capacity
@@ -453,12 +893,16 @@ namespace qc::hash
         ///
         /// Copies each element in [`first`, `last`) into the map/set if its key is not already present
         ///
+        /// If the range is a forward range, the map/set is first grown once to fit every element, and the slots of a
+        /// window of upcoming elements are prefetched ahead of their insertion
+        ///
         /// Invalidates iterators if there is a rehash
         ///
         /// @param first the first element in the range to insert, inclusive
         /// @param last the last element in the range to insert, exclusive
+        /// @returns the number of elements inserted
         ///
-        template <typename It> void insert(It first, It last);
+        template <typename It> u64 insert(It first, It last);
 
         ///
         /// Copies each element in the initializer list into the map/set if its key is not already present
@@ -466,8 +910,9 @@ namespace qc::hash
         /// Invalidates iterators if there is a rehash
         ///
         /// @param elements the elements to insert
+        /// @returns the number of elements inserted
         ///
-        void insert(std::initializer_list<E> elements);
+        u64 insert(std::initializer_list<E> elements);
 
         ///
         /// Copies the element into the map/set if its key is not already present
@@ -556,7 +1001,8 @@ namespace qc::hash
         ///
         /// Undefined behavior if position is the end iterator or otherwise invalid
         ///
-        /// Does *not* invalidate iterators
+        /// Does *not* invalidate iterators, unless `P::backwardShiftErase` or `P::robinHood` is set, in which case all
+        /// iterators but `position` are invalidated. Incrementing `position` is then undefined
         ///
         /// @param position position of the element to erase
         ///
@@ -583,6 +1029,18 @@ namespace qc::hash
         ///
         template <Compatible<K> K_> [[nodiscard]] u64 count(const K_ & key) const;
 
+        ///
+        /// Checks for many keys at once
+        ///
+        /// The slots of a window of keys are computed and prefetched before any of them are probed, overlapping the cache
+        /// misses of tables too large to stay in cache
+        ///
+        /// @param keys the keys to check for
+        /// @param out receives whether each key is present; must be at least as long as `keys`
+        /// @returns the number of keys present
+        ///
+        u64 contains_batch(std::span<const K> keys, std::span<bool> out) const;
+
         #ifdef QC_HASH_EXCEPTIONS_ENABLED
             ///
             /// Gets the present element for the heterogeneous key
@@ -622,6 +1080,19 @@ namespace qc::hash
         [[nodiscard]] const_iterator end() const;
         [[nodiscard]] const_iterator cend() const;
 
+        ///
+        /// Calls `fn` with each element, in the same order as iteration
+        ///
+        /// Much faster than iterating, as slots are scanned a block at a time where possible, and the special slots are
+        /// checked only once at the end. `fn` receives the same type as dereferencing an iterator
+        ///
+        /// `fn` must not insert or erase elements
+        ///
+        /// @param fn the function to call with each element
+        ///
+        template <typename Fn> void for_each(Fn && fn);
+        template <typename Fn> void for_each(Fn && fn) const;
+
         ///
         /// @param key the key to find
         /// @returns an iterator to the element for the key if present, or the end iterator if absent
@@ -629,15 +1100,26 @@ namespace qc::hash
         template <Compatible<K> K_> [[nodiscard]] iterator find(const K_ & key);
         template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
 
+        ///
+        /// Finds many keys at once, prefetching in the same manner as `contains_batch`
+        ///
+        /// @param keys the keys to find
+        /// @param out receives an iterator to the element for each key if present, or the end iterator if absent; must
+        ///   be at least as long as `keys`
+        /// @returns the number of keys present
+        ///
+        u64 find_batch(std::span<const K> keys, std::span<iterator> out);
+        u64 find_batch(std::span<const K> keys, std::span<const_iterator> out) const;
+
         ///
         /// @returns the index of the slot into which the heterogeneous key would fall
         ///
         template <Compatible<K> K_> [[nodiscard]] u64 slot(const K_ & key) const;
 
         ///
-        /// Ensures there are enough slots to comfortably hold `capacity` number of elements
+        /// Ensures there are enough slots to hold `capacity` number of elements without exceeding the max load factor
         ///
-        /// Equivalent to `rehash(2 * capacity)`
+        /// Equivalent to `rehash` with the smallest slot count whose capacity is at least `capacity`
         ///
         /// Invalidates iterators if there is a rehash
         ///
@@ -646,10 +1128,17 @@ namespace qc::hash
         void reserve(u64 capacity);
 
         ///
-        /// Ensures the number of slots is equal to the smallest power of two greater than or equal to both `slotN`
-        /// and the current size, down to a minimum of `config::minMapSlotN`
+        /// Same as `reserve`, but a growing rehash is split across up to `threadN` threads. See `rehash(u64, u64)`
+        ///
+        /// @param capacity the minimum capacity
+        /// @param threadN the maximum number of threads to use, including the calling thread
+        ///
+        void reserve(u64 capacity, u64 threadN);
+
         ///
-        /// Equivalent to `reserve(slotN / 2)`
+        /// Ensures the number of slots is equal to the smallest power of two greater than or equal to `slotN` and
+        /// sufficient to hold the current size without exceeding the max load factor, down to a minimum sufficient to
+        /// hold `config::minMapCapacity`
         ///
         /// Invalidates iterators if there is a rehash
         ///
@@ -657,6 +1146,32 @@ namespace qc::hash
         ///
         void rehash(u64 slotN);
 
+        ///
+        /// Same as `rehash`, but a growing rehash is split across up to `threadN` threads, including the calling thread
+        ///
+        /// The old slots are split into segments that each begin at a vacant slot, so no probe sequence spans two
+        /// segments. Each thread moves the elements of its segment into the new slots that map back onto it. An element
+        /// whose probe sequence would run past those slots is left for the calling thread to place afterward
+        ///
+        /// Rehashes serially when shrinking, with Robin Hood probing, or if moving an element may throw. The hasher must
+        /// not throw, and the allocator must tolerate concurrent `construct` and `destroy` calls
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// @param slotN the minimum slot count
+        /// @param threadN the maximum number of threads to use. Zero defers to `P::parallelRehashSlotN`
+        ///
+        void rehash(u64 slotN, u64 threadN);
+
+        ///
+        /// Removes all graves without changing the slot count, rehashing the elements in place
+        ///
+        /// Does not allocate memory. Happens automatically upon insertion once `P::gravePurgeThreshold` is reached
+        ///
+        /// Invalidates iterators
+        ///
+        void purge_graves();
+
         ///
         /// Swaps the contents of this map/set with the other's
         ///
@@ -679,35 +1194,62 @@ namespace qc::hash
         [[nodiscard]] bool empty() const;
 
         ///
-        /// @returns how many elements the map/set can hold before needing to rehash; equivalent to `slot_n() / 2`
+        /// @returns the number of graves, the slots left behind by erased elements
+        ///
+        [[nodiscard]] u64 grave_n() const;
+
+        ///
+        /// Gathers probe and occupancy statistics by scanning every slot and rehashing every element, see `RawStats`
+        ///
+        /// Meant for diagnosing poor hashing, not for hot paths. Its own hasher calls are not counted
+        ///
+        /// @returns the statistics
+        ///
+        [[nodiscard]] RawStats stats() const;
+
+        ///
+        /// @returns how many elements the map/set can hold before needing to rehash; equivalent to
+        ///   `slot_n() * max_load_factor()` rounded down, but always less than `slot_n()`
         ///
         [[nodiscard]] u64 capacity() const;
 
         ///
-        /// @returns the number of slots in the map/set; equivalent to `capacity() * 2`
+        /// @returns the number of slots in the map/set
         ///
         [[nodiscard]] u64 slot_n() const;
 
         ///
-        /// @returns the maximum possible element count; equivalent to `max_slot_n() * 2`
+        /// @returns the maximum possible element count; the capacity of `max_slot_n()` slots plus the two special
+        ///   elements
         ///
         [[nodiscard]] u64 max_size() const;
 
         ///
-        /// @returns the maximum possible slot count; equivalent to `max_size() / 2`
+        /// @returns the maximum possible slot count
         ///
         [[nodiscard]] u64 max_slot_n() const;
 
         ///
-        /// @returns the ratio of elements to slots, maximum being 0.5
+        /// @returns the ratio of elements to slots
         ///
         [[nodiscard]] f32 load_factor() const;
 
         ///
-        /// @returns 0.5, the maximum possible load factor
+        /// @returns the ratio of elements to slots above which the map/set grows
         ///
         [[nodiscard]] f32 max_load_factor() const;
 
+        ///
+        /// Sets the ratio of elements to slots above which the map/set grows. Initially `P::maxLoadFactor`
+        ///
+        /// Undefined behavior if not within (0, 1]
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// @param maxLoadFactor the new max load factor
+        ///
+        void max_load_factor(f32 maxLoadFactor);
+
         ///
         /// @returns the hasher
         ///
@@ -718,39 +1260,149 @@ namespace qc::hash
         ///
         [[nodiscard]] const A & get_allocator() const;
 
-      private:
+        ///
+        /// Writes a snapshot of the map/set to the file, from which `load` and `view` restore it without reinserting.
+        /// Only for trivially copyable keys and values
+        ///
+        /// The slot array is written as is, after a header recording the format version, the key, value, and element
+        /// sizes, whether Robin Hood probing laid it out, which special elements are present, and a fingerprint of the
+        /// hasher's output
+        ///
+        /// @param path the file to write
+        /// @returns whether the whole snapshot was written
+        ///
+        bool save(const char * path) const requires (_private::Snapshottable<K, V>);
 
-        using _RawKey = RawType<K>;
+        ///
+        /// Reads a snapshot written by `save`, copying the slot array straight into a new map/set
+        ///
+        /// @param path the file to read
+        /// @param hash the hasher, which must hash as the one the snapshot was saved with
+        /// @param alloc the allocator
+        /// @returns the map/set, or nothing if the file could not be read, or is of another format version, element
+        ///   type, probing policy, or hasher
+        ///
+        [[nodiscard]] static std::optional<RawMap> load(const char * path, const H & hash = {}, const A & alloc = {}) requires (_private::Snapshottable<K, V>);
 
-        inline static constexpr _RawKey _vacantKey{_RawKey(~_RawKey{})};
-        inline static constexpr _RawKey _graveKey{_RawKey(~_RawKey{1u})};
-        inline static constexpr _RawKey _specialKeys[2]{_graveKey, _vacantKey};
-        inline static constexpr _RawKey _vacantGraveKey{_vacantKey};
-        inline static constexpr _RawKey _vacantVacantKey{_graveKey};
-        inline static constexpr _RawKey _vacantSpecialKeys[2]{_vacantGraveKey, _vacantVacantKey};
-        inline static constexpr _RawKey _terminalKey{0u};
+        #ifdef QC_HASH_MMAP_ENABLED
+            ///
+            /// Maps a snapshot written by `save` read-only, and serves lookups and iteration straight from the mapping.
+            /// Nothing is read until it is probed
+            ///
+            /// @param path the file to map
+            /// @param hash the hasher, which must hash as the one the snapshot was saved with
+            /// @returns the view, or nothing if the file could not be mapped, or is of another format version, element
+            ///   type, probing policy, or hasher
+            ///
+            [[nodiscard]] static std::optional<RawMapView<K, V, H, A, P>> view(const char * path, const H & hash = {}) requires (_private::Snapshottable<K, V>);
+        #endif
 
-        static K & _key(E & element);
-        static const K & _key(const E & element);
+        ///
+        /// Copies the elements into an immutable table laid out for lookup, see `FrozenRawMap`
+        /// @returns the frozen map/set
+        ///
+        [[nodiscard]] FrozenRawMap<K, V, H, A> freeze() const &;
+
+        ///
+        /// Moves the elements into an immutable table laid out for lookup, see `FrozenRawMap`. This map/set is left empty
+        /// @returns the frozen map/set
+        ///
+        [[nodiscard]] FrozenRawMap<K, V, H, A> freeze() &&;
+
+      private:
+
+        using _RawKey = RawType<K>;
+
+        inline static constexpr _RawKey _vacantKey{_RawKey(~_RawKey{})};
+        inline static constexpr _RawKey _graveKey{_RawKey(~_RawKey{1u})};
+        inline static constexpr _RawKey _specialKeys[2]{_graveKey, _vacantKey};
+        inline static constexpr _RawKey _vacantGraveKey{_vacantKey};
+        inline static constexpr _RawKey _vacantVacantKey{_graveKey};
+        inline static constexpr _RawKey _vacantSpecialKeys[2]{_vacantGraveKey, _vacantVacantKey};
+        inline static constexpr _RawKey _terminalKey{0u};
+
+        static K & _key(_Slot & element);
+        static const K & _key(const _Slot & element);
+
+        // Returns the byte offset of the values from the start of the slot allocation. Split storage only
+        static u64 _valuesOffset(u64 slotN);
+
+        // Returns the values parallel to the given slots. Split storage only
+        static V * _values(const _Slot * elements, u64 slotN);
+
+        // Returns the number of allocator elements needed for `slotN` slots, including special and terminal slots, plus
+        // the parallel values for split storage
+        static u64 _allocationN(u64 slotN);
 
         static bool _isPresent(const _RawKey & key);
 
         static bool _isSpecial(const _RawKey & key);
 
+        // Returns how many elements `slotN` slots can hold without exceeding the max load factor
+        static u64 _capacityFor(u64 slotN, f32 maxLoadFactor);
+
+        // Returns the smallest valid slot count that can hold `capacity` elements without exceeding the max load factor
+        static u64 _slotNFor(u64 capacity, f32 maxLoadFactor);
+
         u64 _size;
+        u64 _graveN;
         u64 _slotN; // Does not include special elements
-        E * _elements;
+        _Slot * _elements;
         bool _haveSpecial[2];
         H _hash;
         A _alloc;
+        f32 _maxLoadFactor; // Follows the small members to fit into their padding
+        [[no_unique_address]] mutable std::conditional_t<P::countOperations, _private::RawCounts, _private::NoRawCounts> _counts{};
 
         template <typename KTuple, typename VTuple, u64... kIndices, u64... vIndices> std::pair<iterator, bool> _emplace(KTuple && kTuple, VTuple && vTuple, std::index_sequence<kIndices...>, std::index_sequence<vIndices...>);
 
+        // Same as `try_emplace`, but with the key's hash already known
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> _tryEmplace(u64 hash, K_ && key, VArgs &&... valueArgs);
+
         template <bool preserveInvariants> void _clear();
 
+        // Fills the hole at `holeI` by shifting back the elements after it, leaving the last hole vacant
+        void _shiftBack(u64 holeI);
+
+        // Shifts the elements from `slotI` up to the next vacant slot forward one slot, leaving `slotI` destructed
+        void _shiftForward(u64 slotI);
+
+        // The number of elements plus graves at which to purge graves
+        u64 _graveLimit() const;
+
+        void _purgeGraves();
+
         template <Compatible<K> K_> u64 _slot(const K_ & key) const;
 
-        void _rehash(u64 slotN);
+        // Calls the hasher, counting the call if `P::countOperations` is set
+        template <Compatible<K> K_> u64 _hashOf(const K_ & key) const;
+
+        // Hashes each key into `hashes`, all at once if the hasher can, see `FastHash::hash_n`
+        void _hashEach(std::span<const K> keys, u64 * hashes) const;
+
+        // Mixes the hasher's output for a few fixed keys, to tell snapshots saved with another hasher apart
+        static u64 _hashFingerprint(const H & hash);
+
+        // The most slots a snapshot may claim, well under `max_slot_n()`, so the byte count of its slot array can't overflow
+        inline static constexpr u64 _maxSnapshotSlotN{std::bit_floor(std::numeric_limits<u64>::max() / 2u / sizeof(E))};
+
+        // Checks that a snapshot's header matches this type and hasher, and returns the byte count of its slot array
+        static std::optional<u64> _checkSnapshot(const _private::SnapshotHeader & header, const H & hash);
+
+        // Checks that a snapshot's special and terminal slots hold the keys the header and iteration expect
+        static bool _checkSnapshotSentinels(const _Slot * elements, const _private::SnapshotHeader & header);
+
+        // Takes on the size, slot count, and so on from a snapshot's header
+        void _restoreSnapshot(const _private::SnapshotHeader & header);
+
+        // Whether moving elements is safe to split across threads
+        inline static constexpr bool _isParallelRehashable{!P::robinHood && std::is_nothrow_move_constructible_v<_Slot> && (!_isSplit || std::is_nothrow_move_constructible_v<V>)};
+
+        // A thread count of zero defers to `P::parallelRehashSlotN`
+        void _rehash(u64 slotN, u64 threadN = 0u);
+
+        // Growing only
+        void _rehashParallel(u64 slotN, u64 threadN);
 
         template <bool zeroControls> void _allocate();
 
@@ -760,33 +1412,84 @@ namespace qc::hash
 
         template <bool move> void _forwardData(std::conditional_t<move, RawMap, const RawMap> & other);
 
+        // Returns the value of the element in the slot. Maps only
+        std::add_lvalue_reference_t<V> _value(const _Slot & element) const;
+
+        // Destructs the element in slot `slotI` of `elements`
+        void _destroy(_Slot * elements, u64 slotN, u64 slotI);
+
+        // Destructs the element in the slot
+        void _destroy(_Slot * element);
+
+        // Constructs the element in slot `slotI` from the element in slot `srcSlotI` of `srcElements`
+        template <bool move> void _forwardElement(u64 slotI, std::conditional_t<move, _Slot, const _Slot> * srcElements, u64 srcSlotN, u64 srcSlotI);
+
+        iterator _iterator(_Slot * element) const;
+
+        static iterator _mutableIterator(const const_iterator & it);
 
-        struct _FindKeyResult1 { E * element; bool isPresent; };
-        struct _FindKeyResult2 { E * element; bool isPresent; bool isSpecial; unsigned char specialI; };
+        template <bool constant, typename Fn> void _forEach(Fn && fn) const;
+
+        struct _FindKeyResult1 { _Slot * element; bool isPresent; };
+        struct _FindKeyResult2 { _Slot * element; bool isPresent; bool isSpecial; unsigned char specialI; };
         template <bool insertionForm> using _FindKeyResult = std::conditional_t<insertionForm, _FindKeyResult2, _FindKeyResult1>;
 
         // If the key is not present, returns the slot after the the key's bucket
         template <bool insertionForm, Compatible<K> K_> _FindKeyResult<insertionForm> _findKey(const K_ & key) const;
+
+        // Same as above, but with the key's slot already known
+        template <bool insertionForm, Compatible<K> K_> _FindKeyResult<insertionForm> _findKey(const K_ & key, u64 slotI) const;
+
+        // Same as `_findKey` for a normal key, by whichever probing the policy and key type call for
+        template <bool insertionForm> _FindKeyResult<insertionForm> _findNormalKey(_RawKey rawKey, u64 slotI) const;
+
+        // The number of keys whose slots are prefetched ahead of probing in batch operations
+        inline static constexpr u64 _batchWindow{16u};
+
+        // Finds the keys a window at a time, prefetching each window's slots first. Calls `fn(i, findResult)` per key
+        template <typename Fn> void _findKeys(std::span<const K> keys, Fn && fn) const;
+
+        // Same as `_findKey` for a normal key, but stops at the first element closer to its ideal slot than the key would be
+        template <bool insertionForm> _FindKeyResult<insertionForm> _findKeyRobinHood(_RawKey rawKey, u64 slotI) const;
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            // Whether keys are contiguous native integers and enough fit in a block to be worth probing a block at a time
+            inline static constexpr bool _isSimdProbable{std::is_same_v<_Slot, K> && UnsignedInteger<_RawKey> && _private::simd::blockSize / sizeof(_RawKey) >= 4u && (minMapCapacity << 1) >= _private::simd::blockSize / sizeof(_RawKey)};
+
+            // Same as `_findKey` for a normal key, but compares a block of slots at a time
+            template <bool insertionForm> _FindKeyResult<insertionForm> _findKeySimd(_RawKey rawKey, u64 slotI) const;
+        #endif
     };
 
-    template <Rawable K, typename V, typename H, typename A> bool operator==(const RawMap<K, V, H, A> & m1, const RawMap<K, V, H, A> & m2);
+    template <Rawable K, typename V, typename H, typename A, typename P> bool operator==(const RawMap<K, V, H, A, P> & m1, const RawMap<K, V, H, A, P> & m2);
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename H, typename A, typename P>
     template <bool constant>
-    class RawMap<K, V, H, A>::_Iterator
+    class RawMap<K, V, H, A, P>::_Iterator : _private::IteratorValue<std::conditional_t<_isSplit, std::conditional_t<constant, const V, V>, void>>
     {
-        friend ::qc::hash::RawMap<K, V, H, A>;
+        friend ::qc::hash::RawMap<K, V, H, A, P>;
         friend ::qc::hash::RawFriend;
+        friend ::qc::hash::IncrementalRawMap<K, V, H, A, P>;
 
         using E = std::conditional_t<constant, const RawMap::E, RawMap::E>;
+        using _Slot = std::conditional_t<constant, const RawMap::_Slot, RawMap::_Slot>;
+        using _Value = std::conditional_t<constant, const V, V>;
+
+        // Allows `operator->` to work with split storage's proxy references
+        template <typename Reference> struct _Arrow
+        {
+            Reference reference;
+
+            const Reference * operator->() const { return &reference; }
+        };
 
       public:
 
         using iterator_category = std::forward_iterator_tag;
         using value_type = E;
         using difference_type = ptrdiff_t;
-        using pointer = E *;
-        using reference = E &;
+        using reference = std::conditional_t<_isSplit, std::pair<const K &, std::add_lvalue_reference_t<_Value>>, E &>;
+        using pointer = std::conditional_t<_isSplit, _Arrow<reference>, E *>;
 
         ///
         /// Default constructor - equivalent to the end iterator
@@ -810,12 +1513,12 @@ namespace qc::hash
         ///
         /// @returns the element pointed to by the iterator; undefined for invalid iterators
         ///
-        [[nodiscard]] E & operator*() const;
+        [[nodiscard]] reference operator*() const;
 
         ///
         /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
         ///
-        [[nodiscard]] E * operator->() const;
+        [[nodiscard]] pointer operator->() const;
 
         ///
         /// Increments the iterator to point to the next element in the map/set, or the end iterator if there are no more
@@ -845,1235 +1548,9817 @@ namespace qc::hash
 
       private:
 
-        E * _element;
+        _Slot * _element;
 
-        constexpr _Iterator(E * element);
-    };
-}
-
-namespace std
-{
-    ///
-    /// Swaps the two maps/sets. No memory is copied or allocated
-    ///
-    /// @param a the map/set to swap with `b`
-    /// @param b the map/set to swap with `a`
-    ///
-    template <typename K, typename V, typename H, typename A> void swap(qc::hash::RawMap<K, V, H, A> & a, qc::hash::RawMap<K, V, H, A> & b);
-}
+        constexpr _Iterator(_Slot * element);
+        constexpr _Iterator(_Slot * element, _Value * value) requires (_isSplit);
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-namespace qc::hash
-{
-    namespace _private
-    {
-        inline constexpr u64 minMapSlotN{minMapCapacity * 2u};
+        void _advance();
+    };
 
-        // Returns the lowest 64 bits from the given object
-        template <UnsignedInteger U, typename T>
-        inline constexpr U getLowBytes(const T & v)
+    #ifdef QC_HASH_MMAP_ENABLED
+        ///
+        /// A read-only map/set served straight from a snapshot file mapped into memory. Made by `RawMap::view`
+        ///
+        /// The mapping is private and read-only, so pages are only read in as they are probed, and are shared with the
+        /// page cache and any other process viewing the same file
+        ///
+        /// @tparam K the key type
+        /// @tparam V the mapped value type
+        /// @tparam H the functor type for hashing keys
+        /// @tparam A the allocator type of the map/set type viewed, which is never used
+        /// @tparam P the compile-time policy, see `RawPolicy`
+        ///
+        template <Rawable K, typename V, typename H, typename A, typename P> class RawMapView
         {
-            // Key is aligned as `U` and can be simply reinterpreted as such
-            if constexpr (alignof(T) >= sizeof(U))
-            {
-                return reinterpret_cast<const U &>(v);
-            }
-                // Key's alignment matches its size and can be simply reinterpreted as an unsigned integer
-            else if constexpr (alignof(T) == sizeof(T))
-            {
-                return reinterpret_cast<const Unsigned<sizeof(T)> &>(v);
-            }
-                // Key is not nicely aligned, manually copy up to a `U`'s worth of memory
-                // Could use memcpy, but this gives better debug performance, and both compile to the same in release
-            else
-            {
-                U result{0u};
-                using Block = Unsigned<alignof(T) < sizeof(U) ? alignof(T) : sizeof(U)>;
-                constexpr u64 n{(sizeof(T) < sizeof(U) ? sizeof(T) : sizeof(U)) / sizeof(Block)};
-                const Block * src{reinterpret_cast<const Block *>(&v)};
-                Block * dst{reinterpret_cast<Block *>(&result)};
+            friend ::qc::hash::RawMap<K, V, H, A, P>;
 
-                // We want the lower-order bytes, so need to adjust on big endian systems
-                if constexpr (std::endian::native == std::endian::big)
-                {
-                    constexpr u64 srcBlocks{sizeof(T) / sizeof(Block)};
-                    constexpr u64 dstBlocks{sizeof(U) / sizeof(Block)};
-                    if constexpr (srcBlocks > n)
-                    {
-                        src += srcBlocks - n;
-                    }
-                    if constexpr (dstBlocks > n)
-                    {
-                        dst += dstBlocks - n;
-                    }
-                }
+          public:
 
-                // Copy blocks
-                if constexpr (n >= 1u) dst[0] = src[0];
-                if constexpr (n >= 2u) dst[1] = src[1];
-                if constexpr (n >= 3u) dst[2] = src[2];
-                if constexpr (n >= 4u) dst[3] = src[3];
-                if constexpr (n >= 5u) dst[4] = src[4];
-                if constexpr (n >= 6u) dst[5] = src[5];
-                if constexpr (n >= 7u) dst[6] = src[6];
-                if constexpr (n >= 8u) dst[7] = src[7];
+            using map_type = RawMap<K, V, H, A, P>;
+            using key_type = K;
+            using mapped_type = V;
+            using value_type = typename map_type::value_type;
+            using hasher = H;
+            using size_type = u64;
+            using const_iterator = typename map_type::const_iterator;
 
-                return result;
-            }
-        }
-    }
+            RawMapView(const RawMapView &) = delete;
 
-    template <u64 elementSize, u64 elementN>
-    inline constexpr auto UnsignedMulti<elementSize, elementN>::operator~() const -> UnsignedMulti
-    {
-        UnsignedMulti res;
-        for (u64 i{0u}; i < elementN; ++i)
-        {
-            res.elements[i] = Element(~elements[i]);
-        }
-        return res;
-    }
+            ///
+            /// Takes over the other's mapping, leaving it empty
+            /// @param other the view to move
+            ///
+            RawMapView(RawMapView && other);
 
-    template <Rawable T>
-    struct IdentityHash
-    {
-        [[nodiscard]] constexpr u64 operator()(const T & v) const
-        {
-            return _private::getLowBytes<u64>(v);
-        }
-    };
+            RawMapView & operator=(const RawMapView &) = delete;
 
-    template <typename T>
-    struct IdentityHash<T *>
-    {
-        [[nodiscard]] constexpr u64 operator()(const T * const v) const
-        {
-            // Bit shift away the low zero bits to maximize low-order entropy
-            constexpr s32 shift{s32(std::bit_width(alignof(T)) - 1u)};
-            return std::bit_cast<u64>(v) >> shift;
-        }
-    };
+            ///
+            /// Unmaps this view's file and takes over the other's mapping, leaving it empty
+            /// @param other the view to move
+            /// @returns this
+            ///
+            RawMapView & operator=(RawMapView && other);
 
-    template <typename T>
-    struct IdentityHash<std::unique_ptr<T>> : IdentityHash<T *>
-    {
-        // Allows heterogeneity with raw pointers
-        using IdentityHash<T *>::operator();
+            ///
+            /// Unmaps the file
+            ///
+            ~RawMapView();
 
-        [[nodiscard]] constexpr u64 operator()(const std::unique_ptr<T> & v) const
-        {
-            return (*this)(v.get());
-        }
-    };
+            ///
+            /// Any const operation of the map/set may be used, and reads straight from the mapping
+            ///
+            /// @returns the map/set
+            ///
+            [[nodiscard]] const map_type & map() const;
 
-    template <typename T>
-    struct IdentityHash<std::shared_ptr<T>> : IdentityHash<T *>
-    {
-        // Allows heterogeneity with raw pointers
-        using IdentityHash<T *>::operator();
+            ///
+            /// @param key the key to find
+            /// @returns whether the key is present
+            ///
+            template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
 
-        [[nodiscard]] constexpr u64 operator()(const std::shared_ptr<T> & v) const
-        {
-            return (*this)(v.get());
-        }
-    };
+            ///
+            /// @param key the key to find
+            /// @returns an iterator to the element with the key, or the end iterator if not present
+            ///
+            template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
 
-    template <typename T>
-    struct FastHash
-    {
-        [[nodiscard]] constexpr u64 operator()(const T & v) const
-        {
-            return fastHash::hash<u64>(v);
-        }
-    };
+            ///
+            /// @returns an iterator to the first element, or the end iterator if empty
+            ///
+            [[nodiscard]] const_iterator begin() const;
 
-    template <typename T>
-    struct FastHash<T *>
-    {
-        [[nodiscard]] constexpr u64 operator()(const T * const v) const
-        {
-            return fastHash::hash<u64>(v);
-        }
-    };
+            ///
+            /// @returns the end iterator
+            ///
+            [[nodiscard]] const_iterator end() const;
 
-    template <typename T>
-    struct FastHash<std::unique_ptr<T>> : FastHash<T *>
-    {
-        // Allows heterogeneity with raw pointers
-        using FastHash<T *>::operator();
+            ///
+            /// @returns the number of elements
+            ///
+            [[nodiscard]] u64 size() const;
 
-        [[nodiscard]] constexpr u64 operator()(const std::unique_ptr<T> & v) const
-        {
-            return (*this)(v.get());
-        }
-    };
+            ///
+            /// @returns whether there are no elements
+            ///
+            [[nodiscard]] bool empty() const;
 
-    template <typename T>
-    struct FastHash<std::shared_ptr<T>> : FastHash<T *>
-    {
-        // Allows heterogeneity with raw pointers
-        using FastHash<T *>::operator();
+          private:
 
-        [[nodiscard]] constexpr u64 operator()(const std::shared_ptr<T> & v) const
-        {
-            return (*this)(v.get());
-        }
-    };
+            map_type _map;
+            void * _mapping;
+            u64 _mappingSize;
 
-    template <>
-    struct FastHash<std::string>
-    {
-        [[nodiscard]] u64 operator()(const std::string & v) const
-        {
-            return fastHash::hash<u64>(v.c_str(), v.length());
-        }
+            RawMapView(const H & hash);
 
-        [[nodiscard]] u64 operator()(const std::string_view & v) const
-        {
-            return fastHash::hash<u64>(v.data(), v.length());
-        }
+            void _unmap();
+        };
+    #endif
 
-        [[nodiscard]] u64 operator()(const char * v) const
-        {
+    ///
+    /// A map that any number of threads may insert into, look up, and erase from at once. Restricted to keys whose raw
+    /// type is a native unsigned integer and to trivially copyable values with lock-free atomics
+    ///
+    /// Built on the same vacant and grave keys as `RawMap`. A slot is claimed with a single compare-and-swap from the
+    /// vacant key, and an element is erased with a compare-and-swap to the grave key. Graves are not reused until the
+    /// next rehash. A map claims the slot first and then publishes the value, and the element is absent to lookups and
+    /// erasures until it is published
+    ///
+    /// Lookups never block. Insertions and erasures are lock-free until the table runs out of capacity, at which point
+    /// every thread that runs into the full table helps migrate the elements to a new table a chunk at a time. The table
+    /// doubles if at least half its capacity is live and is otherwise rehashed at the same size to clear out the graves
+    ///
+    /// Threads register with the table on a per-thread stripe of counters so that a rehash can wait out in-flight
+    /// insertions and erasures, and so that a replaced table is only freed once no lookup can still be reading it
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>> class ConcurrentRawMap;
+
+    ///
+    /// The set form of `ConcurrentRawMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>> using ConcurrentRawSet = ConcurrentRawMap<K, void, H, A>;
+
+    template <Rawable K, typename V, typename H, typename A> class ConcurrentRawMap
+    {
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        using _RawKey = RawType<K>;
+
+        // Stands in for the value type in the signatures of map-only methods, as sets have none
+        using _Value = std::conditional_t<_isSet, std::nullptr_t, V>;
+
+      public:
+
+        static_assert(UnsignedInteger<_RawKey> && std::atomic<_RawKey>::is_always_lock_free);
+        static_assert(std::is_trivially_copyable_v<K>);
+        static_assert(_isSet || std::is_trivially_copyable_v<V>);
+
+        static_assert(requires(const H h, const K k) { u64{h(k)}; });
+
+        using key_type = K;
+        using mapped_type = V;
+        using hasher = H;
+        using allocator_type = A;
+        using size_type = u64;
+
+        ///
+        /// Constructs a new map/set and allocates its table
+        ///
+        /// @param capacity the minimum capacity
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit ConcurrentRawMap(u64 capacity = minMapCapacity, const H & hash = {}, const A & alloc = {});
+
+        ConcurrentRawMap(const ConcurrentRawMap &) = delete;
+
+        ConcurrentRawMap & operator=(const ConcurrentRawMap &) = delete;
+
+        ///
+        /// Must not be called concurrently with any other method
+        ///
+        ~ConcurrentRawMap();
+
+        ///
+        /// Inserts the key if not already present. Sets only
+        ///
+        /// @param key the key to insert
+        /// @returns whether the key was inserted
+        ///
+        bool insert(const K & key) requires (_isSet);
+
+        ///
+        /// Inserts the element if the key is not already present. Maps only
+        ///
+        /// A racing insertion of the same key that has claimed its slot but not yet published its value counts as present
+        ///
+        /// @param key the key to insert
+        /// @param value the value to publish with the key
+        /// @returns whether the element was inserted
+        ///
+        bool insert(const K & key, const _Value & value) requires (_isMap);
+
+        ///
+        /// Inserts the element, or atomically replaces the value if the key is already present. Maps only
+        ///
+        /// Waits for a racing insertion of the same key to publish its value before replacing it
+        ///
+        /// @param key the key to insert or assign
+        /// @param value the value to publish
+        /// @returns whether the element was inserted
+        ///
+        bool insert_or_assign(const K & key, const _Value & value) requires (_isMap);
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        [[nodiscard]] bool contains(const K & key) const;
+
+        ///
+        /// Maps only
+        ///
+        /// @param key the key to find
+        /// @returns a copy of the key's value, or nothing if the key is not present
+        ///
+        [[nodiscard]] std::optional<V> find(const K & key) const requires (_isMap);
+
+        ///
+        /// Replaces the key with a grave, which is cleared out on the next rehash
+        ///
+        /// @param key the key to erase
+        /// @returns whether the key was erased
+        ///
+        bool erase(const K & key);
+
+        ///
+        /// Exact only if there are no concurrent insertions or erasures
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements, with the same caveat as `size`
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the number of elements that can be held before the next rehash, including graves
+        ///
+        [[nodiscard]] u64 capacity() const;
+
+        ///
+        /// @returns the number of regular slots in the current table
+        ///
+        [[nodiscard]] u64 slot_n() const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        using _Slot = std::conditional_t<_isSet, std::atomic<_RawKey>, _private::ConcurrentSlot<_RawKey, V>>;
+
+        inline static constexpr _RawKey _vacantKey{_RawKey(~_RawKey{})};
+        inline static constexpr _RawKey _graveKey{_RawKey(~_RawKey{1u})};
+
+        // States of a map slot. A regular slot is absent until its claimed key's value is published, and stays published
+        // even once erased. A special slot is claimed by moving to inserting, may be erased back to absent, and is locked
+        // in assigning while its value is replaced
+        inline static constexpr u8 _absentState{0u};
+        inline static constexpr u8 _insertingState{1u};
+        inline static constexpr u8 _publishedState{2u};
+        inline static constexpr u8 _assigningState{3u};
+
+        // The number of per-thread counter stripes. Must be a power of two
+        inline static constexpr u64 _stripeN{64u};
+
+        // The number of slots migrated at a time during a rehash
+        inline static constexpr u64 _chunkSize{1024u};
+
+        struct _Table
+        {
+            u64 slotN; // Does not include special slots
+            _Slot * slots;
+            alignas(64) std::atomic<u64> claimedN; // Regular slots holding an element or grave, or reserved to
+            std::atomic<u64> graveN;
+            alignas(64) std::atomic<_Table *> next;
+            std::atomic<_Table *> prev; // Set until the replaced table has been freed
+            std::atomic<u64> chunkI;
+            std::atomic<u64> migratedChunkN;
+        };
+
+        // Registration counts of the threads sharing the stripe, by table parity
+        struct alignas(64) _Stripe
+        {
+            std::atomic<u64> readerN[2];
+            std::atomic<u64> writerN[2];
+        };
+
+        // A table a thread is registered with and the counter to release once done with it
+        struct _Registration
+        {
+            _Table * table;
+            std::atomic<u64> * counter;
+            u64 parity;
+        };
+
+        using _TableAllocator = typename std::allocator_traits<A>::template rebind_alloc<_Table>;
+        using _SlotAllocator = typename std::allocator_traits<A>::template rebind_alloc<_Slot>;
+
+        enum class _ClaimResult { inserted, present, full };
+
+        static std::atomic<_RawKey> & _key(_Slot & slot);
+
+        static bool _isSpecial(_RawKey key);
+
+        static u64 _capacityFor(u64 slotN);
+
+        static u64 _slotNFor(u64 capacity);
+
+        // The current table's address, tagged in its lowest bit with the parity of its generation
+        std::atomic<u64> _table;
+        mutable _Stripe _stripes[_stripeN];
+        H _hash;
+        A _alloc;
+
+        u64 _hashOf(_RawKey rawKey) const;
+
+        _Table * _allocate(u64 slotN);
+
+        void _deallocate(_Table * table);
+
+        _Stripe & _stripe() const;
+
+        // Registers the calling thread with the current table. Readers may only look, writers may modify
+        template <bool write> _Registration _register() const;
+
+        // Registers a writer with a table that is not being rehashed, helping any rehash that is
+        _Registration _registerWriter();
+
+        static void _unregister(const _Registration & registration);
+
+        u64 _countRegistered(u64 parity, bool includeReaders) const;
+
+        // Helps rehash the table, which the calling thread must be registered with. Releases the registration
+        void _rehash(const _Registration & registration);
+
+        // Copies the elements in the chunk into the next table. Returns the number of regular elements copied
+        u64 _migrateChunk(const _Table & table, _Table & next, u64 chunkI) const;
+
+        // Claims a vacant slot for the key, unless it is already present or the table is full
+        _ClaimResult _claim(_Table & table, _RawKey rawKey, u64 & slotI) const;
+
+        // Returns the slot of the key if present, otherwise null. A map element is only present once published
+        _Slot * _find(const _Table & table, _RawKey rawKey) const;
+
+        // Shared implementation of `insert` and `insert_or_assign`
+        template <bool assign> bool _insert(const K & key, const _Value * value);
+
+        // Shared implementation of `insert` and `insert_or_assign` for the special keys
+        template <bool assign> bool _insertSpecial(_Slot & slot, _RawKey rawKey, const _Value * value);
+    };
+
+    ///
+    /// A map that any number of threads may use at once, for any key and value types `RawMap` supports. Splits the
+    /// elements between a number of shards, each a `RawMap` guarded by its own reader/writer lock and padded to its own
+    /// cache line, so threads touching different shards never contend
+    ///
+    /// Keys are routed by the high bits of their mixed hash, leaving the low bits to pick the slot within the shard.
+    /// Lookups take a shard's lock shared, and modifications take it exclusively
+    ///
+    /// Values are only ever accessed under the lock, so lookups return copies, and `visit` runs a function on the
+    /// element in place
+    ///
+    /// The batch methods group the keys by shard so that each shard's lock is taken only once
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    /// @tparam P the compile-time policy of each shard, see `RawPolicy`
+    ///
+    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>, typename P = RawPolicy> class ShardedRawMap;
+
+    ///
+    /// The set form of `ShardedRawMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    /// @tparam P the compile-time policy of each shard, see `RawPolicy`
+    ///
+    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>, typename P = RawPolicy> using ShardedRawSet = ShardedRawMap<K, void, H, A, P>;
+
+    template <Rawable K, typename V, typename H, typename A, typename P> class ShardedRawMap
+    {
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        // Stands in for the value type in the signatures of map-only methods, as sets have none
+        using _Value = std::conditional_t<_isSet, std::nullptr_t, V>;
+
+      public:
+
+        using shard_type = RawMap<K, V, H, A, P>;
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = typename shard_type::value_type;
+        using hasher = H;
+        using allocator_type = A;
+        using size_type = u64;
+
+        ///
+        /// Constructs a new map/set. No memory is allocated for the elements until they are inserted
+        ///
+        /// @param capacity the minimum capacity, split evenly between the shards
+        /// @param shardN the number of shards, rounded up to a power of two
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit ShardedRawMap(u64 capacity = minMapCapacity, u64 shardN = defaultShardN, const H & hash = {}, const A & alloc = {});
+
+        ShardedRawMap(const ShardedRawMap &) = delete;
+
+        ShardedRawMap & operator=(const ShardedRawMap &) = delete;
+
+        ///
+        /// Copies the element in if its key is not already present
+        ///
+        /// @param element the element to insert
+        /// @returns whether the element was inserted
+        ///
+        bool insert(const value_type & element);
+
+        ///
+        /// If the key is not already present, a new element is constructed in-place from the forwarded arguments
+        ///
+        /// `valueArgs` must be present for maps and absent for sets
+        ///
+        /// @param key the key to forward
+        /// @param valueArgs the arguments to forward to the value's constructor
+        /// @returns whether the element was inserted
+        ///
+        template <typename K_, typename... VArgs> bool try_emplace(K_ && key, VArgs &&... valueArgs);
+
+        ///
+        /// Inserts the element, or assigns the value if the key is already present. Maps only
+        ///
+        /// @param key the key to insert or assign
+        /// @param value the value to forward
+        /// @returns whether the element was inserted
+        ///
+        template <typename K_, typename V_> bool insert_or_assign(K_ && key, V_ && value) requires (_isMap);
+
+        ///
+        /// @param key the key of the element to erase
+        /// @returns whether the element was erased
+        ///
+        template <Compatible<K> K_> bool erase(const K_ & key);
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
+
+        ///
+        /// Maps only
+        ///
+        /// @param key the key to find
+        /// @returns a copy of the key's value, or nothing if the key is not present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] std::optional<_Value> find(const K_ & key) const requires (_isMap);
+
+        ///
+        /// Calls `fn(element)` on the key's element, if present, while holding its shard's lock. The lock is held shared
+        /// from the const overload and exclusively otherwise
+        ///
+        /// `fn` must not access this map/set
+        ///
+        /// @param key the key to find
+        /// @param fn the function to call on the element
+        /// @returns whether the key was present
+        ///
+        template <Compatible<K> K_, typename Fn> bool visit(const K_ & key, Fn && fn) const;
+        template <Compatible<K> K_, typename Fn> bool visit(const K_ & key, Fn && fn);
+
+        ///
+        /// Checks many keys for presence at once, taking each shard's lock once
+        ///
+        /// Undefined behavior if `results` is smaller than `keys`
+        ///
+        /// @param keys the keys to find
+        /// @param results set to whether the key at the same index is present
+        /// @returns the number of keys present
+        ///
+        u64 contains_batch(std::span<const K> keys, std::span<bool> results) const;
+
+        ///
+        /// Finds many keys at once, taking each shard's lock once. Maps only
+        ///
+        /// Undefined behavior if `values` is smaller than `keys`
+        ///
+        /// @param keys the keys to find
+        /// @param values set to a copy of the value of the key at the same index, or nothing if absent
+        /// @returns the number of keys present
+        ///
+        u64 find_batch(std::span<const K> keys, std::span<std::optional<_Value>> values) const requires (_isMap);
+
+        ///
+        /// Inserts copies of many elements at once, taking each shard's lock once
+        ///
+        /// @param elements the elements to insert
+        /// @returns the number of elements inserted
+        ///
+        u64 insert_batch(std::span<const value_type> elements);
+
+        ///
+        /// Erases many keys at once, taking each shard's lock once
+        ///
+        /// @param keys the keys to erase
+        /// @returns the number of elements erased
+        ///
+        u64 erase_batch(std::span<const K> keys);
+
+        ///
+        /// Calls `fn(element)` on every element a shard at a time, holding each shard's lock as it goes. The lock is
+        /// held shared from the const overload and exclusively otherwise
+        ///
+        /// Not a snapshot, as shards not yet reached may still change. `fn` must not access this map/set
+        ///
+        /// @param fn the function to call on each element
+        ///
+        template <typename Fn> void for_each(Fn && fn) const;
+        template <typename Fn> void for_each(Fn && fn);
+
+        ///
+        /// Clears each shard in turn
+        ///
+        void clear();
+
+        ///
+        /// Sums the shard sizes, locking each in turn, so is only exact when there are no concurrent modifications
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements, with the same caveat as `size`
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the number of shards
+        ///
+        [[nodiscard]] u64 shard_n() const;
+
+        ///
+        /// @param key the key to route
+        /// @returns the index of the shard the key belongs to
+        ///
+        template <Compatible<K> K_> [[nodiscard]] u64 shard(const K_ & key) const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+      private:
+
+        struct alignas(64) _Shard
+        {
+            mutable std::shared_mutex mutex;
+            shard_type map;
+        };
+
+        u64 _shardN;
+        int _shardBits;
+        std::unique_ptr<_Shard[]> _shards;
+        H _hash;
+
+        static const K & _key(const value_type & element);
+
+        // Groups the items by shard and calls `fn(shardMap, itemI)` for each while holding the shard's lock exclusively
+        template <typename T, typename Fn> void _batch(std::span<const T> items, Fn && fn);
+
+        // Groups the items by shard and calls `fn(shardMap, itemI)` for each while holding the shard's lock shared
+        template <typename T, typename Fn> void _batch(std::span<const T> items, Fn && fn) const;
+
+        // Counting sorts the item indices by shard and calls `fn(shardI, itemIs)` for each shard with any items
+        template <typename T, typename Fn> void _groupByShard(std::span<const T> items, Fn && fn) const;
+    };
+    ///
+    /// A single-threaded map that grows without stalling an insertion for a full rehash. Once the table runs out of
+    /// capacity, it is set aside and a table of twice the slots takes over. The old table lives alongside the new until
+    /// each subsequent insertion has moved a few of its slots over. Lookups and erasures consult both tables meanwhile
+    ///
+    /// The number of slots moved per insertion is chosen to empty the old table well before the new one fills, so both
+    /// tables are held at once only for a while after each growth. The table after that is allocated once the current
+    /// one is nearly full, and its slots are cleared a few per insertion so that it is ready when needed
+    ///
+    /// Moved elements leave graves in the old table, so Robin Hood probing is not supported. Any insertion may
+    /// invalidate iterators
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    /// @tparam P the compile-time policy of each table, see `RawPolicy`
+    ///
+    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>, typename P = RawPolicy> class IncrementalRawMap;
+
+    ///
+    /// The set form of `IncrementalRawMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    /// @tparam P the compile-time policy of each table, see `RawPolicy`
+    ///
+    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>, typename P = RawPolicy> using IncrementalRawSet = IncrementalRawMap<K, void, H, A, P>;
+
+    template <Rawable K, typename V, typename H, typename A, typename P> class IncrementalRawMap
+    {
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        // Internal iterator class forward declaration. Prefer `iterator` and `const_iterator`
+        template <bool constant> class _Iterator;
+
+      public:
+
+        static_assert(!P::robinHood, "Incremental growth leaves graves, which Robin Hood probing does not support");
+
+        using map_type = RawMap<K, V, H, A, P>;
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = typename map_type::value_type;
+        using hasher = H;
+        using allocator_type = A;
+        using size_type = u64;
+        using iterator = _Iterator<false>;
+        using const_iterator = _Iterator<true>;
+
+        ///
+        /// Constructs a new map/set. No memory is allocated until the first insertion
+        ///
+        /// @param capacity the minimum capacity
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit IncrementalRawMap(u64 capacity = minMapCapacity, const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Copies both tables as they are, mid-migration or not. The next table is not copied
+        /// @param other the map/set to copy
+        ///
+        IncrementalRawMap(const IncrementalRawMap & other);
+
+        ///
+        /// Moves both tables and the next table. `other` is left empty
+        /// @param other the map/set to move
+        ///
+        IncrementalRawMap(IncrementalRawMap && other);
+
+        ///
+        /// Same as the copy constructor
+        /// @param other the map/set to copy
+        /// @returns this
+        ///
+        IncrementalRawMap & operator=(const IncrementalRawMap & other);
+
+        ///
+        /// Same as the move constructor
+        /// @param other the map/set to move
+        /// @returns this
+        ///
+        IncrementalRawMap & operator=(IncrementalRawMap && other);
+
+        ///
+        /// Destructor
+        ///
+        ~IncrementalRawMap();
+
+        ///
+        /// Copies the element in if its key is not already present
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        std::pair<iterator, bool> insert(const value_type & element);
+
+        ///
+        /// Moves the element in if its key is not already present
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        std::pair<iterator, bool> insert(value_type && element);
+
+        ///
+        /// If the key is not already present, a new element is constructed in-place from the forwarded arguments
+        ///
+        /// `valueArgs` must be present for maps and absent for sets
+        ///
+        /// @param key the key to forward
+        /// @param valueArgs the arguments to forward to the value's constructor
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> try_emplace(K_ && key, VArgs &&... valueArgs);
+
+        ///
+        /// @param key the key of the element to erase
+        /// @returns whether the element was erased
+        ///
+        template <Compatible<K> K_> bool erase(const K_ & key);
+
+        ///
+        /// Erases the element at the iterator, which must be valid
+        ///
+        /// @param position the iterator to the element to erase
+        ///
+        void erase(iterator position);
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns an iterator to the element with the key, or the end iterator if not present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] iterator find(const K_ & key);
+        template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
+
+        ///
+        /// Iterates the new table, then whatever is left of the old
+        ///
+        /// @returns an iterator to the first element, or the end iterator if empty
+        ///
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator cbegin() const;
+
+        ///
+        /// @returns the end iterator
+        ///
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        ///
+        /// Moves what is left of the old table, if anything, then ensures the capacity. May rehash all at once
+        ///
+        /// @param capacity the minimum capacity
+        ///
+        void reserve(u64 capacity);
+
+        ///
+        /// Moves whatever is left of the old table over now
+        ///
+        void finish_migration();
+
+        ///
+        /// @returns whether an old table is still being moved over
+        ///
+        [[nodiscard]] bool migrating() const;
+
+        ///
+        /// Erases all elements and releases the old and next tables, if any
+        ///
+        void clear();
+
+        ///
+        /// @returns the number of elements across both tables
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the capacity of the new table
+        ///
+        [[nodiscard]] u64 capacity() const;
+
+        ///
+        /// @returns the slot count of the new table
+        ///
+        [[nodiscard]] u64 slot_n() const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        using _Slot = typename map_type::_Slot;
+
+        // Takes all insertions
+        map_type _map;
+        // Only allocated while its elements are being moved over
+        map_type _old;
+        u64 _migrateSlotI;
+        u64 _migrateStepN;
+        // The slots of the table `_map` will grow into, the first `_nextClearedN` of which are vacant
+        _Slot * _next;
+        u64 _nextSlotN;
+        u64 _nextClearedN;
+
+        static const K & _key(const value_type & element);
+
+        // Whether inserting a new element into `_map` would make it rehash
+        bool _wouldGrow() const;
+
+        // Moves more of the old table if migrating, or else readies more of the next table. Sets aside the new table if it
+        // would grow and the key is absent, and returns the element with the key if it is in the old table, or, should the
+        // new table be full, in either
+        template <typename K_> iterator _prepareInsert(const K_ & key);
+
+        // Allocates the next table once there are few enough insertions left before growth, and clears enough of its
+        // slots that it will be fully cleared in time
+        void _prepareNext();
+
+        void _releaseNext();
+
+        void _startMigration();
+
+        // Moves up to `slotN` more slots of the old table, releasing it once there are no elements left
+        void _migrate(u64 slotN);
+
+        // Destroys the regular element in the old table and leaves a grave
+        void _retire(u64 slotI);
+
+        iterator _iterator(typename map_type::iterator it);
+        std::pair<iterator, bool> _iterator(std::pair<typename map_type::iterator, bool> result);
+    };
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    class IncrementalRawMap<K, V, H, A, P>::_Iterator
+    {
+        friend ::qc::hash::IncrementalRawMap<K, V, H, A, P>;
+
+        using _MapIterator = std::conditional_t<constant, typename map_type::const_iterator, typename map_type::iterator>;
+        using _Map = std::conditional_t<constant, const map_type, map_type>;
+
+      public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename _MapIterator::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = typename _MapIterator::reference;
+        using pointer = typename _MapIterator::pointer;
+
+        ///
+        /// Default constructor - equivalent to the end iterator
+        ///
+        constexpr _Iterator() = default;
+
+        ///
+        /// Copy constructor - a mutable iterator may be implicitly converted to a const iterator
+        /// @param other the iterator to copy
+        ///
+        constexpr _Iterator(const _Iterator & other) = default;
+        template <bool constant_> requires (constant && !constant_) constexpr _Iterator(const _Iterator<constant_> & other);
+
+        ///
+        /// Copy assignment
+        /// @param other the iterator to copy
+        ///
+        _Iterator & operator=(const _Iterator & other) = default;
+
+        ///
+        /// @returns the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] reference operator*() const;
+
+        ///
+        /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] pointer operator->() const;
+
+        ///
+        /// Increments the iterator to point to the next element, moving on from the new table to the old, or the end
+        /// iterator if there are no more elements
+        ///
+        /// @returns this
+        ///
+        _Iterator & operator++();
+
+        ///
+        /// Same as the prefix increment
+        ///
+        /// @returns a copy of the iterator before it was incremented
+        ///
+        _Iterator operator++(int);
+
+        ///
+        /// @param other the other iterator to compare with
+        /// @returns whether this iterator is equivalent to the other iterator
+        ///
+        template <bool constant_> [[nodiscard]] bool operator==(const _Iterator<constant_> & other) const;
+
+      private:
+
+        _MapIterator _it{};
+        // The old table, if the iterator is in the new table and there is one
+        _Map * _next{};
+
+        constexpr _Iterator(_MapIterator it, _Map * next);
+    };
+
+    ///
+    /// An immutable map/set laid out for lookup alone. Made by `RawMap::freeze`, or constructed from a `RawMap`
+    ///
+    /// The keys are stored apart from the values, in buckets one cache line wide. Each key has two candidate buckets, and
+    /// the table is built by cuckoo insertion, so every present key is in one of its two buckets. A lookup therefore
+    /// probes at most two buckets, each compared all at once with SIMD where available, and the table is filled to
+    /// `frozenLoadFactor`. The rare key that cannot be placed goes in a small stash checked after both buckets. A key is
+    /// only placed elsewhere once its first bucket is full, so a lookup stops at a first bucket with room
+    ///
+    /// Lookups support the same heterogeneous keys as `RawMap`. The hasher need not be good; its output is mixed before
+    /// the buckets are chosen, unless it is a `FastHash`, whose output already is
+    ///
+    /// Present keys are found more slowly than in a `RawMap`, as a quarter of them are in their second bucket. What is
+    /// gained is memory, and faster lookups of absent keys in large tables
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename V, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>> class FrozenRawMap;
+
+    ///
+    /// The set form of `FrozenRawMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam H the functor type for hashing keys
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename H = IdentityHash<K>, typename A = std::allocator<K>> using FrozenRawSet = FrozenRawMap<K, void, H, A>;
+
+    template <Rawable K, typename V, typename H, typename A> class FrozenRawMap
+    {
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        // Internal iterator class forward declaration. Prefer `const_iterator`
+        class _Iterator;
+
+      public:
+
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::conditional_t<_isSet, K, std::pair<K, V>>;
+        using hasher = H;
+        using allocator_type = A;
+        using size_type = u64;
+        using iterator = _Iterator;
+        using const_iterator = _Iterator;
+
+        ///
+        /// Constructs an empty map/set
+        ///
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit FrozenRawMap(const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Copies the elements of the map/set into a new frozen table
+        /// @param map the map/set to freeze
+        ///
+        template <typename P> explicit FrozenRawMap(const RawMap<K, V, H, A, P> & map);
+
+        ///
+        /// Moves the elements of the map/set into a new frozen table. `map` is left empty
+        /// @param map the map/set to freeze
+        ///
+        template <typename P> explicit FrozenRawMap(RawMap<K, V, H, A, P> && map);
+
+        ///
+        /// Copies the table as it is laid out
+        /// @param other the map/set to copy
+        ///
+        FrozenRawMap(const FrozenRawMap & other);
+
+        ///
+        /// Takes over the other's table. `other` is left empty
+        /// @param other the map/set to move
+        ///
+        FrozenRawMap(FrozenRawMap && other);
+
+        ///
+        /// Same as the copy constructor
+        /// @param other the map/set to copy
+        /// @returns this
+        ///
+        FrozenRawMap & operator=(const FrozenRawMap & other);
+
+        ///
+        /// Same as the move constructor
+        /// @param other the map/set to move
+        /// @returns this
+        ///
+        FrozenRawMap & operator=(FrozenRawMap && other);
+
+        ///
+        /// Destructor
+        ///
+        ~FrozenRawMap();
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns `1` if the key is present or `0` if it is absent
+        ///
+        template <Compatible<K> K_> [[nodiscard]] u64 count(const K_ & key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns an iterator to the element with the key, or the end iterator if not present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
+
+        #ifdef QC_HASH_EXCEPTIONS_ENABLED
+            ///
+            /// Gets the value for the heterogeneous key
+            ///
+            /// Defined only for maps, not for sets
+            ///
+            /// @param key the key to retrieve
+            /// @returns the value for the key
+            /// @throws `std::out_of_range` if the key is absent
+            ///
+            template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<const V> at(const K_ & key) const requires (_isMap);
+        #endif
+
+        ///
+        /// @returns an iterator to the first element, or the end iterator if empty
+        ///
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator cbegin() const;
+
+        ///
+        /// @returns the end iterator
+        ///
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the number of bucket slots, not counting the stash
+        ///
+        [[nodiscard]] u64 slot_n() const;
+
+        ///
+        /// @returns the number of elements that could not be placed in either bucket, each of which is checked by every
+        ///   lookup that misses both buckets. Almost always zero
+        ///
+        [[nodiscard]] u64 stash_n() const;
+
+        ///
+        /// @returns the ratio of elements to bucket slots
+        ///
+        [[nodiscard]] f32 load_factor() const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        using _RawKey = RawType<K>;
+        using _Value = std::conditional_t<_isSet, std::byte, V>;
+
+        inline static constexpr _RawKey _vacantKey{_RawKey(~_RawKey{})};
+
+        // A bucket spans a cache line, but never holds fewer than eight keys
+        inline static constexpr u64 _bucketWidth{64u / sizeof(_RawKey) > 8u ? 64u / sizeof(_RawKey) : 8u};
+
+        // Evictions after which an element is given up on and stashed
+        inline static constexpr u64 _maxKickN{512u};
+
+        // Rebuilds with more buckets while more than this many elements are stashed
+        inline static constexpr u64 _maxStashN{8u};
+        inline static constexpr u64 _maxRebuildN{8u};
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            inline static constexpr bool _isSimdProbable{UnsignedInteger<_RawKey> && (_bucketWidth * sizeof(_RawKey)) % _private::simd::blockSize == 0u};
+            inline static constexpr u64 _maskStride{_isSimdProbable ? sizeof(_RawKey) : 1u};
+        #else
+            inline static constexpr u64 _maskStride{1u};
+        #endif
+
+        struct alignas(64) _Line { std::byte bytes[64]; };
+
+        using _LineAllocator = typename std::allocator_traits<A>::template rebind_alloc<_Line>;
+
+        u64 _size;
+        u64 _bucketN;
+        u64 _stashN;
+        bool _haveSpecial;
+        // The bucket slots, then the slot for the vacant key, then the stash
+        K * _keys;
+        // Parallel to the keys. Null for sets
+        _Value * _values;
+        H _hash;
+        A _alloc;
+
+        static const K & _key(const auto & element);
+
+        // Returns the key's hash mixed well enough to split into the two bucket indices. Already so for mixing hashers
+        template <typename K_> u64 _mixedHash(const K_ & key) const;
+
+        // The candidate buckets of a mixed hash, each picked by scaling one half of it
+        u64 _bucket1(u64 mixedHash) const;
+        u64 _bucket2(u64 mixedHash) const;
+
+        u64 _slotN() const;
+
+        u64 _totalSlotN() const;
+
+        u64 _lineN() const;
+
+        bool _isPresent(u64 slotI) const;
+
+        // Places the elements of the map, forwarding each with `forward(element, key, value)`
+        template <typename Map, typename Forward> void _build(Map & map, Forward forward);
+
+        // Cuckoo inserts the hashed elements with the current bucket count. Returns the index plus one of the element in
+        // each bucket slot, or zero if vacant, and stashes those that could not be placed
+        bool _place(const std::vector<u64> & mixedHashes, std::vector<u64> & slots, std::vector<u64> & stash) const;
+
+        void _allocate();
+
+        void _deallocate();
+
+        void _destroy();
+
+        void _copy(const FrozenRawMap & other);
+
+        void _move(FrozenRawMap & other);
+
+        // Returns the slot of the key, or the total slot count if absent
+        template <Compatible<K> K_> u64 _findSlot(const K_ & key) const;
+
+        // Returns a mask of the slots in the bucket that hold the key, with `_maskStride` bits per slot
+        u64 _matchMask(const _RawKey & rawKey, u64 bucketI) const;
+    };
+
+    template <Rawable K, typename V, typename H, typename A>
+    class FrozenRawMap<K, V, H, A>::_Iterator
+    {
+        friend ::qc::hash::FrozenRawMap<K, V, H, A>;
+
+        // Allows `operator->` to work with the proxy references of maps
+        template <typename Reference> struct _Arrow
+        {
+            Reference reference;
+
+            const Reference * operator->() const { return &reference; }
+        };
+
+      public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FrozenRawMap::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<_isSet, const K &, std::pair<const K &, std::add_lvalue_reference_t<const V>>>;
+        using pointer = std::conditional_t<_isSet, const K *, _Arrow<reference>>;
+
+        ///
+        /// Default constructor - equivalent to the end iterator
+        ///
+        constexpr _Iterator() = default;
+
+        ///
+        /// Copy constructor
+        /// @param other the iterator to copy
+        ///
+        constexpr _Iterator(const _Iterator & other) = default;
+
+        ///
+        /// Copy assignment
+        /// @param other the iterator to copy
+        ///
+        _Iterator & operator=(const _Iterator & other) = default;
+
+        ///
+        /// @returns the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] reference operator*() const;
+
+        ///
+        /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] pointer operator->() const;
+
+        ///
+        /// Increments the iterator to point to the next element, or the end iterator if there are no more elements
+        ///
+        /// @returns this
+        ///
+        _Iterator & operator++();
+
+        ///
+        /// Same as the prefix increment
+        ///
+        /// @returns a copy of the iterator before it was incremented
+        ///
+        _Iterator operator++(int);
+
+        ///
+        /// @param other the other iterator to compare with
+        /// @returns whether this iterator is equivalent to the other iterator
+        ///
+        [[nodiscard]] bool operator==(const _Iterator & other) const;
+
+      private:
+
+        const FrozenRawMap * _map{};
+        u64 _slotI{};
+
+        constexpr _Iterator(const FrozenRawMap * map, u64 slotI);
+    };
+
+    ///
+    /// A map/set that holds up to `N` elements inside the object itself, and moves them all into a `RawMap` once it
+    /// outgrows that. Until then, no memory is allocated, nothing is hashed, and lookups are a linear scan of the keys,
+    /// compared all at once with SIMD where available
+    ///
+    /// Inline keys and values are stored apart, so iterators dereference to a `std::pair<const K &, V &>` proxy for maps.
+    /// Erasing an inline element moves the last inline element into its place. Spilling to the `RawMap` invalidates
+    /// iterators, and the elements stay there even if later erasures would fit them inline again
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam N the most elements held inline
+    /// @tparam H the functor type for hashing keys once spilled
+    /// @tparam A the allocator type of the spilled table
+    /// @tparam P the compile-time policy of the spilled table, see `RawPolicy`
+    ///
+    template <Rawable K, typename V, u64 N = 8u, typename H = IdentityHash<K>, typename A = std::allocator<std::pair<K, V>>, typename P = RawPolicy> class InlineRawMap;
+
+    ///
+    /// The set form of `InlineRawMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam N the most elements held inline
+    /// @tparam H the functor type for hashing keys once spilled
+    /// @tparam A the allocator type of the spilled table
+    /// @tparam P the compile-time policy of the spilled table, see `RawPolicy`
+    ///
+    template <Rawable K, u64 N = 8u, typename H = IdentityHash<K>, typename A = std::allocator<K>, typename P = RawPolicy> using InlineRawSet = InlineRawMap<K, void, N, H, A, P>;
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P> class InlineRawMap
+    {
+        static_assert(N > 0u);
+
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        // Internal iterator class forward declaration. Prefer `iterator` and `const_iterator`
+        template <bool constant> class _Iterator;
+
+      public:
+
+        using map_type = RawMap<K, V, H, A, P>;
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = typename map_type::value_type;
+        using hasher = H;
+        using allocator_type = A;
+        using reference = std::conditional_t<_isSet, const K &, std::pair<const K &, std::add_lvalue_reference_t<V>>>;
+        using const_reference = std::conditional_t<_isSet, const K &, std::pair<const K &, std::add_lvalue_reference_t<const V>>>;
+        using size_type = u64;
+        using iterator = _Iterator<false>;
+        using const_iterator = _Iterator<true>;
+
+        ///
+        /// Constructs a new map/set. No memory is allocated until it outgrows the inline storage
+        ///
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit InlineRawMap(const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Constructs a new map/set from copies of the elements in the initializer list
+        ///
+        /// @param elements the elements to copy
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        InlineRawMap(std::initializer_list<value_type> elements, const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Copies the inline elements or the spilled table, whichever is in use
+        /// @param other the map/set to copy
+        ///
+        InlineRawMap(const InlineRawMap & other);
+
+        ///
+        /// Moves the inline elements one by one, or the spilled table as a whole. `other` is left empty
+        /// @param other the map/set to move
+        ///
+        InlineRawMap(InlineRawMap && other);
+
+        ///
+        /// Existing elements are destructed and each element of `other` is copied
+        /// @param other the map/set to copy
+        /// @returns this
+        ///
+        InlineRawMap & operator=(const InlineRawMap & other);
+
+        ///
+        /// Existing elements are destructed and the elements of `other` are moved. `other` is left empty
+        /// @param other the map/set to move
+        /// @returns this
+        ///
+        InlineRawMap & operator=(InlineRawMap && other);
+
+        ///
+        /// Destructor
+        ///
+        ~InlineRawMap();
+
+        ///
+        /// Copies the element in if its key is not already present
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        std::pair<iterator, bool> insert(const value_type & element);
+
+        ///
+        /// Moves the element in if its key is not already present
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        std::pair<iterator, bool> insert(value_type && element);
+
+        ///
+        /// Forwards the key and value in if the key is not already present
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key to forward
+        /// @param value the value to forward
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        template <typename K_, typename V_> std::pair<iterator, bool> emplace(K_ && key, V_ && value) requires (_isMap);
+
+        ///
+        /// If the key is not already present, a new element is constructed in-place from the forwarded arguments
+        ///
+        /// `valueArgs` must be present for maps and absent for sets
+        ///
+        /// @param key the key to forward
+        /// @param valueArgs the arguments to forward to the value's constructor
+        /// @returns an iterator to the element with the key, and whether the element was inserted
+        ///
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> try_emplace(K_ && key, VArgs &&... valueArgs);
+
+        ///
+        /// @param key the key of the element to erase
+        /// @returns whether the element was erased
+        ///
+        template <Compatible<K> K_> bool erase(const K_ & key);
+
+        ///
+        /// Erases the element at the iterator, which must be valid
+        ///
+        /// @param position the iterator to the element to erase
+        ///
+        void erase(iterator position);
+
+        ///
+        /// Destructs all elements. Does not free the spilled table's memory, and does not move back inline
+        ///
+        void clear();
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns `1` if the key is present or `0` if it is absent
+        ///
+        template <Compatible<K> K_> [[nodiscard]] u64 count(const K_ & key) const;
+
+        #ifdef QC_HASH_EXCEPTIONS_ENABLED
+            ///
+            /// Defined only for maps, not for sets
+            ///
+            /// @param key the key to retrieve
+            /// @returns the value for the key
+            /// @throws `std::out_of_range` if the key is absent
+            ///
+            template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<V> at(const K_ & key) requires (_isMap);
+            template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<const V> at(const K_ & key) const requires (_isMap);
+        #endif
+
+        ///
+        /// Gets the value for the key, inserting a default constructed value first if the key is absent
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key to retrieve
+        /// @returns the value for the key
+        ///
+        template <typename K_> [[nodiscard]] std::add_lvalue_reference_t<V> operator[](K_ && key) requires (_isMap);
+
+        ///
+        /// @param key the key to find
+        /// @returns an iterator to the element with the key, or the end iterator if not present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] iterator find(const K_ & key);
+        template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
+
+        ///
+        /// @returns an iterator to the first element, or the end iterator if empty
+        ///
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator cbegin() const;
+
+        ///
+        /// @returns the end iterator
+        ///
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        ///
+        /// Swaps the contents of this map/set and the other's
+        /// @param other the map/set to swap with
+        ///
+        void swap(InlineRawMap & other);
+
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns whether the elements have outgrown the inline storage and moved to the `RawMap`
+        ///
+        [[nodiscard]] bool spilled() const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        using _RawKey = RawType<K>;
+        using _Value = std::conditional_t<_isSet, u8, V>;
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            // Enough key lanes to fill whole blocks, so the scan never reads past the keys
+            inline static constexpr u64 _laneN{((N * sizeof(_RawKey) + _private::simd::blockSize - 1u) / _private::simd::blockSize) * _private::simd::blockSize / sizeof(_RawKey)};
+            inline static constexpr bool _isSimdScannable{UnsignedInteger<_RawKey> && _laneN * sizeof(_RawKey) <= 64u};
+        #else
+            inline static constexpr u64 _laneN{N};
+        #endif
+
+        u64 _inlineN;
+        bool _spilled;
+        // Lanes past the inline count repeat the first key, so need not be masked off when scanned
+        _RawKey _keys[_laneN];
+        alignas(_Value) std::byte _values[_isSet ? 1u : N * sizeof(_Value)];
+        map_type _map;
+
+        K & _key(u64 i);
+        const K & _key(u64 i) const;
+
+        _Value & _value(u64 i);
+        const _Value & _value(u64 i) const;
+
+        // Returns the index of the inline key, or at least the inline count if absent
+        template <typename K_> u64 _findInline(const K_ & key) const;
+
+        template <typename K_> bool _containsInline(const K_ & key) const;
+
+        // Copies the first key into each lane past the inline count, so that a match in any lane means the key is present
+        void _fillUnusedLanes();
+
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> _tryEmplace(K_ && key, VArgs &&... valueArgs);
+
+        // Moves every inline element to the table
+        void _spill();
+
+        void _eraseInline(u64 i);
+
+        void _destroyInline();
+
+        // Copies or moves the inline elements of `other`, which must have none of its own
+        template <typename Other> void _takeInline(Other && other);
+    };
+
+    ///
+    /// @returns whether the two maps/sets have the same elements
+    ///
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P> bool operator==(const InlineRawMap<K, V, N, H, A, P> & m1, const InlineRawMap<K, V, N, H, A, P> & m2);
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    class InlineRawMap<K, V, N, H, A, P>::_Iterator
+    {
+        friend ::qc::hash::InlineRawMap<K, V, N, H, A, P>;
+
+        using _MapIterator = std::conditional_t<constant, typename map_type::const_iterator, typename map_type::iterator>;
+        using _Owner = std::conditional_t<constant, const InlineRawMap, InlineRawMap>;
+
+        // Allows `operator->` to work with the proxy references
+        template <typename Reference> struct _Arrow
+        {
+            Reference reference;
+
+            const Reference * operator->() const { return &reference; }
+        };
+
+      public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = InlineRawMap::value_type;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<constant, InlineRawMap::const_reference, InlineRawMap::reference>;
+        using pointer = std::conditional_t<_isSet, const K *, _Arrow<reference>>;
+
+        ///
+        /// Default constructor - equivalent to the end iterator
+        ///
+        constexpr _Iterator() = default;
+
+        ///
+        /// Copy constructor - a mutable iterator may be implicitly converted to a const iterator
+        /// @param other the iterator to copy
+        ///
+        constexpr _Iterator(const _Iterator & other) = default;
+        template <bool constant_> requires (constant && !constant_) constexpr _Iterator(const _Iterator<constant_> & other);
+
+        ///
+        /// Copy assignment
+        /// @param other the iterator to copy
+        ///
+        _Iterator & operator=(const _Iterator & other) = default;
+
+        ///
+        /// @returns the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] reference operator*() const;
+
+        ///
+        /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] pointer operator->() const;
+
+        ///
+        /// Increments the iterator to point to the next element, or the end iterator if there are no more elements
+        ///
+        /// @returns this
+        ///
+        _Iterator & operator++();
+
+        ///
+        /// Same as the prefix increment
+        ///
+        /// @returns a copy of the iterator before it was incremented
+        ///
+        _Iterator operator++(int);
+
+        ///
+        /// @param other the other iterator to compare with
+        /// @returns whether this iterator is equivalent to the other iterator
+        ///
+        template <bool constant_> [[nodiscard]] bool operator==(const _Iterator<constant_> & other) const;
+
+      private:
+
+        // Set only while at an inline element
+        _Owner * _owner{};
+        u64 _i{};
+        // Used once spilled
+        _MapIterator _it{};
+
+        constexpr _Iterator(_Owner * owner, u64 i);
+        constexpr _Iterator(_MapIterator it);
+    };
+
+    ///
+    /// An associative container for keys that are not uniquely representable, such as strings, and so cannot go in a
+    /// `RawMap`
+    ///
+    /// Each slot holds the element and the full hash of its key, and has a matching control byte in a separate array. A
+    /// control byte is either empty, a grave, or a seven bit tag taken from the key's hash. Slots are probed a group of
+    /// control bytes at a time, matched against the tag all at once with SIMD where available, so only slots whose tag
+    /// and full hash both match ever have their keys compared. Groups are probed quadratically
+    ///
+    /// The cached hashes mean that a rehash never reads a key
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys, which must hash `lookup_type`
+    /// @tparam A the allocator type
+    ///
+    template <typename K, typename V, typename H = std::hash<K>, typename A = std::allocator<std::pair<K, V>>> class MetaMap;
+
+    ///
+    /// The set form of `MetaMap`
+    ///
+    /// @tparam K the key type
+    /// @tparam H the functor type for hashing keys, which must hash `lookup_type`
+    /// @tparam A the allocator type
+    ///
+    template <typename K, typename H = std::hash<K>, typename A = std::allocator<K>> using MetaSet = MetaMap<K, void, H, A>;
+
+    ///
+    /// `MetaMap` keyed by `std::string`
+    ///
+    /// Short keys are stored inline in the slot by the small string optimization. Lookups and erasures take
+    /// `std::string_view`, so `std::string`, `std::string_view`, `const char *`, and string literals may all be used
+    /// without a temporary string being made. Insertions construct the key string only if the key is not already present
+    ///
+    /// @tparam V the mapped value type
+    /// @tparam H the functor type for hashing keys, which must hash `std::string_view`
+    /// @tparam A the allocator type
+    ///
+    template <typename V, typename H = FastHash<std::string>, typename A = std::allocator<std::pair<std::string, V>>> using StringMap = MetaMap<std::string, V, H, A>;
+
+    ///
+    /// The set form of `StringMap`
+    ///
+    /// @tparam H the functor type for hashing keys, which must hash `std::string_view`
+    /// @tparam A the allocator type
+    ///
+    template <typename H = FastHash<std::string>, typename A = std::allocator<std::string>> using StringSet = MetaMap<std::string, void, H, A>;
+
+    template <typename K, typename V, typename H, typename A> class MetaMap
+    {
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        ///
+        /// Element type
+        ///
+        using E = std::conditional_t<_isSet, K, std::pair<K, V>>;
+
+        // Internal iterator class forward declaration. Prefer `iterator` and `const_iterator`
+        template <bool constant> class _Iterator;
+
+      public:
+
+        ///
+        /// The type lookups and erasures take. A `std::string_view` for string keys, so that no temporary string is
+        /// needed, or else a reference to the key type
+        ///
+        using lookup_type = std::conditional_t<std::is_same_v<K, std::string>, std::string_view, const K &>;
+
+        static_assert(requires(const H h, const lookup_type k) { u64{h(k)}; });
+
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = E;
+        using hasher = H;
+        using allocator_type = A;
+        using reference = E &;
+        using const_reference = const E &;
+        using pointer = E *;
+        using const_pointer = const E *;
+        using size_type = u64;
+        using difference_type = s64;
+        using iterator = _Iterator<false>;
+        using const_iterator = _Iterator<true>;
+
+        ///
+        /// Constructs a new map/set. Memory is not allocated until the first element is inserted
+        ///
+        /// @param capacity the minimum capacity
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        explicit MetaMap(u64 capacity = minMapCapacity, const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Constructs a new map/set from copies of the elements in the initializer list
+        ///
+        /// @param elements the elements to copy
+        /// @param capacity the minimum capacity
+        /// @param hash the hasher
+        /// @param alloc the allocator
+        ///
+        MetaMap(std::initializer_list<E> elements, u64 capacity = {}, const H & hash = {}, const A & alloc = {});
+
+        ///
+        /// Copy constructor - new memory is allocated and each element and its hash is copied
+        /// @param other the map/set to copy
+        ///
+        MetaMap(const MetaMap & other);
+
+        ///
+        /// Move constructor - no memory is allocated and no elements are copied. `other` is left empty
+        /// @param other the map/set to move from
+        ///
+        MetaMap(MetaMap && other);
+
+        ///
+        /// Copy assignment operator - existing elements are destructed and each element of `other` is copied
+        /// @param other the map/set to copy from
+        /// @returns this
+        ///
+        MetaMap & operator=(const MetaMap & other);
+
+        ///
+        /// Move assignment operator - existing elements are destructed and memory is freed
+        /// @param other the map/set to move from
+        /// @returns this
+        ///
+        MetaMap & operator=(MetaMap && other);
+
+        ///
+        /// Destructor - all elements are destructed and all memory is freed
+        ///
+        ~MetaMap();
+
+        ///
+        /// Copies the element into the map/set if its key is not already present
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        std::pair<iterator, bool> insert(const E & element);
+
+        ///
+        /// Moves the element into the map/set if its key is not already present
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        std::pair<iterator, bool> insert(E && element);
+
+        ///
+        /// Forwards the key and value into the map if the key is not already present
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key to forward; anything the key may be constructed from and which converts to `lookup_type`
+        /// @param value the value to forward
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        template <typename K_, typename V_> std::pair<iterator, bool> emplace(K_ && key, V_ && value) requires (_isMap);
+
+        ///
+        /// If the key is not already present, the key string is constructed from it, and the value from the forwarded
+        /// arguments
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// `valueArgs` must be present for maps and absent for sets
+        ///
+        /// @param key the key to forward; anything the key may be constructed from and which converts to `lookup_type`
+        /// @param valueArgs the arguments to forward to the value's constructor
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> try_emplace(K_ && key, VArgs &&... valueArgs);
+
+        ///
+        /// Erases the element with the key if present
+        ///
+        /// Does *not* invalidate iterators
+        ///
+        /// @param key the key of the element to erase
+        /// @returns whether the element was erased
+        ///
+        bool erase(lookup_type key);
+
+        ///
+        /// Erases the element at the given position, which must be valid
+        ///
+        /// Does *not* invalidate iterators
+        ///
+        /// @param position position of the element to erase
+        ///
+        void erase(iterator position);
+
+        ///
+        /// Clears the map/set, destructing all elements. Does not free memory
+        ///
+        void clear();
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        [[nodiscard]] bool contains(lookup_type key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns `1` if the key is present or `0` if it is absent
+        ///
+        [[nodiscard]] u64 count(lookup_type key) const;
+
+        #ifdef QC_HASH_EXCEPTIONS_ENABLED
+            ///
+            /// Defined only for maps, not for sets
+            ///
+            /// @param key the key to retrieve
+            /// @returns the value for the key
+            /// @throws `std::out_of_range` if the key is absent
+            ///
+            [[nodiscard]] std::add_lvalue_reference_t<V> at(lookup_type key) requires (_isMap);
+            [[nodiscard]] std::add_lvalue_reference_t<const V> at(lookup_type key) const requires (_isMap);
+        #endif
+
+        ///
+        /// Gets the value for the key, inserting a default constructed value first if the key is absent
+        ///
+        /// Invalidates iterators if there is a rehash
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key to retrieve; anything the key may be constructed from and which converts to `lookup_type`
+        /// @returns the value for the key
+        ///
+        template <typename K_> [[nodiscard]] std::add_lvalue_reference_t<V> operator[](K_ && key) requires (_isMap);
+
+        ///
+        /// @param key the key to find
+        /// @returns an iterator to the element with the key, or the end iterator if not present
+        ///
+        [[nodiscard]] iterator find(lookup_type key);
+        [[nodiscard]] const_iterator find(lookup_type key) const;
+
+        ///
+        /// @returns an iterator to the first element, or the end iterator if empty
+        ///
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator cbegin() const;
+
+        ///
+        /// @returns the end iterator
+        ///
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        ///
+        /// Ensures the capacity, rehashing if necessary. Keys are not rehashed, as each slot caches its hash
+        ///
+        /// @param capacity the minimum capacity
+        ///
+        void reserve(u64 capacity);
+
+        ///
+        /// Rehashes into the given number of slots, rounded up to a power of two and to at least what the current
+        /// elements need. Keys are not rehashed, as each slot caches its hash
+        ///
+        /// @param slotN the minimum slot count
+        ///
+        void rehash(u64 slotN);
+
+        ///
+        /// Swaps the contents of this map/set and the other's
+        /// @param other the map/set to swap with
+        ///
+        void swap(MetaMap & other);
+
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the number of elements that can be held before a rehash, seven eighths of the slot count
+        ///
+        [[nodiscard]] u64 capacity() const;
+
+        ///
+        /// @returns the number of slots
+        ///
+        [[nodiscard]] u64 slot_n() const;
+
+        ///
+        /// @returns the number of slots left as graves by erasures and not yet reused
+        ///
+        [[nodiscard]] u64 grave_n() const;
+
+        ///
+        /// @returns the hasher
+        ///
+        [[nodiscard]] const H & hash_function() const;
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        // Slot with the element and the full hash of its key
+        struct _Slot
+        {
+            u64 hash;
+            E element;
+        };
+
+        using _SlotAllocator = typename std::allocator_traits<A>::template rebind_alloc<_Slot>;
+        using _ControlAllocator = typename std::allocator_traits<A>::template rebind_alloc<u8>;
+
+        // Control bytes other than tags all have the high bit set
+        inline static constexpr u8 _emptyControl{0x80u};
+        inline static constexpr u8 _graveControl{0xFEu};
+        inline static constexpr u8 _endControl{0xFFu};
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            inline static constexpr u64 _groupWidth{_private::simd::blockSize};
+        #else
+            inline static constexpr u64 _groupWidth{8u};
+        #endif
+
+        u64 _size;
+        u64 _slotN;
+        u64 _graveN;
+        // One more than the slot count, with an end marker at the back for iteration
+        u8 * _controls;
+        _Slot * _slots;
+        H _hash;
+        A _alloc;
+
+        static u8 _tag(u64 hash);
+
+        // Slot counts are powers of two of at least a group, and the table is filled to at most seven eighths
+        static u64 _slotNFor(u64 capacity);
+
+        static const K & _key(const E & element);
+
+        // Returns a mask with a bit set for each control byte of the group equal to `control`
+        static u32 _matchGroup(const u8 * group, u8 control);
+
+        // Returns a mask with a bit set for each empty control byte or grave of the group
+        static u32 _matchFree(const u8 * group);
+
+        // Returns the slot with the key, or the slot count if absent
+        u64 _findSlot(lookup_type key, u64 hash) const;
+
+        // Returns the first free slot in the probe sequence of the hash
+        u64 _findFreeSlot(u64 hash) const;
+
+        template <typename K_, typename... VArgs> std::pair<iterator, bool> _tryEmplace(K_ && key, VArgs &&... valueArgs);
+
+        void _eraseSlot(u64 slotI);
+
+        void _rehash(u64 slotN);
+
+        void _allocate();
+
+        void _deallocate();
+
+        void _destroyElements();
+
+        iterator _iterator(u64 slotI);
+    };
+
+    ///
+    /// @returns whether the two maps/sets have the same elements
+    ///
+    template <typename K, typename V, typename H, typename A> bool operator==(const MetaMap<K, V, H, A> & m1, const MetaMap<K, V, H, A> & m2);
+
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    class MetaMap<K, V, H, A>::_Iterator
+    {
+        friend ::qc::hash::MetaMap<K, V, H, A>;
+
+        using _Slot = std::conditional_t<constant, const MetaMap::_Slot, MetaMap::_Slot>;
+
+      public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<constant, const E &, E &>;
+        using pointer = std::conditional_t<constant, const E *, E *>;
+
+        ///
+        /// Default constructor - equivalent to the end iterator
+        ///
+        constexpr _Iterator() = default;
+
+        ///
+        /// Copy constructor - a mutable iterator may be implicitly converted to a const iterator
+        /// @param other the iterator to copy
+        ///
+        constexpr _Iterator(const _Iterator & other) = default;
+        template <bool constant_> requires (constant && !constant_) constexpr _Iterator(const _Iterator<constant_> & other);
+
+        ///
+        /// Copy assignment
+        /// @param other the iterator to copy
+        ///
+        _Iterator & operator=(const _Iterator & other) = default;
+
+        ///
+        /// @returns the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] reference operator*() const;
+
+        ///
+        /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] pointer operator->() const;
+
+        ///
+        /// Increments the iterator to point to the next element, or the end iterator if there are no more elements
+        ///
+        /// @returns this
+        ///
+        _Iterator & operator++();
+
+        ///
+        /// Same as the prefix increment
+        ///
+        /// @returns a copy of the iterator before it was incremented
+        ///
+        _Iterator operator++(int);
+
+        ///
+        /// @param other the other iterator to compare with
+        /// @returns whether this iterator is equivalent to the other iterator
+        ///
+        template <bool constant_> [[nodiscard]] bool operator==(const _Iterator<constant_> & other) const;
+
+      private:
+
+        const u8 * _control{};
+        _Slot * _slot{};
+
+        constexpr _Iterator(const u8 * control, _Slot * slot);
+    };
+
+    ///
+    /// An associative container for keys of one or two bytes, such as `u8`, `s16`, or small enums, that directly
+    /// addresses the whole key space rather than hashing
+    ///
+    /// A bitmap marks which keys are present and values live in an array indexed by key, so there is no hashing,
+    /// probing, or rehashing. A lookup is a single bit test, and iteration scans the bitmap a word at a time. Memory is one
+    /// bit per possible key, plus one value per possible key for maps, and is allocated in full on the first insertion.
+    /// Until then, lookups read a shared static empty bitmap
+    ///
+    /// Heterogeneous lookup converts the other key to `K` by value, so e.g. `DirectSet<s16>` works correctly with
+    /// negative `s8` keys
+    ///
+    /// @tparam K the key type, which must be at most two bytes
+    /// @tparam V the mapped value type
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename V, typename A = std::allocator<std::pair<K, V>>> class DirectMap;
+
+    ///
+    /// The set form of `DirectMap`
+    ///
+    /// @tparam K the key type, which must be at most two bytes
+    /// @tparam A the allocator type
+    ///
+    template <Rawable K, typename A = std::allocator<K>> using DirectSet = DirectMap<K, void, A>;
+
+    template <Rawable K, typename V, typename A> class DirectMap
+    {
+        static_assert(sizeof(K) <= 2u && std::is_trivially_copyable_v<K>);
+
+        inline static constexpr bool _isSet{std::is_same_v<V, void>};
+        inline static constexpr bool _isMap{!_isSet};
+
+        ///
+        /// Element type
+        ///
+        using E = std::conditional_t<_isSet, K, std::pair<K, V>>;
+
+        // Internal iterator class forward declaration. Prefer `iterator` and `const_iterator`
+        template <bool constant> class _Iterator;
+
+      public:
+
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = E;
+        using allocator_type = A;
+        using reference = std::conditional_t<_isSet, K, std::pair<K, std::add_lvalue_reference_t<V>>>;
+        using const_reference = std::conditional_t<_isSet, K, std::pair<K, std::add_lvalue_reference_t<const V>>>;
+        using size_type = u64;
+        using difference_type = s64;
+        using iterator = _Iterator<false>;
+        using const_iterator = _Iterator<true>;
+
+        ///
+        /// Constructs a new map/set. Memory is not allocated until the first element is inserted
+        ///
+        /// @param alloc the allocator
+        ///
+        explicit DirectMap(const A & alloc = {});
+
+        ///
+        /// Constructs a new map/set from copies of the elements in the initializer list
+        ///
+        /// @param elements the elements to copy
+        /// @param alloc the allocator
+        ///
+        DirectMap(std::initializer_list<E> elements, const A & alloc = {});
+
+        ///
+        /// Copy constructor - new memory is allocated and each element is copied
+        /// @param other the map/set to copy
+        ///
+        DirectMap(const DirectMap & other);
+
+        ///
+        /// Move constructor - no memory is allocated and no elements are copied. `other` is left empty
+        /// @param other the map/set to move from
+        ///
+        DirectMap(DirectMap && other);
+
+        ///
+        /// Copy assignment operator - existing elements are destructed and each element of `other` is copied
+        /// @param other the map/set to copy from
+        /// @returns this
+        ///
+        DirectMap & operator=(const DirectMap & other);
+
+        ///
+        /// Move assignment operator - existing elements are destructed and memory is freed
+        /// @param other the map/set to move from
+        /// @returns this
+        ///
+        DirectMap & operator=(DirectMap && other);
+
+        ///
+        /// Destructor - all elements are destructed and all memory is freed
+        ///
+        ~DirectMap();
+
+        ///
+        /// Copies the element into the map/set if its key is not already present
+        ///
+        /// Never invalidates iterators
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        std::pair<iterator, bool> insert(const E & element);
+
+        ///
+        /// Moves the element into the map/set if its key is not already present
+        ///
+        /// Never invalidates iterators
+        ///
+        /// @param element the element to insert
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        std::pair<iterator, bool> insert(E && element);
+
+        ///
+        /// Forwards the value into the map if the key is not already present
+        ///
+        /// Never invalidates iterators
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key
+        /// @param value the value to forward
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        template <typename V_> std::pair<iterator, bool> emplace(const K & key, V_ && value) requires (_isMap);
+
+        ///
+        /// If the key is not already present, the value is constructed from the forwarded arguments
+        ///
+        /// Never invalidates iterators
+        ///
+        /// `valueArgs` must be present for maps and absent for sets
+        ///
+        /// @param key the key
+        /// @param valueArgs the arguments to forward to the value's constructor
+        /// @returns an iterator to the element with the key, and whether it was inserted
+        ///
+        template <typename... VArgs> std::pair<iterator, bool> try_emplace(const K & key, VArgs &&... valueArgs);
+
+        ///
+        /// Erases the element with the key if present
+        ///
+        /// Does *not* invalidate iterators
+        ///
+        /// @param key the key of the element to erase
+        /// @returns whether the element was erased
+        ///
+        template <Compatible<K> K_> bool erase(const K_ & key);
+
+        ///
+        /// Erases the element at the given position, which must be valid
+        ///
+        /// Does *not* invalidate iterators
+        ///
+        /// @param position position of the element to erase
+        ///
+        void erase(iterator position);
+
+        ///
+        /// Clears the map/set, destructing all elements. Does not free memory
+        ///
+        void clear();
+
+        ///
+        /// @param key the key to find
+        /// @returns whether the key is present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] bool contains(const K_ & key) const;
+
+        ///
+        /// @param key the key to find
+        /// @returns `1` if the key is present or `0` if it is absent
+        ///
+        template <Compatible<K> K_> [[nodiscard]] u64 count(const K_ & key) const;
+
+        #ifdef QC_HASH_EXCEPTIONS_ENABLED
+            ///
+            /// Defined only for maps, not for sets
+            ///
+            /// @param key the key to retrieve
+            /// @returns the value for the key
+            /// @throws `std::out_of_range` if the key is absent
+            ///
+            template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<V> at(const K_ & key) requires (_isMap);
+            template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<const V> at(const K_ & key) const requires (_isMap);
+        #endif
+
+        ///
+        /// Gets the value for the key, inserting a default constructed value first if the key is absent
+        ///
+        /// Never invalidates iterators
+        ///
+        /// Defined only for maps, not for sets
+        ///
+        /// @param key the key to retrieve
+        /// @returns the value for the key
+        ///
+        template <Compatible<K> K_> [[nodiscard]] std::add_lvalue_reference_t<V> operator[](const K_ & key) requires (_isMap);
+
+        ///
+        /// @param key the key to find
+        /// @returns an iterator to the element with the key, or the end iterator if not present
+        ///
+        template <Compatible<K> K_> [[nodiscard]] iterator find(const K_ & key);
+        template <Compatible<K> K_> [[nodiscard]] const_iterator find(const K_ & key) const;
+
+        ///
+        /// @returns an iterator to the element with the least raw key, or the end iterator if empty
+        ///
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator cbegin() const;
+
+        ///
+        /// @returns the end iterator
+        ///
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        ///
+        /// Swaps the contents of this map/set and the other's
+        /// @param other the map/set to swap with
+        ///
+        void swap(DirectMap & other);
+
+        ///
+        /// @returns the number of elements
+        ///
+        [[nodiscard]] u64 size() const;
+
+        ///
+        /// @returns whether there are no elements
+        ///
+        [[nodiscard]] bool empty() const;
+
+        ///
+        /// @returns the number of possible keys, which is also the most elements there can be
+        ///
+        [[nodiscard]] static constexpr u64 capacity();
+
+        ///
+        /// @returns the allocator
+        ///
+        [[nodiscard]] const A & get_allocator() const;
+
+      private:
+
+        using _Value = std::conditional_t<_isSet, u8, V>;
+        using _WordAllocator = typename std::allocator_traits<A>::template rebind_alloc<u64>;
+        using _ValueAllocator = typename std::allocator_traits<A>::template rebind_alloc<_Value>;
+
+        inline static constexpr u64 _keyN{u64{1u} << (sizeof(K) * 8u)};
+        inline static constexpr u64 _wordN{_keyN / 64u};
+
+        // Read by lookups until memory is allocated, and never written
+        alignas(64) inline static constexpr u64 _emptyPresence[_wordN]{};
+
+        u64 _size;
+        u64 * _presence;
+        _Value * _values;
+        A _alloc;
+
+        static u64 _index(const K & key);
+
+        static K _key(u64 i);
+
+        bool _isAllocated() const;
+
+        bool _has(u64 i) const;
+
+        // Returns the first present index at or after `i`, or the key count if there is none
+        u64 _next(u64 i) const;
+
+        template <typename... VArgs> std::pair<iterator, bool> _tryEmplace(u64 i, VArgs &&... valueArgs);
+
+        void _eraseIndex(u64 i);
+
+        void _allocate();
+
+        void _deallocate();
+
+        void _destroyValues();
+    };
+
+    ///
+    /// @returns whether the two maps/sets have the same elements
+    ///
+    template <Rawable K, typename V, typename A> bool operator==(const DirectMap<K, V, A> & m1, const DirectMap<K, V, A> & m2);
+
+    template <Rawable K, typename V, typename A>
+    template <bool constant>
+    class DirectMap<K, V, A>::_Iterator
+    {
+        friend ::qc::hash::DirectMap<K, V, A>;
+
+        using _Map = std::conditional_t<constant, const DirectMap, DirectMap>;
+
+        // Allows `operator->` to work with the proxy references
+        template <typename Reference> struct _Arrow
+        {
+            Reference reference;
+
+            const Reference * operator->() const { return &reference; }
+        };
+
+      public:
+
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = E;
+        using difference_type = ptrdiff_t;
+        using reference = std::conditional_t<constant, DirectMap::const_reference, DirectMap::reference>;
+        using pointer = _Arrow<reference>;
+
+        ///
+        /// Default constructor - equivalent to the end iterator
+        ///
+        constexpr _Iterator() = default;
+
+        ///
+        /// Copy constructor - a mutable iterator may be implicitly converted to a const iterator
+        /// @param other the iterator to copy
+        ///
+        constexpr _Iterator(const _Iterator & other) = default;
+        template <bool constant_> requires (constant && !constant_) constexpr _Iterator(const _Iterator<constant_> & other);
+
+        ///
+        /// Copy assignment
+        /// @param other the iterator to copy
+        ///
+        _Iterator & operator=(const _Iterator & other) = default;
+
+        ///
+        /// @returns the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] reference operator*() const;
+
+        ///
+        /// @returns a pointer to the element pointed to by the iterator; undefined for invalid iterators
+        ///
+        [[nodiscard]] pointer operator->() const;
+
+        ///
+        /// Increments the iterator to point to the next element, or the end iterator if there are no more elements
+        ///
+        /// @returns this
+        ///
+        _Iterator & operator++();
+
+        ///
+        /// Same as the prefix increment
+        ///
+        /// @returns a copy of the iterator before it was incremented
+        ///
+        _Iterator operator++(int);
+
+        ///
+        /// @param other the other iterator to compare with
+        /// @returns whether this iterator is equivalent to the other iterator
+        ///
+        template <bool constant_> [[nodiscard]] bool operator==(const _Iterator<constant_> & other) const;
+
+      private:
+
+        _Map * _map{};
+        u64 _i{_keyN};
+
+        constexpr _Iterator(_Map * map, u64 i);
+    };
+
+    namespace _private
+    {
+        struct SplitRawPolicy : RawPolicy
+        {
+            inline static constexpr bool splitStorage{true};
+        };
+
+        // Keys that fit in a word are spread well enough by identity hashing, larger keys are not
+        template <typename K> using DefaultRawHash = std::conditional_t<sizeof(RawType<K>) <= sizeof(u64), IdentityHash<K>, FastHash<K>>;
+
+        template <typename V> inline constexpr u64 valueSize{sizeof(std::conditional_t<std::is_same_v<V, void>, u8, V>)};
+
+        template <typename V> inline constexpr bool isLargeValue{!std::is_same_v<V, void> && valueSize<V> >= splitValueSize};
+
+        template <typename K, typename V> struct MapSelector
+        {
+            using type = std::conditional_t<std::is_same_v<V, void>, MetaSet<K>, MetaMap<K, V>>;
+        };
+
+        template <typename V> struct MapSelector<std::string, V>
+        {
+            using type = std::conditional_t<std::is_same_v<V, void>, StringSet<>, StringMap<V>>;
+        };
+
+        template <typename K, typename V> requires (std::is_same_v<K, float> || std::is_same_v<K, double>) struct MapSelector<K, V>
+        {
+            using type = typename MapSelector<CanonicalFloat<K>, V>::type;
+        };
+
+        template <Rawable K, typename V> requires (sizeof(K) <= 2u && std::is_trivially_copyable_v<K> && (std::is_same_v<V, void> || (u64{1u} << (sizeof(K) * 8u)) * valueSize<V> <= directValueMemory)) struct MapSelector<K, V>
+        {
+            using type = std::conditional_t<std::is_same_v<V, void>, DirectSet<K>, DirectMap<K, V>>;
+        };
+
+        template <Rawable K, typename V> struct MapSelector<K, V>
+        {
+            using type = RawMap<K, V, DefaultRawHash<K>, std::allocator<std::conditional_t<std::is_same_v<V, void>, K, std::pair<K, V>>>, std::conditional_t<isLargeValue<V>, SplitRawPolicy, RawPolicy>>;
+        };
+    }
+
+    ///
+    /// Picks the fastest implementation for the key and value types at compile time
+    ///
+    /// - Keys of one or two bytes go to `DirectMap`, unless the value array would exceed `directValueMemory`
+    /// - Other uniquely representable keys go to `RawMap`, hashed by identity if they fit in a word and by `FastHash`
+    ///   otherwise. Values of at least `splitValueSize` bytes are stored apart from the keys
+    /// - `float` and `double` keys go to `RawMap` as `CanonicalFloat`
+    /// - `std::string` keys go to `StringMap`
+    /// - Any other keys go to `MetaMap`, hashed by `std::hash`
+    ///
+    /// @tparam K the key type
+    /// @tparam V the mapped value type
+    ///
+    template <typename K, typename V> using Map = typename _private::MapSelector<K, V>::type;
+
+    ///
+    /// The set form of `Map`
+    ///
+    /// @tparam K the key type
+    ///
+    template <typename K> using Set = Map<K, void>;
+}
+
+namespace std
+{
+    ///
+    /// Swaps the two maps/sets. No memory is copied or allocated
+    ///
+    /// @param a the map/set to swap with `b`
+    /// @param b the map/set to swap with `a`
+    ///
+    template <typename K, typename V, typename H, typename A, typename P> void swap(qc::hash::RawMap<K, V, H, A, P> & a, qc::hash::RawMap<K, V, H, A, P> & b);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace qc::hash
+{
+    namespace _private
+    {
+        // Returns the lowest 64 bits from the given object
+        template <UnsignedInteger U, typename T>
+        inline constexpr U getLowBytes(const T & v)
+        {
+            // Key is aligned as `U` and can be simply reinterpreted as such
+            if constexpr (alignof(T) >= sizeof(U))
+            {
+                return reinterpret_cast<const U &>(v);
+            }
+                // Key's alignment matches its size and can be simply reinterpreted as an unsigned integer
+            else if constexpr (alignof(T) == sizeof(T))
+            {
+                return reinterpret_cast<const Unsigned<sizeof(T)> &>(v);
+            }
+                // Key is not nicely aligned, manually copy up to a `U`'s worth of memory
+                // Could use memcpy, but this gives better debug performance, and both compile to the same in release
+            else
+            {
+                U result{0u};
+                using Block = Unsigned<alignof(T) < sizeof(U) ? alignof(T) : sizeof(U)>;
+                constexpr u64 n{(sizeof(T) < sizeof(U) ? sizeof(T) : sizeof(U)) / sizeof(Block)};
+                const Block * src{reinterpret_cast<const Block *>(&v)};
+                Block * dst{reinterpret_cast<Block *>(&result)};
+
+                // We want the lower-order bytes, so need to adjust on big endian systems
+                if constexpr (std::endian::native == std::endian::big)
+                {
+                    constexpr u64 srcBlocks{sizeof(T) / sizeof(Block)};
+                    constexpr u64 dstBlocks{sizeof(U) / sizeof(Block)};
+                    if constexpr (srcBlocks > n)
+                    {
+                        src += srcBlocks - n;
+                    }
+                    if constexpr (dstBlocks > n)
+                    {
+                        dst += dstBlocks - n;
+                    }
+                }
+
+                // Copy blocks
+                if constexpr (n >= 1u) dst[0] = src[0];
+                if constexpr (n >= 2u) dst[1] = src[1];
+                if constexpr (n >= 3u) dst[2] = src[2];
+                if constexpr (n >= 4u) dst[3] = src[3];
+                if constexpr (n >= 5u) dst[4] = src[4];
+                if constexpr (n >= 6u) dst[5] = src[5];
+                if constexpr (n >= 7u) dst[6] = src[6];
+                if constexpr (n >= 8u) dst[7] = src[7];
+
+                return result;
+            }
+        }
+    }
+
+    namespace _private
+    {
+        inline void prefetch(const void * const address)
+        {
+            #if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(address);
+            #elif defined(QC_HASH_SSE2_ENABLED)
+                _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+            #else
+                static_cast<void>(address);
+            #endif
+        }
+
+        template <typename RawKey, typename V>
+        inline ConcurrentSlot<RawKey, V>::ConcurrentSlot(const RawKey key) :
+            key{key},
+            state{0u},
+            value{}
+        {}
+
+        inline u64 threadIndex()
+        {
+            static constinit std::atomic<u64> threadN{0u};
+            thread_local const u64 index{threadN.fetch_add(1u, std::memory_order_relaxed)};
+            return index;
+        }
+    }
+
+    #ifdef QC_HASH_SSE2_ENABLED
+        namespace _private::simd
+        {
+            inline Block load(const void * const data)
+            {
+                #ifdef QC_HASH_AVX2_ENABLED
+                    return _mm256_loadu_si256(static_cast<const Block *>(data));
+                #else
+                    return _mm_loadu_si128(static_cast<const Block *>(data));
+                #endif
+            }
+
+            template <UnsignedInteger U>
+            inline u32 matchMask(const Block & block, const U v)
+            {
+                #ifdef QC_HASH_AVX2_ENABLED
+                    if constexpr (sizeof(U) == 1u) return u32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(char(v)))));
+                    if constexpr (sizeof(U) == 2u) return u32(_mm256_movemask_epi8(_mm256_cmpeq_epi16(block, _mm256_set1_epi16(s16(v))))) & 0x55555555u;
+                    if constexpr (sizeof(U) == 4u) return u32(_mm256_movemask_epi8(_mm256_cmpeq_epi32(block, _mm256_set1_epi32(s32(v))))) & 0x11111111u;
+                    if constexpr (sizeof(U) == 8u) return u32(_mm256_movemask_epi8(_mm256_cmpeq_epi64(block, _mm256_set1_epi64x(s64(v))))) & 0x01010101u;
+                #else
+                    if constexpr (sizeof(U) == 1u) return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(char(v)))));
+                    if constexpr (sizeof(U) == 2u) return u32(_mm_movemask_epi8(_mm_cmpeq_epi16(block, _mm_set1_epi16(s16(v))))) & 0x5555u;
+                    if constexpr (sizeof(U) == 4u) return u32(_mm_movemask_epi8(_mm_cmpeq_epi32(block, _mm_set1_epi32(s32(v))))) & 0x1111u;
+                    if constexpr (sizeof(U) == 8u)
+                    {
+                        // No 64 bit compare in SSE2, so both 32 bit halves must match
+                        const u32 mask{u32(_mm_movemask_epi8(_mm_cmpeq_epi32(block, _mm_set1_epi64x(s64(v)))))};
+                        return mask & (mask >> 4) & 0x0101u;
+                    }
+                #endif
+            }
+
+            template <UnsignedInteger U>
+            inline constexpr u32 fullMask()
+            {
+                u32 mask{0u};
+                for (u64 byteI{0u}; byteI < blockSize; byteI += sizeof(U))
+                {
+                    mask |= 1u << byteI;
+                }
+                return mask;
+            }
+
+            template <u64 blockN, UnsignedInteger U>
+            inline bool matchAny(const void * const data, const U v)
+            {
+                const u8 * const bytes{static_cast<const u8 *>(data)};
+
+                #ifdef QC_HASH_AVX2_ENABLED
+                    const Block vs{sizeof(U) == 1u ? _mm256_set1_epi8(char(v)) : sizeof(U) == 2u ? _mm256_set1_epi16(s16(v)) : sizeof(U) == 4u ? _mm256_set1_epi32(s32(v)) : _mm256_set1_epi64x(s64(v))};
+                    const auto equal{[&vs](const Block & block) -> Block {
+                        if constexpr (sizeof(U) == 1u) return _mm256_cmpeq_epi8(block, vs);
+                        if constexpr (sizeof(U) == 2u) return _mm256_cmpeq_epi16(block, vs);
+                        if constexpr (sizeof(U) == 4u) return _mm256_cmpeq_epi32(block, vs);
+                        if constexpr (sizeof(U) == 8u) return _mm256_cmpeq_epi64(block, vs);
+                    }};
+                    Block matches{_mm256_setzero_si256()};
+                    [&]<u64... blockI>(std::index_sequence<blockI...>) {
+                        ((matches = _mm256_or_si256(matches, equal(load(bytes + blockI * blockSize)))), ...);
+                    }(std::make_index_sequence<blockN>{});
+                    return _mm256_movemask_epi8(matches);
+                #else
+                    const Block vs{sizeof(U) == 1u ? _mm_set1_epi8(char(v)) : sizeof(U) == 2u ? _mm_set1_epi16(s16(v)) : sizeof(U) == 4u ? _mm_set1_epi32(s32(v)) : _mm_set1_epi64x(s64(v))};
+                    const auto equal{[&vs](const Block & block) -> Block {
+                        if constexpr (sizeof(U) == 1u) return _mm_cmpeq_epi8(block, vs);
+                        if constexpr (sizeof(U) == 2u) return _mm_cmpeq_epi16(block, vs);
+                        if constexpr (sizeof(U) == 4u) return _mm_cmpeq_epi32(block, vs);
+                        if constexpr (sizeof(U) == 8u)
+                        {
+                            // No 64 bit compare in SSE2, so both 32 bit halves must match
+                            const Block halves{_mm_cmpeq_epi32(block, vs)};
+                            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, 0b10'11'00'01));
+                        }
+                    }};
+                    Block matches{_mm_setzero_si128()};
+                    [&]<u64... blockI>(std::index_sequence<blockI...>) {
+                        ((matches = _mm_or_si128(matches, equal(load(bytes + blockI * blockSize)))), ...);
+                    }(std::make_index_sequence<blockN>{});
+                    return _mm_movemask_epi8(matches);
+                #endif
+            }
+        }
+    #endif
+
+    template <u64 elementSize, u64 elementN>
+    inline constexpr auto UnsignedMulti<elementSize, elementN>::operator~() const -> UnsignedMulti
+    {
+        UnsignedMulti res;
+        for (u64 i{0u}; i < elementN; ++i)
+        {
+            res.elements[i] = Element(~elements[i]);
+        }
+        return res;
+    }
+
+    template <typename T>
+    inline constexpr CanonicalFloat<T>::CanonicalFloat(const T v) :
+        _bits{std::bit_cast<Unsigned<sizeof(T)>>(v)}
+    {
+        using U = Unsigned<sizeof(T)>;
+
+        constexpr U signMask{U(U(1u) << (sizeof(T) * 8u - 1u))};
+        constexpr U infBits{std::bit_cast<U>(std::numeric_limits<T>::infinity())};
+
+        // Done on the bits so that it still holds with fast-math
+        const U magnitude{U(_bits & ~signMask)};
+        if (magnitude == 0u)
+        {
+            _bits = 0u;
+        }
+        else if (magnitude > infBits)
+        {
+            _bits = std::bit_cast<U>(std::numeric_limits<T>::quiet_NaN());
+        }
+    }
+
+    template <typename T>
+    inline constexpr CanonicalFloat<T>::operator T() const
+    {
+        return std::bit_cast<T>(_bits);
+    }
+
+    template <Rawable T>
+    struct IdentityHash
+    {
+        [[nodiscard]] constexpr u64 operator()(const T & v) const
+        {
+            return _private::getLowBytes<u64>(v);
+        }
+    };
+
+    template <typename T>
+    struct IdentityHash<T *>
+    {
+        [[nodiscard]] constexpr u64 operator()(const T * const v) const
+        {
+            // Bit shift away the low zero bits to maximize low-order entropy
+            constexpr s32 shift{s32(std::bit_width(alignof(T)) - 1u)};
+            return std::bit_cast<u64>(v) >> shift;
+        }
+    };
+
+    template <typename T>
+    struct IdentityHash<std::unique_ptr<T>> : IdentityHash<T *>
+    {
+        // Allows heterogeneity with raw pointers
+        using IdentityHash<T *>::operator();
+
+        [[nodiscard]] constexpr u64 operator()(const std::unique_ptr<T> & v) const
+        {
+            return (*this)(v.get());
+        }
+    };
+
+    template <typename T>
+    struct IdentityHash<std::shared_ptr<T>> : IdentityHash<T *>
+    {
+        // Allows heterogeneity with raw pointers
+        using IdentityHash<T *>::operator();
+
+        [[nodiscard]] constexpr u64 operator()(const std::shared_ptr<T> & v) const
+        {
+            return (*this)(v.get());
+        }
+    };
+
+    template <typename T>
+    struct IdentityHash<CanonicalFloat<T>>
+    {
+        [[nodiscard]] constexpr u64 operator()(const CanonicalFloat<T> v) const
+        {
+            return fastHash::mix(u64(std::bit_cast<Unsigned<sizeof(T)>>(v)));
+        }
+    };
+
+    template <Rawable T>
+    class AdaptiveHash
+    {
+      public:
+
+        template <typename U> [[nodiscard]] constexpr u64 operator()(const U & v) const requires (requires (IdentityHash<T> identityHash, FastHash<T> fastHash) { identityHash(v); fastHash(v); })
+        {
+            return _isMixing ? u64{FastHash<T>{}(v)} : u64{IdentityHash<T>{}(v)};
+        }
+
+        ///
+        /// @returns whether hashing as `FastHash`
+        ///
+        [[nodiscard]] constexpr bool isMixing() const
+        {
+            return _isMixing;
+        }
+
+        ///
+        /// Switches to hashing as `FastHash`, for good. Every key hashed before must be rehashed
+        ///
+        constexpr void startMixing()
+        {
+            _isMixing = true;
+        }
+
+      private:
+
+        bool _isMixing{};
+    };
+
+    template <typename T>
+    struct FastHash
+    {
+        [[nodiscard]] constexpr u64 operator()(const T & v) const
+        {
+            return fastHash::hash<u64>(v);
+        }
+
+        ///
+        /// Hashes each key exactly as `operator()` would, many at once, see `fastHash::hash_n`
+        ///
+        /// Used by the batch operations of `RawMap`, such as `contains_batch` and range insertion
+        ///
+        /// @param keys the keys to hash
+        /// @param out receives the hash of each key; must be at least as long as `keys`
+        ///
+        void hash_n(const std::span<const T> keys, const std::span<u64> out) const
+        {
+            fastHash::hash_n(keys, out);
+        }
+    };
+
+    template <typename T>
+    struct FastHash<T *>
+    {
+        [[nodiscard]] constexpr u64 operator()(const T * const v) const
+        {
+            return fastHash::hash<u64>(v);
+        }
+    };
+
+    template <typename T>
+    struct FastHash<std::unique_ptr<T>> : FastHash<T *>
+    {
+        // Allows heterogeneity with raw pointers
+        using FastHash<T *>::operator();
+
+        [[nodiscard]] constexpr u64 operator()(const std::unique_ptr<T> & v) const
+        {
+            return (*this)(v.get());
+        }
+    };
+
+    template <typename T>
+    struct FastHash<std::shared_ptr<T>> : FastHash<T *>
+    {
+        // Allows heterogeneity with raw pointers
+        using FastHash<T *>::operator();
+
+        [[nodiscard]] constexpr u64 operator()(const std::shared_ptr<T> & v) const
+        {
+            return (*this)(v.get());
+        }
+    };
+
+    template <>
+    struct FastHash<std::string>
+    {
+        [[nodiscard]] u64 operator()(const std::string & v) const
+        {
+            return fastHash::hash<u64>(v.c_str(), v.length());
+        }
+
+        [[nodiscard]] u64 operator()(const std::string_view & v) const
+        {
+            return fastHash::hash<u64>(v.data(), v.length());
+        }
+
+        [[nodiscard]] u64 operator()(const char * v) const
+        {
             return fastHash::hash<u64>(v, std::strlen(v));
         }
-    };
+    };
+
+    // Same as `std::string` specialization
+    template <> struct FastHash<std::string_view> : FastHash<std::string> {};
+
+    namespace fastHash
+    {
+        template <typename H> struct Constants;
+        template <> struct Constants<u64> { inline static constexpr u64 m{0xC6A4A7935BD1E995u}; inline static constexpr s32 r{47}; };
+        template <> struct Constants<u32> { inline static constexpr u32 m{0x5BD1E995u};         inline static constexpr s32 r{24}; };
+        template <typename H> inline constexpr H m{Constants<H>::m};
+        template <typename H> inline constexpr s32 r{Constants<H>::r};
+
+        template <UnsignedInteger H>
+        inline constexpr H mix(H v)
+        {
+            v *= m<H>;
+            v ^= v >> r<H>;
+            return v * m<H>;
+        }
+
+        template <UnsignedInteger H, typename T>
+        inline constexpr H hash(const T & v)
+        {
+            // IMPORTANT: These two cases must yield the same hash for the same input bytes
+
+            // Optimized case if the size of the key is less than or equal to the size of the hash
+            if constexpr (sizeof(T) <= sizeof(H))
+            {
+                return (H(sizeof(T)) * m<H>) ^ mix(_private::getLowBytes<H>(v));
+            }
+            // General case
+            else
+            {
+                return hash<H>(&v, sizeof(T));
+            }
+        }
+
+        // Mixes a word into a lane with one multiply, which is all that lies on the lane's dependency chain
+        inline u64 mixLane(u64 lane, const std::byte * const bytes)
+        {
+            u64 w;
+            std::memcpy(&w, bytes, sizeof(u64));
+
+            lane = (lane ^ w) * m<u64>;
+            return lane ^ (lane >> r<u64>);
+        }
+
+        // Mixes in all whole 32 byte stripes a word per lane, then folds the lanes together. Advances `bytes` and
+        // `length` past the stripes
+        inline u64 hashStripes(const std::byte * & bytes, u64 & length)
+        {
+            // Seed each lane differently so that the same word mixes differently in each
+            u64 lane0{length};
+            u64 lane1{length + m<u64>};
+            u64 lane2{length + m<u64> * 2u};
+            u64 lane3{length + m<u64> * 3u};
+
+            while (length >= 32u)
+            {
+                lane0 = mixLane(lane0, bytes);
+                lane1 = mixLane(lane1, bytes + 8u);
+                lane2 = mixLane(lane2, bytes + 16u);
+                lane3 = mixLane(lane3, bytes + 24u);
+
+                bytes += 32u;
+                length -= 32u;
+            }
+
+            // Rotated so that swapping the contents of two lanes changes the hash
+            return (mix(lane0) ^ std::rotl(mix(lane1), 16)) + (mix(lane2) ^ std::rotl(mix(lane3), 32));
+        }
+
+        // Based on Murmur2, but simplified, and doesn't require unaligned reads
+        template <UnsignedInteger H>
+        inline H hash(const void * const data, u64 length)
+        {
+            const std::byte * bytes{static_cast<const std::byte *>(data)};
+            H h{H(length)};
+
+            // Long data is mostly taken in stripes, leaving the usual loop the last few words
+            if constexpr (std::is_same_v<H, u64>)
+            {
+                if (length >= bulkLength)
+                {
+                    h = hashStripes(bytes, length);
+                }
+            }
+
+            // Mix in `H` bytes worth at a time
+            while (length >= sizeof(H))
+            {
+                H w;
+                std::memcpy(&w, bytes, sizeof(H));
+
+                h *= m<H>;
+                h ^= mix(w);
+
+                bytes += sizeof(H);
+                length -= sizeof(H);
+            };
+
+            // Mix in the last few bytes
+            if (length)
+            {
+                H w{0u};
+                std::memcpy(&w, bytes, length);
+
+                h *= m<H>;
+                h ^= mix(w);
+            }
+
+            return h;
+        }
+    }
+
+    #ifdef QC_HASH_AVX2_ENABLED
+        namespace _private::simd
+        {
+            template <u64 wordSize>
+            inline u64 hashWords(const void * const words, const u64 n, u64 * const out)
+            {
+                static_assert(wordSize == 4u || wordSize == 8u);
+
+                const u8 * const bytes{static_cast<const u8 *>(words)};
+                u64 i{0u};
+
+                #ifdef QC_HASH_AVX512_ENABLED
+                    const __m512i m{_mm512_set1_epi64(s64(fastHash::m<u64>))};
+                    const __m512i seed{_mm512_set1_epi64(s64(wordSize * fastHash::m<u64>))};
+
+                    // The zero masking forms with a full mask are used as the unmasked ones trip a false uninitialized warning
+                    // in some versions of GCC. Both compile to the same instructions
+                    constexpr __mmask8 fullMask{0xFFu};
+
+                    for (; i + 8u <= n; i += 8u)
+                    {
+                        // Smaller words are zero extended, as `getLowBytes` does
+                        __m512i v;
+                        if constexpr (wordSize == 8u) v = _mm512_loadu_si512(bytes + i * 8u);
+                        if constexpr (wordSize == 4u) v = _mm512_maskz_cvtepu32_epi64(fullMask, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i * 4u)));
+
+                        v = _mm512_mullo_epi64(v, m);
+                        v = _mm512_xor_si512(v, _mm512_maskz_srli_epi64(fullMask, v, unsigned(fastHash::r<u64>)));
+                        v = _mm512_mullo_epi64(v, m);
+                        _mm512_storeu_si512(out + i, _mm512_xor_si512(v, seed));
+                    }
+                #else
+                    // No 64 bit multiply, so it is built from three 32 bit ones. The high halves' product is shifted out
+                    const __m256i mLow{_mm256_set1_epi64x(s64(fastHash::m<u64> & 0xFFFF'FFFFu))};
+                    const __m256i mHigh{_mm256_set1_epi64x(s64(fastHash::m<u64> >> 32))};
+                    const __m256i seed{_mm256_set1_epi64x(s64(wordSize * fastHash::m<u64>))};
+                    const auto multiply{[&mLow, &mHigh](const __m256i v) -> __m256i {
+                        const __m256i cross{_mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(v, 32), mLow), _mm256_mul_epu32(v, mHigh))};
+                        return _mm256_add_epi64(_mm256_mul_epu32(v, mLow), _mm256_slli_epi64(cross, 32));
+                    }};
+
+                    for (; i + 4u <= n; i += 4u)
+                    {
+                        // Smaller words are zero extended, as `getLowBytes` does
+                        __m256i v;
+                        if constexpr (wordSize == 8u) v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + i * 8u));
+                        if constexpr (wordSize == 4u) v = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i * 4u)));
+
+                        v = multiply(v);
+                        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, fastHash::r<u64>));
+                        v = multiply(v);
+                        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_xor_si256(v, seed));
+                    }
+                #endif
+
+                return i;
+            }
+        }
+    #endif
+
+    namespace fastHash
+    {
+        template <typename T>
+        inline void hash_n(const std::span<const T> vs, const std::span<u64> out)
+        {
+            u64 i{0u};
+
+            #ifdef QC_HASH_AVX2_ENABLED
+                if constexpr (sizeof(T) == sizeof(u64) || sizeof(T) == sizeof(u32))
+                {
+                    i = _private::simd::hashWords<sizeof(T)>(vs.data(), vs.size(), out.data());
+                }
+            #endif
+
+            for (; i < vs.size(); ++i)
+            {
+                out[i] = hash<u64>(vs[i]);
+            }
+        }
+    }
+
+    template <typename K>
+    inline RawType<K> & _raw(K & key)
+    {
+        return reinterpret_cast<RawType<K> &>(key);
+    }
+
+    template <typename K>
+    inline const RawType<K> & _raw(const K & key)
+    {
+        return reinterpret_cast<const RawType<K> &>(key);
+    }
+
+    template <typename T>
+    inline T * HugePageAllocator<T>::allocate(const u64 n)
+    {
+        const u64 size{n * sizeof(T)};
+
+        #ifdef QC_HASH_MMAP_ENABLED
+            if (size >= hugePageSize)
+            {
+                const u64 mapSize{(size + hugePageSize - 1u) & ~(hugePageSize - 1u)};
+
+                // Explicit huge pages, which only exist if the system has reserved some
+                #ifdef MAP_HUGETLB
+                    #ifdef MAP_HUGE_2MB
+                        constexpr int hugeFlags{MAP_HUGETLB | MAP_HUGE_2MB};
+                    #else
+                        constexpr int hugeFlags{MAP_HUGETLB};
+                    #endif
+                    void * const hugeMemory{::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE | hugeFlags, -1, 0)};
+                    if (hugeMemory != MAP_FAILED)
+                    {
+                        return static_cast<T *>(hugeMemory);
+                    }
+                #endif
+
+                // Otherwise map an extra huge page's worth so the memory can be trimmed to a huge page boundary, which
+                // transparent huge pages require
+                void * const memory{::mmap(nullptr, mapSize + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+                if (memory == MAP_FAILED) [[unlikely]]
+                {
+                    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+                        throw std::bad_alloc{};
+                    #else
+                        std::abort();
+                    #endif
+                }
+
+                std::byte * const begin{static_cast<std::byte *>(memory)};
+                std::byte * const alignedBegin{reinterpret_cast<std::byte *>((reinterpret_cast<uintptr_t>(begin) + hugePageSize - 1u) & ~(hugePageSize - 1u))};
+                std::byte * const alignedEnd{alignedBegin + mapSize};
+                if (alignedBegin != begin)
+                {
+                    ::munmap(begin, u64(alignedBegin - begin));
+                }
+                ::munmap(alignedEnd, u64(begin + mapSize + hugePageSize - alignedEnd));
+
+                // Must be advised before the memory is touched, or it is faulted in as normal pages
+                #ifdef MADV_HUGEPAGE
+                    ::madvise(alignedBegin, mapSize, MADV_HUGEPAGE);
+                #endif
+
+                // Pre-fault the memory in one call where the kernel supports it, or else by touching each page
+                #ifdef MADV_POPULATE_WRITE
+                    if (::madvise(alignedBegin, mapSize, MADV_POPULATE_WRITE) == 0)
+                    {
+                        return reinterpret_cast<T *>(alignedBegin);
+                    }
+                #endif
+                for (volatile std::byte * page{alignedBegin}; page < alignedEnd; page += 4096)
+                {
+                    *page = std::byte{};
+                }
+
+                return reinterpret_cast<T *>(alignedBegin);
+            }
+        #endif
+
+        return static_cast<T *>(::operator new(size, std::align_val_t{alignof(T)}));
+    }
+
+    template <typename T>
+    inline void HugePageAllocator<T>::deallocate(T * const p, const u64 n) noexcept
+    {
+        const u64 size{n * sizeof(T)};
+
+        #ifdef QC_HASH_MMAP_ENABLED
+            if (size >= hugePageSize)
+            {
+                ::munmap(p, (size + hugePageSize - 1u) & ~(hugePageSize - 1u));
+                return;
+            }
+        #endif
+
+        ::operator delete(p, size, std::align_val_t{alignof(T)});
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const u64 capacity, const H & hash, const A & alloc):
+        _size{},
+        _graveN{},
+        _slotN{_slotNFor(capacity, P::maxLoadFactor)},
+        _elements{},
+        _haveSpecial{},
+        _hash{hash},
+        _alloc{alloc},
+        _maxLoadFactor{P::maxLoadFactor}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const u64 capacity, const A & alloc) :
+        RawMap{capacity, H{}, alloc}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const A & alloc) :
+        RawMap{minMapCapacity, H{}, alloc}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename It>
+    inline RawMap<K, V, H, A, P>::RawMap(const It first, const It last, const u64 capacity, const H & hash, const A & alloc) :
+        RawMap{capacity, hash, alloc}
+    {
+        insert(first, last);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename It>
+    inline RawMap<K, V, H, A, P>::RawMap(const It first, const It last, const u64 capacity, const A & alloc) :
+        RawMap{first, last, capacity, H{}, alloc}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const std::initializer_list<E> elements, u64 capacity, const H & hash, const A & alloc) :
+        RawMap{capacity ? capacity : elements.size(), hash, alloc}
+    {
+        insert(elements);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const std::initializer_list<E> elements, const u64 capacity, const A & alloc) :
+        RawMap{elements, capacity, H{}, alloc}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(const RawMap & other) :
+        _size{other._size},
+        _graveN{other._size ? other._graveN : 0u},
+        _slotN{other._slotN},
+        _elements{},
+        _haveSpecial{other._haveSpecial[0], other._haveSpecial[1]},
+        _hash{other._hash},
+        _alloc{std::allocator_traits<A>::select_on_container_copy_construction(other._alloc)},
+        _maxLoadFactor{other._maxLoadFactor}
+    {
+        if (_size)
+        {
+            _allocate<false>();
+            _forwardData<false>(other);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::RawMap(RawMap && other) :
+        _size{std::exchange(other._size, 0u)},
+        _graveN{std::exchange(other._graveN, 0u)},
+        _slotN{std::exchange(other._slotN, _slotNFor(0u, other._maxLoadFactor))},
+        _elements{std::exchange(other._elements, nullptr)},
+        _haveSpecial{std::exchange(other._haveSpecial[0], false), std::exchange(other._haveSpecial[1], false)},
+        _hash{std::move(other._hash)},
+        _alloc{std::move(other._alloc)},
+        _maxLoadFactor{other._maxLoadFactor}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P> & RawMap<K, V, H, A, P>::operator=(const std::initializer_list<E> elements)
+    {
+        return *this = RawMap(elements);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P> & RawMap<K, V, H, A, P>::operator=(const RawMap & other)
+    {
+        if (&other == this)
+        {
+            return *this;
+        }
+
+        if (_elements)
+        {
+            _clear<false>();
+            if (!other._size || _slotN != other._slotN || _alloc != other._alloc)
+            {
+                _deallocate();
+            }
+        }
+
+        _size = other._size;
+        _graveN = other._size ? other._graveN : 0u;
+        _slotN = other._slotN;
+        _haveSpecial[0] = other._haveSpecial[0];
+        _haveSpecial[1] = other._haveSpecial[1];
+        _hash = other._hash;
+        _maxLoadFactor = other._maxLoadFactor;
+        if constexpr (std::allocator_traits<A>::propagate_on_container_copy_assignment::value)
+        {
+            _alloc = std::allocator_traits<A>::select_on_container_copy_construction(other._alloc);
+        }
+
+        if (_size)
+        {
+            if (!_elements)
+            {
+                _allocate<false>();
+            }
+
+            _forwardData<false>(other);
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P> & RawMap<K, V, H, A, P>::operator=(RawMap && other)
+    {
+        if (&other == this)
+        {
+            return *this;
+        }
+
+        if (_elements)
+        {
+            _clear<false>();
+            _deallocate();
+        }
+
+        _size = other._size;
+        _slotN = other._slotN;
+        _haveSpecial[0] = other._haveSpecial[0];
+        _haveSpecial[1] = other._haveSpecial[1];
+        _hash = std::move(other._hash);
+        _maxLoadFactor = other._maxLoadFactor;
+        if constexpr (std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+        {
+            _alloc = std::move(other._alloc);
+        }
+
+        if (_alloc == other._alloc || std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+        {
+            _elements = std::exchange(other._elements, nullptr);
+            _graveN = other._graveN;
+            other._size = {};
+        }
+        else
+        {
+            _graveN = _size ? other._graveN : 0u;
+            if (_size)
+            {
+                _allocate<false>();
+                _forwardData<true>(other);
+                other._clear<false>();
+                other._size = 0u;
+            }
+            if (other._elements)
+            {
+                other._deallocate();
+            }
+        }
+
+        other._graveN = 0u;
+        other._slotN = _slotNFor(0u, other._maxLoadFactor);
+        other._haveSpecial[0] = false;
+        other._haveSpecial[1] = false;
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawMap<K, V, H, A, P>::~RawMap()
+    {
+        if (_elements)
+        {
+            _clear<false>();
+            _deallocate();
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::insert(const E & element) -> std::pair<iterator, bool>
+    {
+        static_assert(std::is_copy_constructible_v<E>);
+
+        return emplace(element);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::insert(E && element) -> std::pair<iterator, bool>
+    {
+        return emplace(std::move(element));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename It>
+    inline u64 RawMap<K, V, H, A, P>::insert(It first, const It last)
+    {
+        const u64 oldSize{_size};
+
+        if constexpr (std::forward_iterator<It>)
+        {
+            // Grow once up front rather than repeatedly along the way
+            const u64 n{u64(std::distance(first, last))};
+            if (_size + n > capacity())
+            {
+                reserve(_size + n);
+            }
+        }
+
+        if constexpr (std::forward_iterator<It> && std::is_same_v<std::remove_cvref_t<std::iter_reference_t<It>>, E>)
+        {
+            if (first == last)
+            {
+                return 0u;
+            }
+
+            // Need memory to prefetch
+            if (!_elements)
+            {
+                _allocate<true>();
+            }
+
+            u64 hashes[_batchWindow];
+
+            while (first != last)
+            {
+                // Hash and prefetch the next window of elements before inserting any of them
+                u64 windowN{0u};
+                if constexpr (_isSet && std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, K>)
+                {
+                    // The keys are contiguous, so the hasher may take the whole window at once
+                    windowN = u64(last - first) < _batchWindow ? u64(last - first) : _batchWindow;
+                    _hashEach(std::span<const K>{std::to_address(first), windowN}, hashes);
+                }
+                else
+                {
+                    for (It it{first}; it != last && windowN < _batchWindow; ++it, ++windowN)
+                    {
+                        if constexpr (_isSet)
+                        {
+                            hashes[windowN] = _hashOf(*it);
+                        }
+                        else
+                        {
+                            hashes[windowN] = _hashOf((*it).first);
+                        }
+                    }
+                }
+                for (u64 i{0u}; i < windowN; ++i)
+                {
+                    _private::prefetch(_elements + (hashes[i] & (_slotN - 1u)));
+                }
+
+                // Hashes rather than slots are kept, as they remain valid should the insertions rehash. Not so should an
+                // adaptive hasher switch, after which the rest of the window is hashed anew
+                [[maybe_unused]] bool wasMixing{};
+                if constexpr (_isAdaptive)
+                {
+                    wasMixing = _hash.isMixing();
+                }
+                for (u64 i{0u}; i < windowN; ++i, ++first)
+                {
+                    if constexpr (_isAdaptive)
+                    {
+                        if (_hash.isMixing() != wasMixing) [[unlikely]]
+                        {
+                            if constexpr (_isSet)
+                            {
+                                hashes[i] = _hashOf(*first);
+                            }
+                            else
+                            {
+                                hashes[i] = _hashOf((*first).first);
+                            }
+                        }
+                    }
+
+                    if constexpr (_isSet)
+                    {
+                        _tryEmplace(hashes[i], *first);
+                    }
+                    else
+                    {
+                        _tryEmplace(hashes[i], (*first).first, (*first).second);
+                    }
+                }
+            }
+        }
+        else
+        {
+            while (first != last)
+            {
+                emplace(*first);
+                ++first;
+            }
+        }
+
+        return _size - oldSize;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::insert(const std::initializer_list<E> elements)
+    {
+        return insert(elements.begin(), elements.end());
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::emplace(const E & element) -> std::pair<iterator, bool>
+    {
+        static_assert(std::is_copy_constructible_v<E>);
+
+        if constexpr (_isSet)
+        {
+            return try_emplace(element);
+        }
+        else
+        {
+            return try_emplace(element.first, element.second);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::emplace(E && element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
+        {
+            return try_emplace(std::move(element));
+        }
+        else
+        {
+            return try_emplace(std::move(element.first), std::move(element.second));
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename V_>
+    inline auto RawMap<K, V, H, A, P>::emplace(K_ && key, V_ && value) -> std::pair<iterator, bool> requires (!std::is_same_v<V, void>)
+    {
+        return try_emplace(std::forward<K_>(key), std::forward<V_>(value));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename... KArgs>
+    inline auto RawMap<K, V, H, A, P>::emplace(KArgs &&... keyArgs) -> std::pair<iterator, bool> requires (std::is_same_v<V, void>)
+    {
+        return try_emplace(K{std::forward<KArgs>(keyArgs)...});
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename... KArgs, typename... VArgs>
+    inline auto RawMap<K, V, H, A, P>::emplace(const std::piecewise_construct_t, std::tuple<KArgs...> && keyArgs, std::tuple<VArgs...> && valueArgs) -> std::pair<iterator, bool> requires (!std::is_same_v<V, void>)
+    {
+        return _emplace(std::move(keyArgs), std::move(valueArgs), std::index_sequence_for<KArgs...>(), std::index_sequence_for<VArgs...>());
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename KTuple, typename VTuple, u64... kIndices, u64... vIndices>
+    inline auto RawMap<K, V, H, A, P>::_emplace(KTuple && kTuple, VTuple && vTuple, const std::index_sequence<kIndices...>, const std::index_sequence<vIndices...>) -> std::pair<iterator, bool>
+    {
+        return try_emplace(K{std::move(std::get<kIndices>(kTuple))...}, std::move(std::get<vIndices>(vTuple))...);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline auto RawMap<K, V, H, A, P>::try_emplace(K_ && key, VArgs &&... vArgs) -> std::pair<iterator, bool>
+    {
+        static_assert(!(_isMap && !sizeof...(VArgs) && !std::is_default_constructible_v<V>), "The value type must be default constructible in order to pass no value arguments");
+        static_assert(!(_isSet && sizeof...(VArgs)), "Sets do not have values");
+
+        return _tryEmplace(_hashOf(key), std::forward<K_>(key), std::forward<VArgs>(vArgs)...);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline auto RawMap<K, V, H, A, P>::_tryEmplace(const u64 hash, K_ && key, VArgs &&... vArgs) -> std::pair<iterator, bool>
+    {
+        // If we've yet to allocate memory, now is the time
+        if (!_elements)
+        {
+            _allocate<true>();
+        }
+
+        _FindKeyResult<true> findResult{_findKey<true>(key, hash & (_slotN - 1u))};
+
+        // Key is already present
+        if (findResult.isPresent)
+        {
+            return {_iterator(findResult.element), false};
+        }
+
+        if (findResult.isSpecial) [[unlikely]]
+        {
+            _haveSpecial[findResult.specialI] = true;
+        }
+        else
+        {
+            const u64 regularSize{_size - _haveSpecial[0] - _haveSpecial[1]};
+
+            // Rehash if we're at capacity
+            if (regularSize >= capacity()) [[unlikely]]
+            {
+                _rehash(_slotN << 1);
+                findResult = _findKey<true>(key, hash & (_slotN - 1u));
+            }
+            else if constexpr (!_isBackwardShift)
+            {
+                if (_raw(_key(*findResult.element)) == _graveKey)
+                {
+                    --_graveN;
+                }
+                // Purge graves if they're crowding out vacant slots
+                else if (regularSize + _graveN >= _graveLimit()) [[unlikely]]
+                {
+                    // Only purge if enough graves would be reclaimed to amortize the cost, otherwise grow
+                    if ((_graveN << 3) >= _slotN)
+                    {
+                        _purgeGraves();
+                    }
+                    else
+                    {
+                        _rehash(_slotN << 1);
+                    }
+
+                    findResult = _findKey<true>(key, hash & (_slotN - 1u));
+                }
+            }
+
+            if constexpr (_isAdaptive)
+            {
+                // So long a probe under identity hashing means the keys share their low bits, so switch to mixing
+                if (!_hash.isMixing() && ((u64(findResult.element - _elements) - hash) & (_slotN - 1u)) + 1u >= P::adaptiveProbeLimit) [[unlikely]]
+                {
+                    _hash.startMixing();
+                    _rehash(_slotN);
+                    findResult = _findKey<true>(key);
+                }
+            }
+
+            if constexpr (P::robinHood)
+            {
+                // Make room by shifting the rest of the probe sequence forward a slot
+                if (_raw(_key(*findResult.element)) != _vacantKey)
+                {
+                    _shiftForward(u64(findResult.element - _elements));
+                }
+            }
+        }
+
+        if constexpr (_isSet)
+        {
+            std::allocator_traits<A>::construct(_alloc, findResult.element, std::forward<K_>(key));
+        }
+        else
+        {
+            std::allocator_traits<A>::construct(_alloc, &_key(*findResult.element), std::forward<K_>(key));
+            std::allocator_traits<A>::construct(_alloc, &_value(*findResult.element), std::forward<VArgs>(vArgs)...);
+        }
+
+        ++_size;
+
+        return {_iterator(findResult.element), true};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool RawMap<K, V, H, A, P>::erase(const K_ & key)
+    {
+        if (!_size)
+        {
+            return false;
+        }
+
+        const auto[element, isPresent]{_findKey<false>(key)};
+
+        if (isPresent)
+        {
+            erase(_iterator(element));
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::erase(const iterator position)
+    {
+        _Slot * const eraseElement{position._element};
+        _RawKey & rawKey{_raw(_key(*eraseElement))};
+        _Slot * const specialElements{_elements + _slotN};
+
+        _destroy(eraseElement);
+
+        // General case
+        if (eraseElement < specialElements)
+        {
+            if constexpr (_isBackwardShift)
+            {
+                _shiftBack(u64(eraseElement - _elements));
+            }
+            else
+            {
+                rawKey = _graveKey;
+                ++_graveN;
+            }
+        }
+        else [[unlikely]]
+        {
+            const auto specialI{eraseElement - specialElements};
+            _raw(_key(specialElements[specialI])) = _vacantSpecialKeys[specialI];
+            _haveSpecial[specialI] = false;
+        }
+
+        --_size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_shiftBack(u64 holeI)
+    {
+        const u64 slotMask{_slotN - 1u};
+
+        // Stop at the end of the probe sequence. There is always at least one vacant slot
+        for (u64 slotI{(holeI + 1u) & slotMask}; _raw(_key(_elements[slotI])) != _vacantKey; slotI = (slotI + 1u) & slotMask)
+        {
+            // The element may only move back if that wouldn't put it before its ideal slot
+            const u64 dist{(slotI - _slot(_key(_elements[slotI]))) & slotMask};
+
+            // Robin Hood keeps the cluster ordered by ideal slot, so nothing past an element in its ideal slot can move
+            if constexpr (P::robinHood)
+            {
+                if (!dist)
+                {
+                    break;
+                }
+            }
+
+            if (dist >= ((slotI - holeI) & slotMask))
+            {
+                _forwardElement<true>(holeI, _elements, _slotN, slotI);
+                _destroy(_elements, _slotN, slotI);
+                holeI = slotI;
+            }
+        }
+
+        _raw(_key(_elements[holeI])) = _vacantKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_shiftForward(const u64 slotI)
+    {
+        const u64 slotMask{_slotN - 1u};
+
+        u64 vacantSlotI{(slotI + 1u) & slotMask};
+        while (_raw(_key(_elements[vacantSlotI])) != _vacantKey)
+        {
+            vacantSlotI = (vacantSlotI + 1u) & slotMask;
+        }
+
+        // Work backwards from the vacant slot so nothing is overwritten
+        for (u64 dstSlotI{vacantSlotI}; dstSlotI != slotI;)
+        {
+            const u64 srcSlotI{(dstSlotI - 1u) & slotMask};
+            _forwardElement<true>(dstSlotI, _elements, _slotN, srcSlotI);
+            _destroy(_elements, _slotN, srcSlotI);
+            dstSlotI = srcSlotI;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_graveLimit() const
+    {
+        const u64 limit{u64(f64(_slotN) * f64(P::gravePurgeThreshold))};
+        const u64 capacity{this->capacity()};
+
+        if (limit < capacity)
+        {
+            return capacity;
+        }
+        else if (limit >= _slotN)
+        {
+            return _slotN - 1u;
+        }
+        else
+        {
+            return limit;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::purge_graves()
+    {
+        if (_graveN)
+        {
+            _purgeGraves();
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_purgeGraves()
+    {
+        const u64 slotMask{_slotN - 1u};
+
+        // Start just after a vacant slot. As no probe sequence spans a vacant slot, each element's probe sequence then
+        // lies entirely within the slots already visited by the time the element is reached
+        u64 startSlotI{0u};
+        while (_raw(_key(_elements[startSlotI])) != _vacantKey)
+        {
+            ++startSlotI;
+        }
+
+        for (u64 n{1u}; n < _slotN; ++n)
+        {
+            const u64 slotI{(startSlotI + n) & slotMask};
+            _RawKey & rawKey{_raw(_key(_elements[slotI]))};
+
+            if (rawKey == _graveKey)
+            {
+                rawKey = _vacantKey;
+            }
+            else if (rawKey != _vacantKey)
+            {
+                // Move the element back to the first vacant slot of its probe sequence, if any
+                u64 dstSlotI{_slot(_key(_elements[slotI]))};
+                while (dstSlotI != slotI && _raw(_key(_elements[dstSlotI])) != _vacantKey)
+                {
+                    dstSlotI = (dstSlotI + 1u) & slotMask;
+                }
+
+                if (dstSlotI != slotI)
+                {
+                    _forwardElement<true>(dstSlotI, _elements, _slotN, slotI);
+                    _destroy(_elements, _slotN, slotI);
+                    _raw(_key(_elements[slotI])) = _vacantKey;
+                }
+            }
+        }
+
+        _graveN = 0u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::clear()
+    {
+        _clear<true>();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool preserveInvariants>
+    inline void RawMap<K, V, H, A, P>::_clear()
+    {
+        if constexpr (std::is_trivially_destructible_v<E>)
+        {
+            if constexpr (preserveInvariants)
+            {
+                if (_size)
+                {
+                    _clearKeys();
+                    _size = {};
+                    _graveN = {};
+                    _haveSpecial[0] = false;
+                    _haveSpecial[1] = false;
+                }
+            }
+        }
+        else
+        {
+            if (_size)
+            {
+                // General case
+                _Slot * element{_elements};
+                u64 n{};
+                const u64 regularElementN{_size - _haveSpecial[0] - _haveSpecial[1]};
+                for (; n < regularElementN; ++element)
+                {
+                    _RawKey & rawKey{_raw(_key(*element))};
+                    if (_isPresent(rawKey))
+                    {
+                        _destroy(element);
+                        ++n;
+                    }
+                    if constexpr (preserveInvariants)
+                    {
+                        rawKey = _vacantKey;
+                    }
+                }
+                // Clear remaining graves
+                if constexpr (preserveInvariants)
+                {
+                    const _Slot * const endRegularElement{_elements + _slotN};
+                    for (; element < endRegularElement; ++element)
+                    {
+                        _raw(_key(*element)) = _vacantKey;
+                    }
+                }
+
+                // Special keys case
+                if (_haveSpecial[0]) [[unlikely]]
+                {
+                    element = _elements + _slotN;
+                    _destroy(element);
+                    if constexpr (preserveInvariants)
+                    {
+                        _raw(_key(*element)) = _vacantGraveKey;
+                        _haveSpecial[0] = false;
+                    }
+                }
+                if (_haveSpecial[1]) [[unlikely]]
+                {
+                    element = _elements + _slotN + 1;
+                    _destroy(element);
+                    if constexpr (preserveInvariants)
+                    {
+                        _raw(_key(*element)) = _vacantVacantKey;
+                        _haveSpecial[1] = false;
+                    }
+                }
+
+                if constexpr (preserveInvariants)
+                {
+                    _size = {};
+                    _graveN = {};
+                }
+            }
+        }
+
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool RawMap<K, V, H, A, P>::contains(const K_ & key) const
+    {
+        return _size ? _findKey<false>(key).isPresent : false;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 RawMap<K, V, H, A, P>::count(const K_ & key) const
+    {
+        return contains(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::contains_batch(const std::span<const K> keys, const std::span<bool> out) const
+    {
+        if (!_size)
+        {
+            for (u64 i{0u}; i < keys.size(); ++i)
+            {
+                out[i] = false;
+            }
+
+            return 0u;
+        }
+
+        u64 presentN{0u};
+
+        _findKeys(keys, [&](const u64 i, const _FindKeyResult<false> & findResult) {
+            out[i] = findResult.isPresent;
+            presentN += findResult.isPresent;
+        });
+
+        return presentN;
+    }
+
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A, P>::at(const K_ & key) requires (!std::is_same_v<V, void>)
+        {
+            return const_cast<V &>(static_cast<const RawMap *>(this)->at(key));
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<const V> RawMap<K, V, H, A, P>::at(const K_ & key) const requires (!std::is_same_v<V, void>)
+        {
+            if (!_size)
+            {
+                throw std::out_of_range{"Map is empty"};
+            }
+
+            const auto [element, isPresent]{_findKey<false>(key)};
+
+            if (!isPresent)
+            {
+                throw std::out_of_range{"Element not found"};
+            }
+
+            return _value(*element);
+        }
+    #endif
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A, P>::operator[](const K_ & key) requires (!std::is_same_v<V, void>)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A, P>::operator[](K_ && key) requires (!std::is_same_v<V, void>)
+    {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::begin() -> iterator
+    {
+        return _mutableIterator(static_cast<const RawMap *>(this)->begin());
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::begin() const -> const_iterator
+    {
+        // General case
+        if (_size - _haveSpecial[0] - _haveSpecial[1]) [[likely]]
+        {
+            for (_Slot * element{_elements}; ; ++element)
+            {
+                if (_isPresent(_raw(_key(*element))))
+                {
+                    return _iterator(element);
+                }
+            }
+        }
+
+        // Special key cases
+        if (_haveSpecial[0]) [[unlikely]]
+        {
+            return _iterator(_elements + _slotN);
+        }
+        if (_haveSpecial[1]) [[unlikely]]
+        {
+            return _iterator(_elements + _slotN + 1);
+        }
+
+        return end();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline typename RawMap<K, V, H, A, P>::iterator RawMap<K, V, H, A, P>::end()
+    {
+        return iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::end() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::cend() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename Fn>
+    inline void RawMap<K, V, H, A, P>::for_each(Fn && fn)
+    {
+        _forEach<false>(fn);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename Fn>
+    inline void RawMap<K, V, H, A, P>::for_each(Fn && fn) const
+    {
+        _forEach<true>(fn);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant, typename Fn>
+    inline void RawMap<K, V, H, A, P>::_forEach(Fn && fn) const
+    {
+        using Reference = typename _Iterator<constant>::reference;
+
+        if (!_size)
+        {
+            return;
+        }
+
+        const auto visit{[this, &fn](const u64 slotI) {
+            if constexpr (_isSplit)
+            {
+                fn(Reference{_elements[slotI], _values(_elements, _slotN)[slotI]});
+            }
+            else
+            {
+                fn(static_cast<Reference>(_elements[slotI]));
+            }
+        }};
+
+        // General case
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            if constexpr (_isSimdProbable)
+            {
+                constexpr u64 laneN{_private::simd::blockSize / sizeof(_RawKey)};
+                const _RawKey * const rawKeys{reinterpret_cast<const _RawKey *>(_elements)};
+
+                // The slot count is always a multiple of the lane count
+                for (u64 blockI{0u}; blockI < _slotN; blockI += laneN)
+                {
+                    const _private::simd::Block block{_private::simd::load(rawKeys + blockI)};
+                    u32 presentMask{_private::simd::fullMask<_RawKey>() & ~(_private::simd::matchMask(block, _vacantKey) | _private::simd::matchMask(block, _graveKey))};
+
+                    while (presentMask)
+                    {
+                        visit(blockI + u64(std::countr_zero(presentMask)) / sizeof(_RawKey));
+                        presentMask &= presentMask - 1u;
+                    }
+                }
+            }
+            else
+        #endif
+        {
+            for (u64 slotI{0u}; slotI < _slotN; ++slotI)
+            {
+                if (_isPresent(_raw(_key(_elements[slotI]))))
+                {
+                    visit(slotI);
+                }
+            }
+        }
+
+        // Special keys case
+        if (_haveSpecial[0])
+        {
+            visit(_slotN);
+        }
+        if (_haveSpecial[1])
+        {
+            visit(_slotN + 1u);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto RawMap<K, V, H, A, P>::find(const K_ & key) -> iterator
+    {
+        return _mutableIterator(static_cast<const RawMap *>(this)->find(key));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto RawMap<K, V, H, A, P>::find(const K_ & key) const -> const_iterator
+    {
+        if (!_size)
+        {
+            return cend();
+        }
+
+        const auto [element, isPresent]{_findKey<false>(key)};
+        return isPresent ? _iterator(element) : cend();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::find_batch(const std::span<const K> keys, const std::span<iterator> out)
+    {
+        if (!_size)
+        {
+            for (u64 i{0u}; i < keys.size(); ++i)
+            {
+                out[i] = end();
+            }
+
+            return 0u;
+        }
+
+        u64 presentN{0u};
+
+        _findKeys(keys, [&](const u64 i, const _FindKeyResult<false> & findResult) {
+            out[i] = findResult.isPresent ? _iterator(findResult.element) : end();
+            presentN += findResult.isPresent;
+        });
+
+        return presentN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::find_batch(const std::span<const K> keys, const std::span<const_iterator> out) const
+    {
+        if (!_size)
+        {
+            for (u64 i{0u}; i < keys.size(); ++i)
+            {
+                out[i] = cend();
+            }
+
+            return 0u;
+        }
+
+        u64 presentN{0u};
+
+        _findKeys(keys, [&](const u64 i, const _FindKeyResult<false> & findResult) {
+            out[i] = findResult.isPresent ? const_iterator{_iterator(findResult.element)} : cend();
+            presentN += findResult.isPresent;
+        });
+
+        return presentN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename Fn>
+    inline void RawMap<K, V, H, A, P>::_findKeys(const std::span<const K> keys, Fn && fn) const
+    {
+        u64 slotIs[_batchWindow];
+
+        for (u64 windowI{0u}; windowI < keys.size(); windowI += _batchWindow)
+        {
+            const u64 windowN{keys.size() - windowI < _batchWindow ? keys.size() - windowI : _batchWindow};
+
+            // Compute and prefetch every slot in the window before probing any of them
+            _hashEach(keys.subspan(windowI, windowN), slotIs);
+            for (u64 i{0u}; i < windowN; ++i)
+            {
+                slotIs[i] &= _slotN - 1u;
+                _private::prefetch(_elements + slotIs[i]);
+            }
+
+            for (u64 i{0u}; i < windowN; ++i)
+            {
+                fn(windowI + i, _findKey<false>(keys[windowI + i], slotIs[i]));
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 RawMap<K, V, H, A, P>::slot(const K_ & key) const
+    {
+        if constexpr (!Rawable<K_>)
+        {
+            return slot(K(key));
+        }
+        else
+        {
+            const _RawKey & rawKey{_raw(key)};
+            if (_isSpecial(rawKey)) [[unlikely]]
+            {
+                return _slotN + (rawKey == _vacantKey);
+            }
+            else
+            {
+                return _slot(key);
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 RawMap<K, V, H, A, P>::_slot(const K_ & key) const
+    {
+        return _hashOf(key) & (_slotN - 1u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 RawMap<K, V, H, A, P>::_hashOf(const K_ & key) const
+    {
+        if constexpr (P::countOperations)
+        {
+            ++_counts.hashN;
+        }
+
+        if constexpr (!Rawable<K_>)
+        {
+            return u64{_hash(K(key))};
+        }
+        else
+        {
+            return u64{_hash(key)};
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_hashEach(const std::span<const K> keys, u64 * const hashes) const
+    {
+        if constexpr (_private::BatchHasher<H, K>)
+        {
+            _hash.hash_n(keys, std::span<u64>{hashes, keys.size()});
+
+            if constexpr (P::countOperations)
+            {
+                _counts.hashN += keys.size();
+            }
+        }
+        else
+        {
+            for (u64 i{0u}; i < keys.size(); ++i)
+            {
+                hashes[i] = _hashOf(keys[i]);
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::reserve(const u64 capacity)
+    {
+        reserve(capacity, 0u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::reserve(const u64 capacity, const u64 threadN)
+    {
+        rehash(_slotNFor(capacity, _maxLoadFactor), threadN);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::rehash(const u64 slotN)
+    {
+        rehash(slotN, 0u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::rehash(u64 slotN, const u64 threadN)
+    {
+        const u64 currentMinSlotN{_slotNFor(_size - _haveSpecial[0] - _haveSpecial[1], _maxLoadFactor)};
+        if (slotN < currentMinSlotN)
+        {
+            slotN = currentMinSlotN;
+        }
+        else
+        {
+            slotN = std::bit_ceil(slotN);
+        }
+
+        if (slotN != _slotN)
+        {
+            if (_elements)
+            {
+                _rehash(slotN, threadN);
+            }
+            else
+            {
+                _slotN = slotN;
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_rehash(const u64 slotN, u64 threadN)
+    {
+        if constexpr (P::countOperations)
+        {
+            ++_counts.rehashN;
+        }
+
+        if constexpr (_isParallelRehashable)
+        {
+            if (!threadN && P::parallelRehashSlotN && slotN >= P::parallelRehashSlotN)
+            {
+                threadN = std::thread::hardware_concurrency();
+            }
+
+            if (threadN > 1u && slotN > _slotN)
+            {
+                _rehashParallel(slotN, threadN);
+                return;
+            }
+        }
+
+        const u64 oldSize{_size};
+        const u64 oldSlotN{_slotN};
+        _Slot * const oldElements{_elements};
+        const bool oldHaveSpecial[2]{_haveSpecial[0], _haveSpecial[1]};
+
+        _size = {};
+        _graveN = {};
+        _slotN = slotN;
+        _allocate<true>();
+        _haveSpecial[0] = false;
+        _haveSpecial[1] = false;
+
+        // General case
+        u64 n{};
+        const u64 regularElementN{oldSize - oldHaveSpecial[0] - oldHaveSpecial[1]};
+        for (_Slot * element{oldElements}; n < regularElementN; ++element)
+        {
+            if (_isPresent(_raw(_key(*element))))
+            {
+                const u64 oldSlotI{u64(element - oldElements)};
+                if constexpr (_isSplit)
+                {
+                    try_emplace(std::move(*element), std::move(_values(oldElements, oldSlotN)[oldSlotI]));
+                }
+                else
+                {
+                    emplace(std::move(*element));
+                }
+                _destroy(oldElements, oldSlotN, oldSlotI);
+                ++n;
+            }
+        }
+
+        // Special keys case
+        if (oldHaveSpecial[0]) [[unlikely]]
+        {
+            _forwardElement<true>(_slotN, oldElements, oldSlotN, oldSlotN);
+            _destroy(oldElements, oldSlotN, oldSlotN);
+            ++_size;
+            _haveSpecial[0] = true;
+        }
+        if (oldHaveSpecial[1]) [[unlikely]]
+        {
+            _forwardElement<true>(_slotN + 1u, oldElements, oldSlotN, oldSlotN + 1u);
+            _destroy(oldElements, oldSlotN, oldSlotN + 1u);
+            ++_size;
+            _haveSpecial[1] = true;
+        }
+
+        std::allocator_traits<A>::deallocate(_alloc, reinterpret_cast<E *>(oldElements), _allocationN(oldSlotN));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_rehashParallel(const u64 slotN, u64 threadN)
+    {
+        const u64 oldSlotN{_slotN};
+        _Slot * const oldElements{_elements};
+        const bool oldHaveSpecial[2]{_haveSpecial[0], _haveSpecial[1]};
+        const u64 oldMask{oldSlotN - 1u};
+        const u64 newMask{slotN - 1u};
+
+        // Segments smaller than this aren't worth a thread
+        if (threadN > (oldSlotN >> 6))
+        {
+            threadN = (oldSlotN >> 6) ? (oldSlotN >> 6) : 1u;
+        }
+
+        _size = {};
+        _graveN = {};
+        _slotN = slotN;
+        _allocate<false>();
+        _raw(_key(_elements[_slotN])) = _vacantGraveKey;
+        _raw(_key(_elements[_slotN + 1u])) = _vacantVacantKey;
+        _haveSpecial[0] = false;
+        _haveSpecial[1] = false;
+
+        // Start each segment at a vacant old slot so that no probe sequence spans two segments. Indices are unwrapped,
+        // so the last segment may run past the end of the old slots and back around to where the first began
+        const std::unique_ptr<u64[]> segmentStarts{new u64[threadN + 1u]};
+        for (u64 threadI{0u}; threadI < threadN; ++threadI)
+        {
+            u64 slotI{oldSlotN * threadI / threadN};
+            while (_raw(_key(oldElements[slotI & oldMask])) != _vacantKey)
+            {
+                ++slotI;
+            }
+            segmentStarts[threadI] = slotI;
+        }
+        segmentStarts[threadN] = segmentStarts[0] + oldSlotN;
+
+        const std::unique_ptr<u64[]> movedNs{new u64[threadN]{}};
+        const std::unique_ptr<std::vector<u64>[]> deferredSlotIs{new std::vector<u64>[threadN]};
+
+        // The new slots that map back onto a segment are the segment's own, so threads never touch the same slot
+        const auto moveSegment{[&](const u64 threadI)
+        {
+            const u64 beginI{segmentStarts[threadI]};
+            const u64 endI{segmentStarts[threadI + 1u]};
+
+            for (u64 offset{0u}; offset < slotN; offset += oldSlotN)
+            {
+                for (u64 i{beginI}; i < endI; ++i)
+                {
+                    _raw(_key(_elements[(i + offset) & newMask])) = _vacantKey;
+                }
+            }
+
+            u64 movedN{0u};
+            for (u64 i{beginI}; i < endI; ++i)
+            {
+                const u64 oldSlotI{i & oldMask};
+                const _Slot & element{oldElements[oldSlotI]};
+                if (!_isPresent(_raw(_key(element))))
+                {
+                    continue;
+                }
+
+                // The element's probe sequence may only cover as many new slots as there are from its old ideal slot to
+                // the segment's end, all of which are in the segment
+                const u64 hash{_hash(_key(element))};
+                const u64 roomN{endI - i + ((oldSlotI - hash) & oldMask)};
+                u64 slotI{hash & newMask};
+                u64 probeN{0u};
+                while (probeN < roomN && _raw(_key(_elements[slotI])) != _vacantKey)
+                {
+                    slotI = (slotI + 1u) & newMask;
+                    ++probeN;
+                }
+
+                if (probeN == roomN) [[unlikely]]
+                {
+                    deferredSlotIs[threadI].push_back(oldSlotI);
+                    continue;
+                }
+
+                _forwardElement<true>(slotI, oldElements, oldSlotN, oldSlotI);
+                _destroy(oldElements, oldSlotN, oldSlotI);
+                ++movedN;
+            }
+            movedNs[threadI] = movedN;
+        }};
+
+        {
+            const std::unique_ptr<std::thread[]> threads{new std::thread[threadN - 1u]};
+            u64 startedN{1u};
+            #ifdef QC_HASH_EXCEPTIONS_ENABLED
+                // Should a thread fail to start, its segment and those after are moved on this thread instead
+                try
+                {
+            #endif
+                    for (; startedN < threadN; ++startedN)
+                    {
+                        threads[startedN - 1u] = std::thread{moveSegment, startedN};
+                    }
+            #ifdef QC_HASH_EXCEPTIONS_ENABLED
+                }
+                catch (const std::system_error &)
+                {}
+            #endif
+            for (u64 threadI{startedN}; threadI < threadN; ++threadI)
+            {
+                moveSegment(threadI);
+            }
+            moveSegment(0u);
+            for (u64 threadI{1u}; threadI < startedN; ++threadI)
+            {
+                threads[threadI - 1u].join();
+            }
+        }
+
+        // Place the elements whose probe sequences overflowed their segment now that all segments are done
+        for (u64 threadI{0u}; threadI < threadN; ++threadI)
+        {
+            _size += movedNs[threadI];
+
+            // Each thread hashed every element of its segment, deferred or not
+            if constexpr (P::countOperations)
+            {
+                _counts.hashN += movedNs[threadI] + deferredSlotIs[threadI].size();
+            }
+
+            for (const u64 oldSlotI : deferredSlotIs[threadI])
+            {
+                u64 slotI{_slot(_key(oldElements[oldSlotI]))};
+                while (_raw(_key(_elements[slotI])) != _vacantKey)
+                {
+                    slotI = (slotI + 1u) & newMask;
+                }
+
+                _forwardElement<true>(slotI, oldElements, oldSlotN, oldSlotI);
+                _destroy(oldElements, oldSlotN, oldSlotI);
+                ++_size;
+            }
+        }
+
+        // Special keys case
+        if (oldHaveSpecial[0]) [[unlikely]]
+        {
+            _forwardElement<true>(_slotN, oldElements, oldSlotN, oldSlotN);
+            _destroy(oldElements, oldSlotN, oldSlotN);
+            ++_size;
+            _haveSpecial[0] = true;
+        }
+        if (oldHaveSpecial[1]) [[unlikely]]
+        {
+            _forwardElement<true>(_slotN + 1u, oldElements, oldSlotN, oldSlotN + 1u);
+            _destroy(oldElements, oldSlotN, oldSlotN + 1u);
+            ++_size;
+            _haveSpecial[1] = true;
+        }
+
+        std::allocator_traits<A>::deallocate(_alloc, reinterpret_cast<E *>(oldElements), _allocationN(oldSlotN));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::swap(RawMap & other)
+    {
+        std::swap(_size, other._size);
+        std::swap(_graveN, other._graveN);
+        std::swap(_slotN, other._slotN);
+        std::swap(_elements, other._elements);
+        std::swap(_haveSpecial, other._haveSpecial);
+        std::swap(_hash, other._hash);
+        std::swap(_maxLoadFactor, other._maxLoadFactor);
+        if constexpr (std::allocator_traits<A>::propagate_on_container_swap::value)
+        {
+            std::swap(_alloc, other._alloc);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::size() const
+    {
+        return _size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::grave_n() const
+    {
+        return _graveN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline RawStats RawMap<K, V, H, A, P>::stats() const
+    {
+        RawStats stats{};
+        stats.graveN = _graveN;
+        stats.specialN = u64{_haveSpecial[0]} + u64{_haveSpecial[1]};
+
+        if constexpr (P::countOperations)
+        {
+            stats.hashN = _counts.hashN;
+            stats.lookupN = _counts.lookupN;
+            stats.probeN = _counts.probeN;
+            stats.rehashN = _counts.rehashN;
+        }
+
+        if (!_elements)
+        {
+            return stats;
+        }
+
+        const u64 slotMask{_slotN - 1u};
+
+        u64 displacementSum{0u};
+        for (u64 slotI{0u}; slotI < _slotN; ++slotI)
+        {
+            const K & key{_key(_elements[slotI])};
+            if (_isPresent(_raw(key)))
+            {
+                const u64 displacement{(slotI - u64{_hash(key)}) & slotMask};
+                if (displacement >= stats.probeLengths.size())
+                {
+                    stats.probeLengths.resize(displacement + 1u);
+                }
+                ++stats.probeLengths[displacement];
+                displacementSum += displacement;
+            }
+        }
+
+        const u64 normalN{_size - stats.specialN};
+        stats.meanDisplacement = normalN ? f64(displacementSum) / f64(normalN) : 0.0;
+        stats.maxDisplacement = stats.probeLengths.empty() ? 0u : stats.probeLengths.size() - 1u;
+
+        // Start from a vacant slot, of which there is always at least one, so that no cluster is split by the wrap around
+        u64 vacantI{0u};
+        while (_raw(_key(_elements[vacantI])) != _vacantKey)
+        {
+            ++vacantI;
+        }
+
+        u64 clusterN{0u};
+        for (u64 i{1u}; i <= _slotN; ++i)
+        {
+            if (_raw(_key(_elements[(vacantI + i) & slotMask])) == _vacantKey)
+            {
+                clusterN = 0u;
+            }
+            else if (++clusterN > stats.largestCluster)
+            {
+                stats.largestCluster = clusterN;
+            }
+        }
+
+        return stats;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool RawMap<K, V, H, A, P>::empty() const
+    {
+        return !_size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::capacity() const
+    {
+        return _capacityFor(_slotN, _maxLoadFactor);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::slot_n() const
+    {
+        return _slotN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::max_size() const
+    {
+        return _capacityFor(max_slot_n(), _maxLoadFactor) + 2u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::max_slot_n() const
+    {
+        return u64{1u} << 63;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline f32 RawMap<K, V, H, A, P>::load_factor() const
+    {
+        return f32(_size) / f32(_slotN);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline f32 RawMap<K, V, H, A, P>::max_load_factor() const
+    {
+        return _maxLoadFactor;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::max_load_factor(const f32 maxLoadFactor)
+    {
+        _maxLoadFactor = maxLoadFactor;
+
+        // Grows only if the current elements no longer fit
+        rehash(_slotN);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const H & RawMap<K, V, H, A, P>::hash_function() const
+    {
+        return _hash;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const A & RawMap<K, V, H, A, P>::get_allocator() const
+    {
+        return _alloc;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool RawMap<K, V, H, A, P>::save(const char * const path) const requires (_private::Snapshottable<K, V>)
+    {
+        std::FILE * const file{std::fopen(path, "wb")};
+        if (!file)
+        {
+            return false;
+        }
+
+        _private::SnapshotHeader header{
+            .magic = _private::snapshotMagic,
+            .version = _private::snapshotVersion,
+            .isSplit = _isSplit,
+            .keySize = sizeof(K),
+            .valueSize = _isSet ? 0u : sizeof(std::conditional_t<_isSet, u8, V>),
+            .elementSize = sizeof(E),
+            .slotN = _slotN,
+            .size = _size,
+            .graveN = _size ? _graveN : 0u,
+            .hashFingerprint = _hashFingerprint(_hash),
+            .maxLoadFactor = _maxLoadFactor,
+            .haveSpecial = {_haveSpecial[0], _haveSpecial[1]},
+            .isRobinHood = P::robinHood};
+
+        // Pad the header out so the slot array is aligned
+        std::byte headerBytes[_private::snapshotDataOffset]{};
+        std::memcpy(headerBytes, &header, sizeof(header));
+
+        bool success{std::fwrite(headerBytes, sizeof(headerBytes), 1u, file) == 1u};
+        if (_size && success)
+        {
+            success = std::fwrite(_elements, sizeof(E), _allocationN(_slotN), file) == _allocationN(_slotN);
+        }
+
+        return (std::fclose(file) == 0) && success;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::load(const char * const path, const H & hash, const A & alloc) -> std::optional<RawMap> requires (_private::Snapshottable<K, V>)
+    {
+        std::FILE * const file{std::fopen(path, "rb")};
+        if (!file)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<RawMap> map{};
+        _private::SnapshotHeader header;
+        if (std::fread(&header, sizeof(header), 1u, file) == 1u)
+        {
+            if (const std::optional<u64> dataSize{_checkSnapshot(header, hash)})
+            {
+                map.emplace(minMapCapacity, hash, alloc);
+                map->_restoreSnapshot(header);
+
+                if (*dataSize)
+                {
+                    map->template _allocate<false>();
+                    const bool success{
+                        std::fseek(file, long(_private::snapshotDataOffset), SEEK_SET) == 0 &&
+                        std::fread(map->_elements, 1u, *dataSize, file) == *dataSize &&
+                        std::fgetc(file) == EOF &&
+                        _checkSnapshotSentinels(map->_elements, header)};
+                    if (!success)
+                    {
+                        map->_deallocate();
+                        map.reset();
+                    }
+                }
+            }
+        }
+
+        std::fclose(file);
+        return map;
+    }
+
+    #ifdef QC_HASH_MMAP_ENABLED
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline auto RawMap<K, V, H, A, P>::view(const char * const path, const H & hash) -> std::optional<RawMapView<K, V, H, A, P>> requires (_private::Snapshottable<K, V>)
+        {
+            const int fd{::open(path, O_RDONLY)};
+            if (fd < 0)
+            {
+                return std::nullopt;
+            }
+
+            struct ::stat fileStat;
+            void * mapping{MAP_FAILED};
+            if (::fstat(fd, &fileStat) == 0 && u64(fileStat.st_size) >= _private::snapshotDataOffset)
+            {
+                mapping = ::mmap(nullptr, u64(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            ::close(fd);
+
+            if (mapping == MAP_FAILED)
+            {
+                return std::nullopt;
+            }
+
+            std::optional<RawMapView<K, V, H, A, P>> view{RawMapView<K, V, H, A, P>{hash}};
+            view->_mapping = mapping;
+            view->_mappingSize = u64(fileStat.st_size);
+
+            _private::SnapshotHeader header;
+            std::memcpy(&header, mapping, sizeof(header));
+            const std::optional<u64> dataSize{_checkSnapshot(header, hash)};
+            if (!dataSize || _private::snapshotDataOffset + *dataSize != u64(fileStat.st_size))
+            {
+                return std::nullopt;
+            }
+
+            if (*dataSize)
+            {
+                _Slot * const elements{reinterpret_cast<_Slot *>(static_cast<std::byte *>(mapping) + _private::snapshotDataOffset)};
+                if (!_checkSnapshotSentinels(elements, header))
+                {
+                    return std::nullopt;
+                }
+
+                view->_map._elements = elements;
+            }
+            view->_map._restoreSnapshot(header);
+
+            return view;
+        }
+    #endif
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline FrozenRawMap<K, V, H, A> RawMap<K, V, H, A, P>::freeze() const &
+    {
+        return FrozenRawMap<K, V, H, A>{*this};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline FrozenRawMap<K, V, H, A> RawMap<K, V, H, A, P>::freeze() &&
+    {
+        return FrozenRawMap<K, V, H, A>{std::move(*this)};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_hashFingerprint(const H & hash)
+    {
+        u64 fingerprint{0u};
+        for (u64 i{1u}; i <= 4u; ++i)
+        {
+            const _RawKey rawKey{_RawKey(i * 0x9E3779B97F4A7C15u)};
+            fingerprint = fastHash::mix(fingerprint ^ u64{hash(std::bit_cast<K>(rawKey))});
+        }
+
+        return fingerprint;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline std::optional<u64> RawMap<K, V, H, A, P>::_checkSnapshot(const _private::SnapshotHeader & header, const H & hash)
+    {
+        const bool matches{
+            header.magic == _private::snapshotMagic &&
+            header.version == _private::snapshotVersion &&
+            header.isSplit == _isSplit &&
+            // Robin Hood lookups stop early, so they can't probe a table laid out otherwise, and vice versa
+            header.isRobinHood == P::robinHood &&
+            header.keySize == sizeof(K) &&
+            header.valueSize == (_isSet ? 0u : sizeof(std::conditional_t<_isSet, u8, V>)) &&
+            header.elementSize == sizeof(E) &&
+            header.hashFingerprint == _hashFingerprint(hash) &&
+            header.maxLoadFactor > 0.0f && header.maxLoadFactor <= 1.0f &&
+            std::has_single_bit(header.slotN) &&
+            header.slotN <= _maxSnapshotSlotN &&
+            // No fewer slots than `_slotNFor` ever gives, else probing a SIMD block would run off the end
+            _capacityFor(header.slotN, header.maxLoadFactor) >= minMapCapacity &&
+            header.haveSpecial[0] <= 1u && header.haveSpecial[1] <= 1u &&
+            header.size >= u64{header.haveSpecial[0]} + u64{header.haveSpecial[1]}};
+        if (!matches)
+        {
+            return std::nullopt;
+        }
+
+        // The regular elements must fit the capacity and, with the graves, leave a vacant slot, else probing never ends
+        const u64 regularSize{header.size - u64{header.haveSpecial[0]} - u64{header.haveSpecial[1]}};
+        const u64 graveN{header.size ? header.graveN : 0u};
+        if (regularSize > _capacityFor(header.slotN, header.maxLoadFactor) || graveN >= header.slotN - regularSize)
+        {
+            return std::nullopt;
+        }
+
+        // Backward shift erasure never expects graves, so it would never skip or purge them
+        if (_isBackwardShift && graveN)
+        {
+            return std::nullopt;
+        }
+
+        // An empty map/set may have been saved before anything was allocated
+        return header.size ? _allocationN(header.slotN) * sizeof(E) : 0u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool RawMap<K, V, H, A, P>::_checkSnapshotSentinels(const _Slot * const elements, const _private::SnapshotHeader & header)
+    {
+        const _Slot * const specialElements{elements + header.slotN};
+        return
+            _raw(_key(specialElements[0])) == (header.haveSpecial[0] ? _specialKeys[0] : _vacantSpecialKeys[0]) &&
+            _raw(_key(specialElements[1])) == (header.haveSpecial[1] ? _specialKeys[1] : _vacantSpecialKeys[1]) &&
+            _raw(_key(specialElements[2])) == _terminalKey &&
+            _raw(_key(specialElements[3])) == _terminalKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_restoreSnapshot(const _private::SnapshotHeader & header)
+    {
+        _size = header.size;
+        _graveN = header.size ? header.graveN : 0u;
+        _slotN = header.slotN;
+        _haveSpecial[0] = header.haveSpecial[0];
+        _haveSpecial[1] = header.haveSpecial[1];
+        _maxLoadFactor = header.maxLoadFactor;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline K & RawMap<K, V, H, A, P>::_key(_Slot & element)
+    {
+        if constexpr (_isSet || _isSplit) return element;
+        else return element.first;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const K & RawMap<K, V, H, A, P>::_key(const _Slot & element)
+    {
+        if constexpr (_isSet || _isSplit) return element;
+        else return element.first;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_valuesOffset(const u64 slotN)
+    {
+        // Values follow all the keys, including the special and terminal keys
+        constexpr u64 alignMask{alignof(V) - 1u};
+        return ((slotN + 4u) * sizeof(K) + alignMask) & ~alignMask;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline V * RawMap<K, V, H, A, P>::_values(const _Slot * const elements, const u64 slotN)
+    {
+        return reinterpret_cast<V *>(const_cast<std::byte *>(reinterpret_cast<const std::byte *>(elements)) + _valuesOffset(slotN));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_allocationN(const u64 slotN)
+    {
+        if constexpr (_isSplit)
+        {
+            // Terminal slots have no values
+            const u64 byteN{_valuesOffset(slotN) + (slotN + 2u) * sizeof(V)};
+            return (byteN + sizeof(E) - 1u) / sizeof(E);
+        }
+        else
+        {
+            return slotN + 4u;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_capacityFor(const u64 slotN, const f32 maxLoadFactor)
+    {
+        // Always leave at least one vacant slot so probing is guaranteed to terminate
+        const u64 capacity{u64(f64(slotN) * f64(maxLoadFactor))};
+        return capacity < slotN ? capacity : slotN - 1u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 RawMap<K, V, H, A, P>::_slotNFor(u64 capacity, const f32 maxLoadFactor)
+    {
+        if (capacity < minMapCapacity)
+        {
+            capacity = minMapCapacity;
+        }
+
+        u64 slotN{std::bit_ceil(u64(f64(capacity) / f64(maxLoadFactor)))};
+
+        // Account for rounding and the reserved vacant slot
+        while (_capacityFor(slotN, maxLoadFactor) < capacity)
+        {
+            slotN <<= 1;
+        }
+
+        return slotN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool RawMap<K, V, H, A, P>::_isPresent(const _RawKey & key)
+    {
+        return !_isSpecial(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool RawMap<K, V, H, A, P>::_isSpecial(const _RawKey & key)
+    {
+        return key == _vacantKey || key == _graveKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool zeroKeys>
+    inline void RawMap<K, V, H, A, P>::_allocate()
+    {
+        _elements = reinterpret_cast<_Slot *>(std::allocator_traits<A>::allocate(_alloc, _allocationN(_slotN)));
+
+        if constexpr (zeroKeys)
+        {
+            _clearKeys();
+        }
+
+        // Set the trailing keys to special terminal values so iterators know when to stop
+        _raw(_key(_elements[_slotN + 2])) = _terminalKey;
+        _raw(_key(_elements[_slotN + 3])) = _terminalKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_deallocate()
+    {
+        std::allocator_traits<A>::deallocate(_alloc, reinterpret_cast<E *>(_elements), _allocationN(_slotN));
+        _elements = nullptr;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_clearKeys()
+    {
+        // General case
+        _Slot * const specialElements{_elements + _slotN};
+        for (_Slot * element{_elements}; element < specialElements; ++element)
+        {
+            _raw(_key(*element)) = _vacantKey;
+        }
+
+        // Special key case
+        _raw(_key(specialElements[0])) = _vacantGraveKey;
+        _raw(_key(specialElements[1])) = _vacantVacantKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool move>
+    inline void RawMap<K, V, H, A, P>::_forwardData(std::conditional_t<move, RawMap, const RawMap> & other)
+    {
+        if constexpr (std::is_trivially_copyable_v<E>)
+        {
+            std::memcpy(_elements, other._elements, (_slotN + 2u) * sizeof(E));
+        }
+        else if constexpr (_isSplit && std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>)
+        {
+            std::memcpy(_elements, other._elements, _allocationN(_slotN) * sizeof(E));
+        }
+        else
+        {
+            // General case
+            for (u64 slotI{0u}; slotI < _slotN; ++slotI)
+            {
+                const _RawKey & rawSrcKey{_raw(_key(other._elements[slotI]))};
+                if (_isPresent(rawSrcKey))
+                {
+                    _forwardElement<move>(slotI, other._elements, _slotN, slotI);
+                }
+                else
+                {
+                    _raw(_key(_elements[slotI])) = rawSrcKey;
+                }
+            }
+
+            // Special keys case
+            if (_haveSpecial[0])
+            {
+                _forwardElement<move>(_slotN, other._elements, _slotN, _slotN);
+            }
+            else
+            {
+                _raw(_key(_elements[_slotN])) = _vacantGraveKey;
+            }
+            if (_haveSpecial[1])
+            {
+                _forwardElement<move>(_slotN + 1u, other._elements, _slotN, _slotN + 1u);
+            }
+            else
+            {
+                _raw(_key(_elements[_slotN + 1])) = _vacantVacantKey;
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A, P>::_value(const _Slot & element) const
+    {
+        if constexpr (_isSplit)
+        {
+            return _values(_elements, _slotN)[&element - _elements];
+        }
+        else
+        {
+            return const_cast<V &>(element.second);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_destroy(_Slot * const elements, const u64 slotN, const u64 slotI)
+    {
+        std::allocator_traits<A>::destroy(_alloc, elements + slotI);
+
+        if constexpr (_isSplit)
+        {
+            std::allocator_traits<A>::destroy(_alloc, _values(elements, slotN) + slotI);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void RawMap<K, V, H, A, P>::_destroy(_Slot * const element)
+    {
+        _destroy(_elements, _slotN, u64(element - _elements));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool move>
+    inline void RawMap<K, V, H, A, P>::_forwardElement(const u64 slotI, std::conditional_t<move, _Slot, const _Slot> * const srcElements, const u64 srcSlotN, const u64 srcSlotI)
+    {
+        using SlotForwardType = std::conditional_t<move, _Slot &&, const _Slot &>;
+
+        std::allocator_traits<A>::construct(_alloc, _elements + slotI, static_cast<SlotForwardType>(srcElements[srcSlotI]));
+
+        if constexpr (_isSplit)
+        {
+            using ValueForwardType = std::conditional_t<move, V &&, const V &>;
+
+            std::allocator_traits<A>::construct(_alloc, _values(_elements, _slotN) + slotI, static_cast<ValueForwardType>(_values(srcElements, srcSlotN)[srcSlotI]));
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::_iterator(_Slot * const element) const -> iterator
+    {
+        if constexpr (_isSplit)
+        {
+            return iterator{element, _values(_elements, _slotN) + (element - _elements)};
+        }
+        else
+        {
+            return iterator{element};
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto RawMap<K, V, H, A, P>::_mutableIterator(const const_iterator & it) -> iterator
+    {
+        iterator result{const_cast<_Slot *>(it._element)};
+
+        if constexpr (_isSplit)
+        {
+            result._value = const_cast<V *>(it._value);
+        }
+
+        return result;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool insertionForm, Compatible<K> K_>
+    inline auto RawMap<K, V, H, A, P>::_findKey(const K_ & key) const -> _FindKeyResult<insertionForm>
+    {
+        // A plain float is canonicalized just once
+        if constexpr (!Rawable<K_>)
+        {
+            return _findKey<insertionForm>(K(key));
+        }
+        else
+        {
+            return _findKey<insertionForm>(key, _slot(key));
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool insertionForm, Compatible<K> K_>
+    inline auto RawMap<K, V, H, A, P>::_findKey(const K_ & key, const u64 slotI) const -> _FindKeyResult<insertionForm>
+    {
+        if constexpr (!Rawable<K_>)
+        {
+            return _findKey<insertionForm>(K(key), slotI);
+        }
+        else
+        {
+            const _RawKey & rawKey{_raw(key)};
+
+            // Special key case
+            if (_isSpecial(rawKey)) [[unlikely]]
+            {
+                const unsigned char specialI{rawKey == _vacantKey};
+                if constexpr (insertionForm)
+                {
+                    return _FindKeyResult<insertionForm>{.element = _elements + _slotN + specialI, .isPresent = _haveSpecial[specialI], .isSpecial = true, .specialI = specialI};
+                }
+                else
+                {
+                    return _FindKeyResult<insertionForm>{.element = _elements + _slotN + specialI, .isPresent = _haveSpecial[specialI]};
+                }
+            }
+
+            // General case
+
+            const _FindKeyResult<insertionForm> findResult{_findNormalKey<insertionForm>(rawKey, slotI)};
+
+            // An insertion's probes run on past any grave it returns, so only plain lookups are counted
+            if constexpr (P::countOperations && !insertionForm)
+            {
+                ++_counts.lookupN;
+                _counts.probeN += ((u64(findResult.element - _elements) - slotI) & (_slotN - 1u)) + 1u;
+            }
+
+            return findResult;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool insertionForm>
+    inline auto RawMap<K, V, H, A, P>::_findNormalKey(const _RawKey rawKey, const u64 slotI) const -> _FindKeyResult<insertionForm>
+    {
+        if constexpr (P::robinHood)
+        {
+            return _findKeyRobinHood<insertionForm>(rawKey, slotI);
+        }
+        else
+        #ifdef QC_HASH_SSE2_ENABLED
+            if constexpr (_isSimdProbable)
+            {
+                return _findKeySimd<insertionForm>(rawKey, slotI);
+            }
+            else
+        #endif
+        {
+            const _Slot * const lastElement{_elements + _slotN};
+
+            _Slot * element{_elements + slotI};
+            _Slot * grave{};
+
+            while (true)
+            {
+                const _RawKey & rawSlotKey{_raw(_key(*element))};
+
+                if (rawSlotKey == rawKey)
+                {
+                    if constexpr (insertionForm)
+                    {
+                        return {.element = element, .isPresent = true, .isSpecial = false, .specialI = 0u};
+                    }
+                    else
+                    {
+                        return {.element = element, .isPresent = true};
+                    }
+                }
+
+                if (rawSlotKey == _vacantKey)
+                {
+                    if constexpr (insertionForm)
+                    {
+                        return {.element = grave ? grave : element, .isPresent = false, .isSpecial = false, .specialI = 0u};
+                    }
+                    else
+                    {
+                        return {.element = element, .isPresent = false};
+                    }
+                }
+
+                if constexpr (insertionForm)
+                {
+                    // Reuse the earliest grave to keep the probe sequence short
+                    if (rawSlotKey == _graveKey && !grave)
+                    {
+                        grave = element;
+                    }
+                }
+
+                ++element;
+                if (element == lastElement) [[unlikely]]
+                {
+                    element = _elements;
+                }
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool insertionForm>
+    inline auto RawMap<K, V, H, A, P>::_findKeyRobinHood(const _RawKey rawKey, u64 slotI) const -> _FindKeyResult<insertionForm>
+    {
+        const u64 slotMask{_slotN - 1u};
+
+        for (u64 dist{0u}; ; ++dist, slotI = (slotI + 1u) & slotMask)
+        {
+            _Slot * const element{_elements + slotI};
+            const _RawKey & rawSlotKey{_raw(_key(*element))};
+
+            if (rawSlotKey == rawKey)
+            {
+                if constexpr (insertionForm)
+                {
+                    return {.element = element, .isPresent = true, .isSpecial = false, .specialI = 0u};
+                }
+                else
+                {
+                    return {.element = element, .isPresent = true};
+                }
+            }
+
+            // Had the key been present, it would have displaced any element closer to its ideal slot
+            if (rawSlotKey == _vacantKey || ((slotI - _slot(_key(*element))) & slotMask) < dist)
+            {
+                if constexpr (insertionForm)
+                {
+                    return {.element = element, .isPresent = false, .isSpecial = false, .specialI = 0u};
+                }
+                else
+                {
+                    return {.element = element, .isPresent = false};
+                }
+            }
+        }
+    }
+
+    #ifdef QC_HASH_SSE2_ENABLED
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        template <bool insertionForm>
+        inline auto RawMap<K, V, H, A, P>::_findKeySimd(const _RawKey rawKey, u64 slotI) const -> _FindKeyResult<insertionForm>
+        {
+            constexpr u64 laneN{_private::simd::blockSize / sizeof(_RawKey)};
+
+            const _RawKey * const rawKeys{reinterpret_cast<const _RawKey *>(_elements)};
+            _Slot * grave{};
+
+            // Most keys are found in, or are absent from, their ideal slot, so check it alone first
+            {
+                const _RawKey rawSlotKey{rawKeys[slotI]};
+
+                if (rawSlotKey == rawKey)
+                {
+                    if constexpr (insertionForm)
+                    {
+                        return {.element = _elements + slotI, .isPresent = true, .isSpecial = false, .specialI = 0u};
+                    }
+                    else
+                    {
+                        return {.element = _elements + slotI, .isPresent = true};
+                    }
+                }
+
+                if (rawSlotKey == _vacantKey)
+                {
+                    if constexpr (insertionForm)
+                    {
+                        return {.element = _elements + slotI, .isPresent = false, .isSpecial = false, .specialI = 0u};
+                    }
+                    else
+                    {
+                        return {.element = _elements + slotI, .isPresent = false};
+                    }
+                }
+
+                if constexpr (insertionForm)
+                {
+                    if (rawSlotKey == _graveKey)
+                    {
+                        grave = _elements + slotI;
+                    }
+                }
+
+                slotI = (slotI + 1u) & (_slotN - 1u);
+            }
+
+            while (true)
+            {
+                // Never read past the normal slots; instead shift the block back and ignore the lanes before `slotI`
+                const u64 blockI{slotI + laneN <= _slotN ? slotI : _slotN - laneN};
+                const u32 ignoreMask{~u32{} << ((slotI - blockI) * sizeof(_RawKey))};
+
+                const _private::simd::Block block{_private::simd::load(rawKeys + blockI)};
+                const u32 keyMask{_private::simd::matchMask(block, rawKey) & ignoreMask};
+                const u32 stopMask{keyMask | (_private::simd::matchMask(block, _vacantKey) & ignoreMask)};
+                const u32 firstStopMask{stopMask & (0u - stopMask)};
+
+                if constexpr (insertionForm)
+                {
+                    // Only the first grave before the stop matters
+                    if (!grave)
+                    {
+                        const u32 graveMask{_private::simd::matchMask(block, _graveKey) & ignoreMask & (firstStopMask - 1u)};
+                        if (graveMask)
+                        {
+                            grave = _elements + blockI + u64(std::countr_zero(graveMask)) / sizeof(_RawKey);
+                        }
+                    }
+                }
+
+                if (stopMask)
+                {
+                    _Slot * const element{_elements + blockI + u64(std::countr_zero(stopMask)) / sizeof(_RawKey)};
+
+                    if (keyMask & firstStopMask)
+                    {
+                        if constexpr (insertionForm)
+                        {
+                            return {.element = element, .isPresent = true, .isSpecial = false, .specialI = 0u};
+                        }
+                        else
+                        {
+                            return {.element = element, .isPresent = true};
+                        }
+                    }
+                    else
+                    {
+                        if constexpr (insertionForm)
+                        {
+                            return {.element = grave ? grave : element, .isPresent = false, .isSpecial = false, .specialI = 0u};
+                        }
+                        else
+                        {
+                            return {.element = element, .isPresent = false};
+                        }
+                    }
+                }
+
+                slotI = blockI + laneN;
+                if (slotI == _slotN) [[unlikely]]
+                {
+                    slotI = 0u;
+                }
+            }
+        }
+    #endif
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool operator==(const RawMap<K, V, H, A, P> & m1, const RawMap<K, V, H, A, P> & m2)
+    {
+        if (m1.size() != m2.size())
+        {
+            return false;
+        }
+
+        if (&m1 == &m2)
+        {
+            return true;
+        }
+
+        const auto endIt{m2.cend()};
+
+        for (const auto & element : m1)
+        {
+            if constexpr (std::is_same_v<V, void>)
+            {
+                if (!m2.contains(element))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                const auto it{m2.find(element.first)};
+                if (it == endIt || it->second != element.second)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_> requires (constant && !constant_)
+    inline constexpr RawMap<K, V, H, A, P>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other):
+        _element{other._element}
+    {
+        if constexpr (_isSplit)
+        {
+            this->_value = other._value;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline constexpr RawMap<K, V, H, A, P>::_Iterator<constant>::_Iterator(_Slot * const element) :
+        _element{element}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline constexpr RawMap<K, V, H, A, P>::_Iterator<constant>::_Iterator(_Slot * const element, _Value * const value) requires (_isSplit) :
+        _private::IteratorValue<_Value>{value},
+        _element{element}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_> requires (constant && !constant_)
+    inline auto RawMap<K, V, H, A, P>::_Iterator<constant>::operator=(const _Iterator<constant_> & other) -> _Iterator &
+    {
+        _element = other._element;
+
+        if constexpr (_isSplit)
+        {
+            this->_value = other._value;
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto RawMap<K, V, H, A, P>::_Iterator<constant>::operator*() const -> reference
+    {
+        if constexpr (_isSplit)
+        {
+            return reference{*_element, *this->_value};
+        }
+        else
+        {
+            return *_element;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto RawMap<K, V, H, A, P>::_Iterator<constant>::operator->() const -> pointer
+    {
+        if constexpr (_isSplit)
+        {
+            return pointer{**this};
+        }
+        else
+        {
+            return _element;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto RawMap<K, V, H, A, P>::_Iterator<constant>::operator++() -> _Iterator &
+    {
+        if constexpr (_isSplit)
+        {
+            // Advance the value in step with the key
+            _Slot * const prevElement{_element};
+            _advance();
+            if (_element)
+            {
+                this->_value += _element - prevElement;
+            }
+            return *this;
+        }
+        else
+        {
+            _advance();
+            return *this;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline void RawMap<K, V, H, A, P>::_Iterator<constant>::_advance()
+    {
+        while (true)
+        {
+            ++_element;
+            const _RawKey & rawKey{_raw(_key(*_element))};
+
+            // Either general present case or terminal case
+            if (_isPresent(rawKey))
+            {
+                if (rawKey == _terminalKey) [[unlikely]]
+                {
+                    // Terminal case
+                    if (_raw(_key(_element[1])) == _terminalKey)
+                    {
+                        _element = nullptr;
+                    }
+                }
+
+                return;
+            }
+
+            // Either general absent case with terminal two ahead or special case
+            if (_raw(_key(_element[2])) == _terminalKey) [[unlikely]]
+            {
+                // At second special slot
+                if (_raw(_key(_element[1])) == _terminalKey) [[unlikely]]
+                {
+                    if (rawKey == _vacantVacantKey) [[likely]]
+                    {
+                        _element = nullptr;
+                    }
+
+                    return;
+                }
+
+                // At first special slot
+                if (_raw(_key(_element[3])) == _terminalKey) [[likely]]
+                {
+                    if (rawKey == _vacantGraveKey) [[likely]]
+                    {
+                        if (_raw(_key(_element[1])) == _vacantVacantKey) [[likely]]
+                        {
+                            _element = nullptr;
+                        }
+                        else
+                        {
+                            ++_element;
+                        }
+                    }
+
+                    return;
+                }
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto RawMap<K, V, H, A, P>::_Iterator<constant>::operator++(int) -> _Iterator
+    {
+        const _Iterator temp{*this};
+        operator++();
+        return temp;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_>
+    inline bool RawMap<K, V, H, A, P>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
+    {
+        return _element == other._element;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline ConcurrentRawMap<K, V, H, A>::ConcurrentRawMap(const u64 capacity, const H & hash, const A & alloc) :
+        _table{},
+        _stripes{},
+        _hash{hash},
+        _alloc{alloc}
+    {
+        _table.store(reinterpret_cast<u64>(_allocate(_slotNFor(capacity))), std::memory_order_release);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline ConcurrentRawMap<K, V, H, A>::~ConcurrentRawMap()
+    {
+        const u64 tagged{_table.load(std::memory_order_acquire)};
+        _deallocate(reinterpret_cast<_Table *>(tagged - (tagged & 1u)));
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::insert(const K & key) requires (_isSet)
+    {
+        return _insert<false>(key, nullptr);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::insert(const K & key, const _Value & value) requires (_isMap)
+    {
+        return _insert<false>(key, &value);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::insert_or_assign(const K & key, const _Value & value) requires (_isMap)
+    {
+        return _insert<true>(key, &value);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <bool assign>
+    inline bool ConcurrentRawMap<K, V, H, A>::_insert(const K & key, const _Value * const value)
+    {
+        const _RawKey rawKey{_raw(key)};
+
+        while (true)
+        {
+            const _Registration registration{_registerWriter()};
+            _Table & table{*registration.table};
+
+            if (_isSpecial(rawKey)) [[unlikely]]
+            {
+                const bool inserted{_insertSpecial<assign>(table.slots[table.slotN + (rawKey == _vacantKey)], rawKey, value)};
+                _unregister(registration);
+                return inserted;
+            }
+
+            u64 slotI;
+            const _ClaimResult result{_claim(table, rawKey, slotI)};
+
+            if (result == _ClaimResult::full) [[unlikely]]
+            {
+                _rehash(registration);
+                continue;
+            }
+
+            if constexpr (_isMap)
+            {
+                _Slot & slot{table.slots[slotI]};
+
+                if (result == _ClaimResult::inserted)
+                {
+                    slot.value.store(*value, std::memory_order_relaxed);
+                    slot.state.store(_publishedState, std::memory_order_release);
+                }
+                else if constexpr (assign)
+                {
+                    // Let a racing insertion publish its value first so it does not overwrite ours
+                    while (slot.state.load(std::memory_order_acquire) != _publishedState)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    slot.value.store(*value, std::memory_order_release);
+                }
+            }
+
+            _unregister(registration);
+            return result == _ClaimResult::inserted;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <bool assign>
+    inline bool ConcurrentRawMap<K, V, H, A>::_insertSpecial(_Slot & slot, const _RawKey rawKey, const _Value * const value)
+    {
+        if constexpr (_isSet)
+        {
+            // The special slot holds the other special key while absent
+            _RawKey expected{rawKey == _vacantKey ? _graveKey : _vacantKey};
+            return slot.compare_exchange_strong(expected, rawKey, std::memory_order_acq_rel);
+        }
+        else
+        {
+            while (true)
+            {
+                u8 state{_absentState};
+                if (slot.state.compare_exchange_strong(state, _insertingState, std::memory_order_acquire))
+                {
+                    slot.value.store(*value, std::memory_order_relaxed);
+                    slot.state.store(_publishedState, std::memory_order_release);
+                    return true;
+                }
+
+                if constexpr (!assign)
+                {
+                    return false;
+                }
+                else if (state == _publishedState)
+                {
+                    // Lock the slot so a racing erasure and reinsertion cannot be overwritten
+                    if (slot.state.compare_exchange_strong(state, _assigningState, std::memory_order_acquire))
+                    {
+                        slot.value.store(*value, std::memory_order_relaxed);
+                        slot.state.store(_publishedState, std::memory_order_release);
+                        return false;
+                    }
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::contains(const K & key) const
+    {
+        const _Registration registration{_register<false>()};
+        const bool isPresent{_find(*registration.table, _raw(key)) != nullptr};
+        _unregister(registration);
+        return isPresent;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline std::optional<V> ConcurrentRawMap<K, V, H, A>::find(const K & key) const requires (_isMap)
+    {
+        const _Registration registration{_register<false>()};
+        std::optional<V> value{};
+        if (const _Slot * const slot{_find(*registration.table, _raw(key))})
+        {
+            value = slot->value.load(std::memory_order_acquire);
+        }
+        _unregister(registration);
+        return value;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::erase(const K & key)
+    {
+        const _RawKey rawKey{_raw(key)};
+        const _Registration registration{_registerWriter()};
+        _Table & table{*registration.table};
+        bool erased{false};
+
+        if (_isSpecial(rawKey)) [[unlikely]]
+        {
+            _Slot & slot{table.slots[table.slotN + (rawKey == _vacantKey)]};
+
+            if constexpr (_isSet)
+            {
+                _RawKey expected{rawKey};
+                erased = slot.compare_exchange_strong(expected, rawKey == _vacantKey ? _graveKey : _vacantKey, std::memory_order_acq_rel);
+            }
+            else
+            {
+                while (true)
+                {
+                    u8 state{_publishedState};
+                    if (slot.state.compare_exchange_strong(state, _absentState, std::memory_order_acq_rel))
+                    {
+                        erased = true;
+                        break;
+                    }
+
+                    // Not yet published, so not yet present
+                    if (state != _assigningState)
+                    {
+                        break;
+                    }
+
+                    std::this_thread::yield();
+                }
+            }
+        }
+        else if (_Slot * const slot{_find(table, rawKey)})
+        {
+            _RawKey expected{rawKey};
+            if (_key(*slot).compare_exchange_strong(expected, _graveKey, std::memory_order_acq_rel))
+            {
+                table.graveN.fetch_add(1u, std::memory_order_relaxed);
+                erased = true;
+            }
+        }
+
+        _unregister(registration);
+        return erased;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::size() const
+    {
+        const _Registration registration{_register<false>()};
+        const _Table & table{*registration.table};
+
+        // Graves are loaded first as there are never more graves than claimed slots
+        const u64 graveN{table.graveN.load(std::memory_order_relaxed)};
+        u64 size{table.claimedN.load(std::memory_order_relaxed) - graveN};
+        size += _find(table, _graveKey) != nullptr;
+        size += _find(table, _vacantKey) != nullptr;
+
+        _unregister(registration);
+        return size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::empty() const
+    {
+        return size() == 0u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::capacity() const
+    {
+        return _capacityFor(slot_n());
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::slot_n() const
+    {
+        const _Registration registration{_register<false>()};
+        const u64 slotN{registration.table->slotN};
+        _unregister(registration);
+        return slotN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline const H & ConcurrentRawMap<K, V, H, A>::hash_function() const
+    {
+        return _hash;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline const A & ConcurrentRawMap<K, V, H, A>::get_allocator() const
+    {
+        return _alloc;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_key(_Slot & slot) -> std::atomic<_RawKey> &
+    {
+        if constexpr (_isSet)
+        {
+            return slot;
+        }
+        else
+        {
+            return slot.key;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool ConcurrentRawMap<K, V, H, A>::_isSpecial(const _RawKey key)
+    {
+        return key == _vacantKey || key == _graveKey;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::_capacityFor(const u64 slotN)
+    {
+        return slotN >> 1;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::_slotNFor(const u64 capacity)
+    {
+        return std::bit_ceil((capacity < minMapCapacity ? minMapCapacity : capacity) << 1);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::_hashOf(const _RawKey rawKey) const
+    {
+        return u64{_hash(std::bit_cast<K>(rawKey))};
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_allocate(const u64 slotN) -> _Table *
+    {
+        _TableAllocator tableAlloc{_alloc};
+        _SlotAllocator slotAlloc{_alloc};
+
+        _Table * const table{std::allocator_traits<_TableAllocator>::allocate(tableAlloc, 1u)};
+        std::construct_at(table);
+        table->slotN = slotN;
+        table->slots = std::allocator_traits<_SlotAllocator>::allocate(slotAlloc, slotN + 2u);
+
+        // Each special slot holds the other special key while absent
+        for (u64 slotI{0u}; slotI <= slotN; ++slotI)
+        {
+            std::construct_at(table->slots + slotI, _vacantKey);
+        }
+        std::construct_at(table->slots + slotN + 1u, _graveKey);
+
+        return table;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void ConcurrentRawMap<K, V, H, A>::_deallocate(_Table * const table)
+    {
+        _TableAllocator tableAlloc{_alloc};
+        _SlotAllocator slotAlloc{_alloc};
+
+        std::allocator_traits<_SlotAllocator>::deallocate(slotAlloc, table->slots, table->slotN + 2u);
+        std::destroy_at(table);
+        std::allocator_traits<_TableAllocator>::deallocate(tableAlloc, table, 1u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_stripe() const -> _Stripe &
+    {
+        return _stripes[_private::threadIndex() & (_stripeN - 1u)];
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <bool write>
+    inline auto ConcurrentRawMap<K, V, H, A>::_register() const -> _Registration
+    {
+        _Stripe & stripe{_stripe()};
+
+        while (true)
+        {
+            const u64 tagged{_table.load(std::memory_order_seq_cst)};
+            const u64 parity{tagged & 1u};
+            std::atomic<u64> & counter{write ? stripe.writerN[parity] : stripe.readerN[parity]};
+            counter.fetch_add(1u, std::memory_order_seq_cst);
+
+            // The table may have been replaced, and even freed, before we were counted
+            if (_table.load(std::memory_order_seq_cst) == tagged) [[likely]]
+            {
+                return {reinterpret_cast<_Table *>(tagged - parity), &counter, parity};
+            }
+
+            counter.fetch_sub(1u, std::memory_order_release);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_registerWriter() -> _Registration
+    {
+        while (true)
+        {
+            const _Registration registration{_register<true>()};
+
+            // Once a rehash has begun, the table may no longer be modified
+            if (!registration.table->next.load(std::memory_order_seq_cst)) [[likely]]
+            {
+                return registration;
+            }
+
+            _rehash(registration);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void ConcurrentRawMap<K, V, H, A>::_unregister(const _Registration & registration)
+    {
+        registration.counter->fetch_sub(1u, std::memory_order_release);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::_countRegistered(const u64 parity, const bool includeReaders) const
+    {
+        u64 n{0u};
+
+        for (const _Stripe & stripe : _stripes)
+        {
+            n += stripe.writerN[parity].load(std::memory_order_seq_cst);
+
+            if (includeReaders)
+            {
+                n += stripe.readerN[parity].load(std::memory_order_seq_cst);
+            }
+        }
+
+        return n;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void ConcurrentRawMap<K, V, H, A>::_rehash(const _Registration & registration)
+    {
+        _Table & table{*registration.table};
+        const u64 parity{registration.parity};
+
+        // Stay registered as a reader so the table is not freed from under us, but stop holding up the migration
+        std::atomic<u64> & readerN{_stripe().readerN[parity]};
+        readerN.fetch_add(1u, std::memory_order_seq_cst);
+        _unregister(registration);
+
+        _Table * next{table.next.load(std::memory_order_acquire)};
+        if (!next)
+        {
+            // Grow if at least half the capacity is live, otherwise just clear out the graves
+            const u64 graveN{table.graveN.load(std::memory_order_relaxed)};
+            const u64 liveN{table.claimedN.load(std::memory_order_relaxed) - graveN};
+            _Table * const candidate{_allocate(liveN >= (_capacityFor(table.slotN) >> 1) ? table.slotN << 1 : table.slotN)};
+
+            if (table.next.compare_exchange_strong(next, candidate, std::memory_order_seq_cst))
+            {
+                next = candidate;
+            }
+            else
+            {
+                _deallocate(candidate);
+            }
+        }
+
+        // The new table will share the previous table's parity, so the previous table must be freed first
+        while (table.prev.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+
+        // Wait out the writers that registered before the rehash began
+        while (_countRegistered(parity, false))
+        {
+            std::this_thread::yield();
+        }
+
+        const u64 chunkN{(table.slotN + (_chunkSize - 1u)) / _chunkSize};
+        bool isLast{false};
+
+        for (u64 chunkI{table.chunkI.fetch_add(1u, std::memory_order_relaxed)}; chunkI < chunkN; chunkI = table.chunkI.fetch_add(1u, std::memory_order_relaxed))
+        {
+            next->claimedN.fetch_add(_migrateChunk(table, *next, chunkI), std::memory_order_relaxed);
+            isLast = table.migratedChunkN.fetch_add(1u, std::memory_order_acq_rel) + 1u == chunkN;
+        }
+
+        if (isLast)
+        {
+            next->prev.store(&table, std::memory_order_relaxed);
+            _table.store(reinterpret_cast<u64>(next) | (parity ^ 1u), std::memory_order_seq_cst);
+            readerN.fetch_sub(1u, std::memory_order_release);
+
+            // Wait out the threads still reading the old table before freeing it
+            while (_countRegistered(parity, true))
+            {
+                std::this_thread::yield();
+            }
+
+            _deallocate(&table);
+            next->prev.store(nullptr, std::memory_order_release);
+        }
+        else
+        {
+            // Wait for the migration to finish so we do not just run into the full table again
+            while (_table.load(std::memory_order_acquire) == (reinterpret_cast<u64>(&table) | parity))
+            {
+                std::this_thread::yield();
+            }
+
+            readerN.fetch_sub(1u, std::memory_order_release);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 ConcurrentRawMap<K, V, H, A>::_migrateChunk(const _Table & table, _Table & next, const u64 chunkI) const
+    {
+        // No writers remain, so the old table is no longer changing
+        if (chunkI == 0u)
+        {
+            for (u64 specialI{0u}; specialI < 2u; ++specialI)
+            {
+                _Slot & slot{table.slots[table.slotN + specialI]};
+                _Slot & nextSlot{next.slots[next.slotN + specialI]};
+
+                if constexpr (_isSet)
+                {
+                    nextSlot.store(slot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+                else
+                {
+                    nextSlot.value.store(slot.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    nextSlot.state.store(slot.state.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const u64 beginI{chunkI * _chunkSize};
+        const u64 endI{beginI + _chunkSize < table.slotN ? beginI + _chunkSize : table.slotN};
+        const u64 nextMask{next.slotN - 1u};
+        u64 n{0u};
+
+        for (u64 slotI{beginI}; slotI < endI; ++slotI)
+        {
+            _Slot & slot{table.slots[slotI]};
+            const _RawKey rawKey{_key(slot).load(std::memory_order_relaxed)};
+
+            if (_isSpecial(rawKey))
+            {
+                continue;
+            }
+
+            // Other threads are migrating other chunks into the same table
+            u64 nextSlotI{_hashOf(rawKey) & nextMask};
+            while (true)
+            {
+                _RawKey expected{_vacantKey};
+                if (_key(next.slots[nextSlotI]).compare_exchange_strong(expected, rawKey, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                nextSlotI = (nextSlotI + 1u) & nextMask;
+            }
+
+            if constexpr (_isMap)
+            {
+                _Slot & nextSlot{next.slots[nextSlotI]};
+                nextSlot.value.store(slot.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                nextSlot.state.store(_publishedState, std::memory_order_relaxed);
+            }
+
+            ++n;
+        }
+
+        return n;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_claim(_Table & table, const _RawKey rawKey, u64 & slotI) const -> _ClaimResult
+    {
+        const u64 mask{table.slotN - 1u};
+        bool isReserved{false};
+
+        slotI = _hashOf(rawKey) & mask;
+
+        while (true)
+        {
+            std::atomic<_RawKey> & key{_key(table.slots[slotI])};
+            _RawKey current{key.load(std::memory_order_acquire)};
+
+            if (current == _vacantKey)
+            {
+                // Reserve capacity before claiming so there is always a vacant slot to end a probe
+                if (!isReserved)
+                {
+                    if (table.claimedN.fetch_add(1u, std::memory_order_relaxed) >= _capacityFor(table.slotN)) [[unlikely]]
+                    {
+                        table.claimedN.fetch_sub(1u, std::memory_order_relaxed);
+                        return _ClaimResult::full;
+                    }
+
+                    isReserved = true;
+                }
+
+                if (key.compare_exchange_strong(current, rawKey, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    return _ClaimResult::inserted;
+                }
+
+                // Lost the slot to another thread, which may have claimed it for the same key
+            }
+
+            if (current == rawKey)
+            {
+                if (isReserved)
+                {
+                    table.claimedN.fetch_sub(1u, std::memory_order_relaxed);
+                }
+
+                return _ClaimResult::present;
+            }
+
+            if (current != _vacantKey)
+            {
+                slotI = (slotI + 1u) & mask;
+            }
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto ConcurrentRawMap<K, V, H, A>::_find(const _Table & table, const _RawKey rawKey) const -> _Slot *
+    {
+        if (_isSpecial(rawKey)) [[unlikely]]
+        {
+            _Slot & slot{table.slots[table.slotN + (rawKey == _vacantKey)]};
+
+            if constexpr (_isSet)
+            {
+                return slot.load(std::memory_order_acquire) == rawKey ? &slot : nullptr;
+            }
+            else
+            {
+                return slot.state.load(std::memory_order_acquire) >= _publishedState ? &slot : nullptr;
+            }
+        }
+
+        const u64 mask{table.slotN - 1u};
+
+        for (u64 slotI{_hashOf(rawKey) & mask};; slotI = (slotI + 1u) & mask)
+        {
+            _Slot & slot{table.slots[slotI]};
+            const _RawKey current{_key(slot).load(std::memory_order_acquire)};
+
+            if (current == rawKey)
+            {
+                if constexpr (_isMap)
+                {
+                    if (slot.state.load(std::memory_order_acquire) != _publishedState)
+                    {
+                        return nullptr;
+                    }
+                }
+
+                return &slot;
+            }
+
+            if (current == _vacantKey)
+            {
+                return nullptr;
+            }
+        }
+    }
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline ShardedRawMap<K, V, H, A, P>::ShardedRawMap(const u64 capacity, const u64 shardN, const H & hash, const A & alloc) :
+        _shardN{std::bit_ceil(shardN ? shardN : 1u)},
+        _shardBits{std::countr_zero(_shardN)},
+        _shards{new _Shard[_shardN]},
+        _hash{hash}
+    {
+        const u64 shardCapacity{(capacity + (_shardN - 1u)) / _shardN};
+
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            _shards[shardI].map = shard_type{shardCapacity, hash, alloc};
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool ShardedRawMap<K, V, H, A, P>::insert(const value_type & element)
+    {
+        _Shard & shard{_shards[this->shard(_key(element))]};
+        const std::unique_lock lock{shard.mutex};
+        return shard.map.insert(element).second;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline bool ShardedRawMap<K, V, H, A, P>::try_emplace(K_ && key, VArgs &&... valueArgs)
+    {
+        _Shard & shard{_shards[this->shard(key)]};
+        const std::unique_lock lock{shard.mutex};
+        return shard.map.try_emplace(std::forward<K_>(key), std::forward<VArgs>(valueArgs)...).second;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename V_>
+    inline bool ShardedRawMap<K, V, H, A, P>::insert_or_assign(K_ && key, V_ && value) requires (_isMap)
+    {
+        _Shard & shard{_shards[this->shard(key)]};
+        const std::unique_lock lock{shard.mutex};
+        const auto [it, inserted]{shard.map.try_emplace(std::forward<K_>(key), std::forward<V_>(value))};
+        if (!inserted)
+        {
+            it->second = std::forward<V_>(value);
+        }
+        return inserted;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool ShardedRawMap<K, V, H, A, P>::erase(const K_ & key)
+    {
+        _Shard & shard{_shards[this->shard(key)]};
+        const std::unique_lock lock{shard.mutex};
+        return shard.map.erase(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool ShardedRawMap<K, V, H, A, P>::contains(const K_ & key) const
+    {
+        const _Shard & shard{_shards[this->shard(key)]};
+        const std::shared_lock lock{shard.mutex};
+        return shard.map.contains(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto ShardedRawMap<K, V, H, A, P>::find(const K_ & key) const -> std::optional<_Value> requires (_isMap)
+    {
+        const _Shard & shard{_shards[this->shard(key)]};
+        const std::shared_lock lock{shard.mutex};
+        const auto it{shard.map.find(key)};
+        return it != shard.map.cend() ? std::optional<_Value>{it->second} : std::nullopt;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_, typename Fn>
+    inline bool ShardedRawMap<K, V, H, A, P>::visit(const K_ & key, Fn && fn) const
+    {
+        const _Shard & shard{_shards[this->shard(key)]};
+        const std::shared_lock lock{shard.mutex};
+        const auto it{shard.map.find(key)};
+        if (it == shard.map.cend())
+        {
+            return false;
+        }
+        fn(*it);
+        return true;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_, typename Fn>
+    inline bool ShardedRawMap<K, V, H, A, P>::visit(const K_ & key, Fn && fn)
+    {
+        _Shard & shard{_shards[this->shard(key)]};
+        const std::unique_lock lock{shard.mutex};
+        const auto it{shard.map.find(key)};
+        if (it == shard.map.end())
+        {
+            return false;
+        }
+        fn(*it);
+        return true;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::contains_batch(const std::span<const K> keys, const std::span<bool> results) const
+    {
+        u64 presentN{0u};
+        _batch(keys, [&](const shard_type & map, const u64 keyI) {
+            presentN += results[keyI] = map.contains(keys[keyI]);
+        });
+        return presentN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::find_batch(const std::span<const K> keys, const std::span<std::optional<_Value>> values) const requires (_isMap)
+    {
+        u64 presentN{0u};
+        _batch(keys, [&](const shard_type & map, const u64 keyI) {
+            const auto it{map.find(keys[keyI])};
+            if (it != map.cend())
+            {
+                values[keyI] = it->second;
+                ++presentN;
+            }
+            else
+            {
+                values[keyI].reset();
+            }
+        });
+        return presentN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::insert_batch(const std::span<const value_type> elements)
+    {
+        u64 insertedN{0u};
+        _batch(elements, [&](shard_type & map, const u64 elementI) {
+            insertedN += map.insert(elements[elementI]).second;
+        });
+        return insertedN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::erase_batch(const std::span<const K> keys)
+    {
+        u64 erasedN{0u};
+        _batch(keys, [&](shard_type & map, const u64 keyI) {
+            erasedN += map.erase(keys[keyI]);
+        });
+        return erasedN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename Fn>
+    inline void ShardedRawMap<K, V, H, A, P>::for_each(Fn && fn) const
+    {
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            const _Shard & shard{_shards[shardI]};
+            const std::shared_lock lock{shard.mutex};
+            shard.map.for_each(fn);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename Fn>
+    inline void ShardedRawMap<K, V, H, A, P>::for_each(Fn && fn)
+    {
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            _Shard & shard{_shards[shardI]};
+            const std::unique_lock lock{shard.mutex};
+            shard.map.for_each(fn);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void ShardedRawMap<K, V, H, A, P>::clear()
+    {
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            _Shard & shard{_shards[shardI]};
+            const std::unique_lock lock{shard.mutex};
+            shard.map.clear();
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::size() const
+    {
+        u64 size{0u};
+
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            const _Shard & shard{_shards[shardI]};
+            const std::shared_lock lock{shard.mutex};
+            size += shard.map.size();
+        }
+
+        return size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool ShardedRawMap<K, V, H, A, P>::empty() const
+    {
+        return size() == 0u;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 ShardedRawMap<K, V, H, A, P>::shard_n() const
+    {
+        return _shardN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 ShardedRawMap<K, V, H, A, P>::shard(const K_ & key) const
+    {
+        // Mixed first, as hashes such as the identity hash of a small integer leave the high bits empty
+        return std::rotl(fastHash::mix(u64{_hash(key)}), _shardBits) & (_shardN - 1u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const H & ShardedRawMap<K, V, H, A, P>::hash_function() const
+    {
+        return _hash;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const K & ShardedRawMap<K, V, H, A, P>::_key(const value_type & element)
+    {
+        if constexpr (_isSet)
+        {
+            return element;
+        }
+        else
+        {
+            return element.first;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename T, typename Fn>
+    inline void ShardedRawMap<K, V, H, A, P>::_batch(const std::span<const T> items, Fn && fn)
+    {
+        _groupByShard(items, [&](const u64 shardI, const std::span<const u64> itemIs) {
+            _Shard & shard{_shards[shardI]};
+            const std::unique_lock lock{shard.mutex};
+            for (const u64 itemI : itemIs)
+            {
+                fn(shard.map, itemI);
+            }
+        });
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename T, typename Fn>
+    inline void ShardedRawMap<K, V, H, A, P>::_batch(const std::span<const T> items, Fn && fn) const
+    {
+        _groupByShard(items, [&](const u64 shardI, const std::span<const u64> itemIs) {
+            const _Shard & shard{_shards[shardI]};
+            const std::shared_lock lock{shard.mutex};
+            for (const u64 itemI : itemIs)
+            {
+                fn(shard.map, itemI);
+            }
+        });
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename T, typename Fn>
+    inline void ShardedRawMap<K, V, H, A, P>::_groupByShard(const std::span<const T> items, Fn && fn) const
+    {
+        const u64 itemN{items.size()};
+
+        if (!itemN)
+        {
+            return;
+        }
+
+        // Counting sort the item indices by shard. The shard of each item is kept to avoid hashing twice
+        const std::unique_ptr<u64[]> buffer{new u64[itemN * 2u + _shardN]{}};
+        u64 * const itemShards{buffer.get()};
+        u64 * const order{itemShards + itemN};
+        u64 * const shardEnds{order + itemN};
+
+        for (u64 itemI{0u}; itemI < itemN; ++itemI)
+        {
+            if constexpr (std::is_same_v<T, K>)
+            {
+                itemShards[itemI] = shard(items[itemI]);
+            }
+            else
+            {
+                itemShards[itemI] = shard(_key(items[itemI]));
+            }
+            ++shardEnds[itemShards[itemI]];
+        }
+
+        for (u64 shardI{1u}; shardI < _shardN; ++shardI)
+        {
+            shardEnds[shardI] += shardEnds[shardI - 1u];
+        }
+
+        // Placed back to front so each shard's end becomes its beginning, keeping the items of a shard in order
+        for (u64 itemI{itemN}; itemI-- > 0u;)
+        {
+            order[--shardEnds[itemShards[itemI]]] = itemI;
+        }
+
+        for (u64 shardI{0u}; shardI < _shardN; ++shardI)
+        {
+            const u64 beginI{shardEnds[shardI]};
+            const u64 endI{shardI + 1u < _shardN ? shardEnds[shardI + 1u] : itemN};
+
+            if (beginI == endI)
+            {
+                continue;
+            }
+
+            fn(shardI, std::span<const u64>{order + beginI, order + endI});
+        }
+    }
+
+    #ifdef QC_HASH_MMAP_ENABLED
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline RawMapView<K, V, H, A, P>::RawMapView(const H & hash) :
+            _map{minMapCapacity, hash},
+            _mapping{},
+            _mappingSize{}
+        {}
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline RawMapView<K, V, H, A, P>::RawMapView(RawMapView && other) :
+            _map{std::move(other._map)},
+            _mapping{std::exchange(other._mapping, nullptr)},
+            _mappingSize{std::exchange(other._mappingSize, 0u)}
+        {}
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline RawMapView<K, V, H, A, P> & RawMapView<K, V, H, A, P>::operator=(RawMapView && other)
+        {
+            if (&other != this)
+            {
+                _unmap();
+                _map = std::move(other._map);
+                _mapping = std::exchange(other._mapping, nullptr);
+                _mappingSize = std::exchange(other._mappingSize, 0u);
+            }
+
+            return *this;
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline RawMapView<K, V, H, A, P>::~RawMapView()
+        {
+            _unmap();
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline auto RawMapView<K, V, H, A, P>::map() const -> const map_type &
+        {
+            return _map;
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline bool RawMapView<K, V, H, A, P>::contains(const K_ & key) const
+        {
+            return _map.contains(key);
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline auto RawMapView<K, V, H, A, P>::find(const K_ & key) const -> const_iterator
+        {
+            return _map.find(key);
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline auto RawMapView<K, V, H, A, P>::begin() const -> const_iterator
+        {
+            return _map.begin();
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline auto RawMapView<K, V, H, A, P>::end() const -> const_iterator
+        {
+            return _map.end();
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline u64 RawMapView<K, V, H, A, P>::size() const
+        {
+            return _map.size();
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline bool RawMapView<K, V, H, A, P>::empty() const
+        {
+            return _map.empty();
+        }
+
+        template <Rawable K, typename V, typename H, typename A, typename P>
+        inline void RawMapView<K, V, H, A, P>::_unmap()
+        {
+            // The map must not free or destroy what it doesn't own
+            _map._elements = nullptr;
+            _map._size = 0u;
+
+            if (_mapping)
+            {
+                ::munmap(_mapping, _mappingSize);
+                _mapping = nullptr;
+            }
+        }
+    #endif
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P>::IncrementalRawMap(const u64 capacity, const H & hash, const A & alloc) :
+        _map{capacity, hash, alloc},
+        _old{minMapCapacity, hash, alloc},
+        _migrateSlotI{},
+        _migrateStepN{},
+        _next{},
+        _nextSlotN{},
+        _nextClearedN{}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P>::IncrementalRawMap(const IncrementalRawMap & other) :
+        _map{other._map},
+        _old{other._old},
+        _migrateSlotI{other._migrateSlotI},
+        _migrateStepN{other._migrateStepN},
+        _next{},
+        _nextSlotN{},
+        _nextClearedN{}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P>::IncrementalRawMap(IncrementalRawMap && other) :
+        _map{std::move(other._map)},
+        _old{std::move(other._old)},
+        _migrateSlotI{other._migrateSlotI},
+        _migrateStepN{other._migrateStepN},
+        _next{std::exchange(other._next, nullptr)},
+        _nextSlotN{other._nextSlotN},
+        _nextClearedN{other._nextClearedN}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P> & IncrementalRawMap<K, V, H, A, P>::operator=(const IncrementalRawMap & other)
+    {
+        if (&other != this)
+        {
+            _releaseNext();
+            _map = other._map;
+            _old = other._old;
+            _migrateSlotI = other._migrateSlotI;
+            _migrateStepN = other._migrateStepN;
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P> & IncrementalRawMap<K, V, H, A, P>::operator=(IncrementalRawMap && other)
+    {
+        if (&other != this)
+        {
+            _releaseNext();
+            _map = std::move(other._map);
+            _old = std::move(other._old);
+            _migrateSlotI = other._migrateSlotI;
+            _migrateStepN = other._migrateStepN;
+            _next = std::exchange(other._next, nullptr);
+            _nextSlotN = other._nextSlotN;
+            _nextClearedN = other._nextClearedN;
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline IncrementalRawMap<K, V, H, A, P>::~IncrementalRawMap()
+    {
+        _releaseNext();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::insert(const value_type & element) -> std::pair<iterator, bool>
+    {
+        if (const iterator it{_prepareInsert(_key(element))}; it != end())
+        {
+            return {it, false};
+        }
+
+        return _iterator(_map.insert(element));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::insert(value_type && element) -> std::pair<iterator, bool>
+    {
+        if (const iterator it{_prepareInsert(_key(element))}; it != end())
+        {
+            return {it, false};
+        }
+
+        return _iterator(_map.insert(std::move(element)));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline auto IncrementalRawMap<K, V, H, A, P>::try_emplace(K_ && key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
+    {
+        if (const iterator it{_prepareInsert(key)}; it != end())
+        {
+            return {it, false};
+        }
+
+        return _iterator(_map.try_emplace(std::forward<K_>(key), std::forward<VArgs>(valueArgs)...));
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool IncrementalRawMap<K, V, H, A, P>::erase(const K_ & key)
+    {
+        if (_map.erase(key))
+        {
+            return true;
+        }
+
+        const auto it{_old.find(key)};
+        if (it != _old.end())
+        {
+            _retire(u64(it._element - _old._elements));
+            return true;
+        }
+
+        return false;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::erase(const iterator position)
+    {
+        const _Slot * const element{position._it._element};
+        if (_old._elements && element >= _old._elements && element < _old._elements + _old._slotN)
+        {
+            _retire(u64(element - _old._elements));
+        }
+        else
+        {
+            _map.erase(position._it);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool IncrementalRawMap<K, V, H, A, P>::contains(const K_ & key) const
+    {
+        return _map.contains(key) || _old.contains(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto IncrementalRawMap<K, V, H, A, P>::find(const K_ & key) -> iterator
+    {
+        const typename map_type::iterator it{_map.find(key)};
+        return it != _map.end() ? _iterator(it) : iterator{_old.find(key), nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto IncrementalRawMap<K, V, H, A, P>::find(const K_ & key) const -> const_iterator
+    {
+        const typename map_type::const_iterator it{_map.find(key)};
+        return it != _map.end() ? const_iterator{it, _old._elements ? &_old : nullptr} : const_iterator{_old.find(key), nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::begin() -> iterator
+    {
+        const typename map_type::iterator it{_map.begin()};
+        return it != _map.end() ? _iterator(it) : iterator{_old.begin(), nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::begin() const -> const_iterator
+    {
+        const typename map_type::const_iterator it{_map.begin()};
+        return it != _map.end() ? const_iterator{it, _old._elements ? &_old : nullptr} : const_iterator{_old.begin(), nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::end() -> iterator
+    {
+        return iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::end() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::cend() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::reserve(const u64 capacity)
+    {
+        finish_migration();
+        _releaseNext();
+        _map.reserve(capacity);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::finish_migration()
+    {
+        if (_old._elements)
+        {
+            _migrate(_old._slotN);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool IncrementalRawMap<K, V, H, A, P>::migrating() const
+    {
+        return _old._elements;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::clear()
+    {
+        _map.clear();
+        if (_old._elements)
+        {
+            _old.clear();
+            _old._deallocate();
+        }
+        _releaseNext();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 IncrementalRawMap<K, V, H, A, P>::size() const
+    {
+        return _map.size() + _old.size();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool IncrementalRawMap<K, V, H, A, P>::empty() const
+    {
+        return _map.empty() && _old.empty();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 IncrementalRawMap<K, V, H, A, P>::capacity() const
+    {
+        return _map.capacity();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline u64 IncrementalRawMap<K, V, H, A, P>::slot_n() const
+    {
+        return _map.slot_n();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const H & IncrementalRawMap<K, V, H, A, P>::hash_function() const
+    {
+        return _map.hash_function();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const A & IncrementalRawMap<K, V, H, A, P>::get_allocator() const
+    {
+        return _map.get_allocator();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline const K & IncrementalRawMap<K, V, H, A, P>::_key(const value_type & element)
+    {
+        if constexpr (_isSet)
+        {
+            return element;
+        }
+        else
+        {
+            return element.first;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline bool IncrementalRawMap<K, V, H, A, P>::_wouldGrow() const
+    {
+        if (!_map._elements)
+        {
+            return false;
+        }
+
+        const u64 regularSize{_map._size - _map._haveSpecial[0] - _map._haveSpecial[1]};
+        if (regularSize >= _map.capacity())
+        {
+            return true;
+        }
+
+        // Mirrors `RawMap`'s choice to grow rather than purge when there are too few graves to be worth it
+        if constexpr (!map_type::_isBackwardShift)
+        {
+            return regularSize + _map._graveN >= _map._graveLimit() && (_map._graveN << 3) < _map._slotN;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <typename K_>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_prepareInsert(const K_ & key) -> iterator
+    {
+        if (_old._elements)
+        {
+            _migrate(_migrateStepN);
+        }
+        else
+        {
+            _prepareNext();
+        }
+
+        if (_wouldGrow()) [[unlikely]]
+        {
+            // Inserting a present key adds nothing, so must not set off growth
+            if (const iterator it{find(key)}; it != end())
+            {
+                return it;
+            }
+
+            finish_migration();
+            _startMigration();
+        }
+
+        return iterator{_old.find(key), nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::_prepareNext()
+    {
+        if (!_map._elements)
+        {
+            return;
+        }
+
+        const u64 regularSize{_map._size - _map._haveSpecial[0] - _map._haveSpecial[1]};
+        const u64 capacity{_map.capacity()};
+        if (regularSize >= capacity)
+        {
+            return;
+        }
+
+        const u64 remainingN{capacity - regularSize};
+        if (!_next)
+        {
+            // Wait until clearing the next table costs at most sixteen slots per insertion
+            _nextSlotN = _map._slotN << 1;
+            if (remainingN > (_nextSlotN >> 4))
+            {
+                return;
+            }
+
+            _next = reinterpret_cast<_Slot *>(std::allocator_traits<A>::allocate(_map._alloc, map_type::_allocationN(_nextSlotN)));
+            _nextClearedN = 0u;
+        }
+
+        const u64 unclearedN{_nextSlotN - _nextClearedN};
+        const u64 endSlotI{_nextClearedN + (unclearedN + remainingN - 1u) / remainingN};
+        for (; _nextClearedN < endSlotI; ++_nextClearedN)
+        {
+            _raw(map_type::_key(_next[_nextClearedN])) = map_type::_vacantKey;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::_releaseNext()
+    {
+        if (_next)
+        {
+            std::allocator_traits<A>::deallocate(_map._alloc, reinterpret_cast<typename map_type::E *>(_next), map_type::_allocationN(_nextSlotN));
+            _next = nullptr;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::_startMigration()
+    {
+        _old.swap(_map);
+
+        const u64 slotN{_old._slotN << 1};
+        if (_next && _nextSlotN == slotN)
+        {
+            // Growth may come early from graves, before the next table is fully cleared
+            for (; _nextClearedN < slotN; ++_nextClearedN)
+            {
+                _raw(map_type::_key(_next[_nextClearedN])) = map_type::_vacantKey;
+            }
+            _raw(map_type::_key(_next[slotN])) = map_type::_vacantGraveKey;
+            _raw(map_type::_key(_next[slotN + 1u])) = map_type::_vacantVacantKey;
+            _raw(map_type::_key(_next[slotN + 2u])) = map_type::_terminalKey;
+            _raw(map_type::_key(_next[slotN + 3u])) = map_type::_terminalKey;
+
+            _map._slotN = slotN;
+            _map._elements = std::exchange(_next, nullptr);
+        }
+        else
+        {
+            _releaseNext();
+            _map.rehash(slotN);
+        }
+
+        // The special elements are moved right away, leaving only regular elements in the old table
+        for (const u64 specialI : {0u, 1u})
+        {
+            if (_old._haveSpecial[specialI])
+            {
+                const u64 slotI{_old._slotN + specialI};
+                if constexpr (map_type::_isSplit)
+                {
+                    _map.try_emplace(std::move(_old._elements[slotI]), std::move(map_type::_values(_old._elements, _old._slotN)[slotI]));
+                }
+                else
+                {
+                    _map.emplace(std::move(_old._elements[slotI]));
+                }
+                _old._destroy(_old._elements, _old._slotN, slotI);
+                _raw(map_type::_key(_old._elements[slotI])) = map_type::_vacantSpecialKeys[specialI];
+                _old._haveSpecial[specialI] = false;
+                --_old._size;
+            }
+        }
+
+        // Twice the slots per element needed to empty the old table before the new one fills, so it is done by half
+        _migrateSlotI = 0u;
+        _migrateStepN = (_old._slotN + _old.capacity() - 1u) / _old.capacity() * 2u;
+
+        _migrate(0u);
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::_migrate(const u64 slotN)
+    {
+        const u64 endSlotI{_old._slotN - _migrateSlotI > slotN ? _migrateSlotI + slotN : _old._slotN};
+        for (; _migrateSlotI < endSlotI && _old._size; ++_migrateSlotI)
+        {
+            _Slot & element{_old._elements[_migrateSlotI]};
+            if (map_type::_isPresent(_raw(map_type::_key(element))))
+            {
+                if constexpr (map_type::_isSplit)
+                {
+                    _map.try_emplace(std::move(element), std::move(map_type::_values(_old._elements, _old._slotN)[_migrateSlotI]));
+                }
+                else
+                {
+                    _map.emplace(std::move(element));
+                }
+                _retire(_migrateSlotI);
+            }
+        }
+
+        if (!_old._size)
+        {
+            _old._deallocate();
+            _old._graveN = 0u;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline void IncrementalRawMap<K, V, H, A, P>::_retire(const u64 slotI)
+    {
+        _old._destroy(_old._elements, _old._slotN, slotI);
+        _raw(map_type::_key(_old._elements[slotI])) = map_type::_graveKey;
+        --_old._size;
+        ++_old._graveN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_iterator(const typename map_type::iterator it) -> iterator
+    {
+        return iterator{it, _old._elements ? &_old : nullptr};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_iterator(const std::pair<typename map_type::iterator, bool> result) -> std::pair<iterator, bool>
+    {
+        return {_iterator(result.first), result.second};
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_> requires (constant && !constant_)
+    inline constexpr IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other) :
+        _it{other._it},
+        _next{other._next}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline constexpr IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::_Iterator(const _MapIterator it, _Map * const next) :
+        _it{it},
+        _next{next}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::operator*() const -> reference
+    {
+        return *_it;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::operator->() const -> pointer
+    {
+        return _it.operator->();
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::operator++() -> _Iterator &
+    {
+        ++_it;
+        if (_next && _it == _MapIterator{})
+        {
+            _it = _next->begin();
+            _next = nullptr;
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::operator++(int) -> _Iterator
+    {
+        const _Iterator temp{*this};
+        operator++();
+        return temp;
+    }
+
+    template <Rawable K, typename V, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_>
+    inline bool IncrementalRawMap<K, V, H, A, P>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
+    {
+        return _it == other._it;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline FrozenRawMap<K, V, H, A>::FrozenRawMap(const H & hash, const A & alloc) :
+        _size{},
+        _bucketN{},
+        _stashN{},
+        _haveSpecial{},
+        _keys{},
+        _values{},
+        _hash{hash},
+        _alloc{alloc}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <typename P>
+    inline FrozenRawMap<K, V, H, A>::FrozenRawMap(const RawMap<K, V, H, A, P> & map) :
+        FrozenRawMap{map.hash_function(), map.get_allocator()}
+    {
+        _build(map, [this](const auto & element, K * const key, _Value * const value)
+        {
+            std::allocator_traits<A>::construct(_alloc, key, _key(element));
+
+            if constexpr (_isMap)
+            {
+                std::allocator_traits<A>::construct(_alloc, value, element.second);
+            }
+        });
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <typename P>
+    inline FrozenRawMap<K, V, H, A>::FrozenRawMap(RawMap<K, V, H, A, P> && map) :
+        FrozenRawMap{map.hash_function(), map.get_allocator()}
+    {
+        _build(map, [this](auto && element, K * const key, _Value * const value)
+        {
+            // The map is cleared straight after, so its keys may be moved from even where it only exposes them as const
+            std::allocator_traits<A>::construct(_alloc, key, std::move(const_cast<K &>(_key(element))));
+
+            if constexpr (_isMap)
+            {
+                std::allocator_traits<A>::construct(_alloc, value, std::move(element.second));
+            }
+        });
+
+        map.clear();
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline FrozenRawMap<K, V, H, A>::FrozenRawMap(const FrozenRawMap & other) :
+        FrozenRawMap{other._hash, std::allocator_traits<A>::select_on_container_copy_construction(other._alloc)}
+    {
+        _copy(other);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline FrozenRawMap<K, V, H, A>::FrozenRawMap(FrozenRawMap && other) :
+        FrozenRawMap{other._hash, std::move(other._alloc)}
+    {
+        _move(other);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::operator=(const FrozenRawMap & other) -> FrozenRawMap &
+    {
+        if (&other != this)
+        {
+            _destroy();
+            _hash = other._hash;
+            if constexpr (std::allocator_traits<A>::propagate_on_container_copy_assignment::value)
+            {
+                _alloc = other._alloc;
+            }
+            _copy(other);
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::operator=(FrozenRawMap && other) -> FrozenRawMap &
+    {
+        if (&other != this)
+        {
+            _destroy();
+            _hash = other._hash;
+            if constexpr (std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+            {
+                _alloc = std::move(other._alloc);
+            }
+            _move(other);
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline FrozenRawMap<K, V, H, A>::~FrozenRawMap()
+    {
+        _destroy();
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <Compatible<K> K_>
+    inline bool FrozenRawMap<K, V, H, A>::contains(const K_ & key) const
+    {
+        return _size ? _findSlot(key) < _totalSlotN() : false;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <Compatible<K> K_>
+    inline u64 FrozenRawMap<K, V, H, A>::count(const K_ & key) const
+    {
+        return contains(key);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <Compatible<K> K_>
+    inline auto FrozenRawMap<K, V, H, A>::find(const K_ & key) const -> const_iterator
+    {
+        if (!_size)
+        {
+            return end();
+        }
+
+        const u64 slotI{_findSlot(key)};
+        return slotI < _totalSlotN() ? const_iterator{this, slotI} : end();
+    }
+
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        template <Rawable K, typename V, typename H, typename A>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<const V> FrozenRawMap<K, V, H, A>::at(const K_ & key) const requires (_isMap)
+        {
+            if (!_size)
+            {
+                throw std::out_of_range{"Map is empty"};
+            }
+
+            const u64 slotI{_findSlot(key)};
+
+            if (slotI == _totalSlotN())
+            {
+                throw std::out_of_range{"Element not found"};
+            }
+
+            return _values[slotI];
+        }
+    #endif
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::begin() const -> const_iterator
+    {
+        if (!_size)
+        {
+            return end();
+        }
+
+        const_iterator it{this, 0u};
+        if (!_isPresent(0u))
+        {
+            ++it;
+        }
+
+        return it;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::end() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::size() const
+    {
+        return _size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool FrozenRawMap<K, V, H, A>::empty() const
+    {
+        return !_size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::slot_n() const
+    {
+        return _slotN();
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::stash_n() const
+    {
+        return _stashN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline f32 FrozenRawMap<K, V, H, A>::load_factor() const
+    {
+        return _bucketN ? f32(f64(_size - _haveSpecial - _stashN) / f64(_slotN())) : 0.0f;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline const H & FrozenRawMap<K, V, H, A>::hash_function() const
+    {
+        return _hash;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline const A & FrozenRawMap<K, V, H, A>::get_allocator() const
+    {
+        return _alloc;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline const K & FrozenRawMap<K, V, H, A>::_key(const auto & element)
+    {
+        if constexpr (_isSet)
+        {
+            return element;
+        }
+        else
+        {
+            return element.first;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <typename K_>
+    inline u64 FrozenRawMap<K, V, H, A>::_mixedHash(const K_ & key) const
+    {
+        if constexpr (_private::IsMixingHasher<H>::value)
+        {
+            return u64{_hash(key)};
+        }
+        else
+        {
+            return fastHash::mix(u64{_hash(key)});
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_bucket1(const u64 mixedHash) const
+    {
+        return ((mixedHash >> 32) * _bucketN) >> 32;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_bucket2(const u64 mixedHash) const
+    {
+        return (u64(u32(mixedHash)) * _bucketN) >> 32;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_slotN() const
+    {
+        return _bucketN * _bucketWidth;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_totalSlotN() const
+    {
+        return _slotN() + 1u + _stashN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_lineN() const
+    {
+        const u64 keyLineN{(_totalSlotN() * sizeof(K) + sizeof(_Line) - 1u) / sizeof(_Line)};
+
+        if constexpr (_isSet)
+        {
+            return keyLineN;
+        }
+        else
+        {
+            return keyLineN + (_totalSlotN() * sizeof(V) + sizeof(_Line) - 1u) / sizeof(_Line);
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool FrozenRawMap<K, V, H, A>::_isPresent(const u64 slotI) const
+    {
+        const u64 slotN{_slotN()};
+
+        if (slotI < slotN) [[likely]]
+        {
+            return _raw(_keys[slotI]) != _vacantKey;
+        }
+        else if (slotI == slotN)
+        {
+            return _haveSpecial;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <typename Map, typename Forward>
+    inline void FrozenRawMap<K, V, H, A>::_build(Map & map, Forward forward)
+    {
+        using MapIterator = decltype(map.begin());
+
+        std::vector<MapIterator> elements;
+        std::vector<u64> mixedHashes;
+        elements.reserve(map.size());
+        mixedHashes.reserve(map.size());
+        MapIterator special{};
+
+        for (auto it{map.begin()}; it != map.end(); ++it)
+        {
+            const K & key{_key(*it)};
+
+            // The vacant key marks vacant bucket slots, so it gets a slot of its own
+            if (_raw(key) == _vacantKey) [[unlikely]]
+            {
+                special = it;
+                _haveSpecial = true;
+            }
+            else
+            {
+                elements.push_back(it);
+                mixedHashes.push_back(_mixedHash(key));
+            }
+        }
+
+        if (elements.empty() && !_haveSpecial)
+        {
+            return;
+        }
+
+        std::vector<u64> slots;
+        std::vector<u64> stash;
+
+        _bucketN = u64(f64(elements.size()) / (f64(_bucketWidth) * f64(frozenLoadFactor))) + 1u;
+
+        for (u64 rebuildI{0u}; !_place(mixedHashes, slots, stash) && rebuildI < _maxRebuildN; ++rebuildI)
+        {
+            _bucketN += _bucketN / 32u + 1u;
+        }
+
+        _stashN = stash.size();
+        _allocate();
+
+        const u64 slotN{_slotN()};
+
+        for (u64 slotI{0u}; slotI < slotN; ++slotI)
+        {
+            if (slots[slotI])
+            {
+                const MapIterator & element{elements[slots[slotI] - 1u]};
+                forward(*element, _keys + slotI, _values + slotI);
+            }
+            else
+            {
+                _raw(_keys[slotI]) = _vacantKey;
+            }
+        }
+
+        if (_haveSpecial)
+        {
+            forward(*special, _keys + slotN, _values + slotN);
+        }
+
+        for (u64 stashI{0u}; stashI < _stashN; ++stashI)
+        {
+            forward(*elements[stash[stashI]], _keys + slotN + 1u + stashI, _values + slotN + 1u + stashI);
+        }
+
+        _size = elements.size() + _haveSpecial;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool FrozenRawMap<K, V, H, A>::_place(const std::vector<u64> & mixedHashes, std::vector<u64> & slots, std::vector<u64> & stash) const
+    {
+        slots.assign(_slotN(), 0u);
+        stash.clear();
+
+        std::vector<u8> fillNs(_bucketN, 0u);
+        u64 random{0x9E3779B97F4A7C15u};
+
+        for (u64 elementI{0u}; elementI < mixedHashes.size(); ++elementI)
+        {
+            u64 homeless{elementI + 1u};
+
+            for (u64 kickI{0u}; homeless; ++kickI)
+            {
+                const u64 mixedHash{mixedHashes[homeless - 1u]};
+                const u64 bucket1I{_bucket1(mixedHash)};
+                const u64 bucket2I{_bucket2(mixedHash)};
+
+                // Favor the first bucket so that lookups mostly find their key there
+                const u64 bucketI{fillNs[bucket1I] < _bucketWidth ? bucket1I : bucket2I};
+                if (fillNs[bucketI] < _bucketWidth)
+                {
+                    slots[bucketI * _bucketWidth + fillNs[bucketI]] = homeless;
+                    ++fillNs[bucketI];
+                    homeless = 0u;
+                    break;
+                }
+
+                if (kickI == _maxKickN)
+                {
+                    stash.push_back(homeless - 1u);
+                    break;
+                }
+
+                // Otherwise evict an element at random from either bucket, and find it a new home
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                const u64 evictI{(random & 1u ? bucket2I : bucket1I) * _bucketWidth + (random >> 1) % _bucketWidth};
+                std::swap(homeless, slots[evictI]);
+            }
+        }
+
+        return stash.size() <= _maxStashN;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void FrozenRawMap<K, V, H, A>::_allocate()
+    {
+        _LineAllocator lineAlloc{_alloc};
+        _Line * const lines{std::allocator_traits<_LineAllocator>::allocate(lineAlloc, _lineN())};
+
+        _keys = reinterpret_cast<K *>(lines);
+
+        if constexpr (_isMap)
+        {
+            _values = reinterpret_cast<_Value *>(lines + (_totalSlotN() * sizeof(K) + sizeof(_Line) - 1u) / sizeof(_Line));
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void FrozenRawMap<K, V, H, A>::_deallocate()
+    {
+        _LineAllocator lineAlloc{_alloc};
+        std::allocator_traits<_LineAllocator>::deallocate(lineAlloc, reinterpret_cast<_Line *>(_keys), _lineN());
+        _keys = nullptr;
+        _values = nullptr;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void FrozenRawMap<K, V, H, A>::_destroy()
+    {
+        if (!_keys)
+        {
+            return;
+        }
+
+        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        {
+            const u64 totalSlotN{_totalSlotN()};
+            for (u64 slotI{0u}; slotI < totalSlotN; ++slotI)
+            {
+                if (_isPresent(slotI))
+                {
+                    std::allocator_traits<A>::destroy(_alloc, _keys + slotI);
+
+                    if constexpr (_isMap)
+                    {
+                        std::allocator_traits<A>::destroy(_alloc, _values + slotI);
+                    }
+                }
+            }
+        }
+
+        _deallocate();
+        _size = {};
+        _bucketN = {};
+        _stashN = {};
+        _haveSpecial = {};
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void FrozenRawMap<K, V, H, A>::_copy(const FrozenRawMap & other)
+    {
+        if (!other._keys)
+        {
+            return;
+        }
+
+        _bucketN = other._bucketN;
+        _stashN = other._stashN;
+        _haveSpecial = other._haveSpecial;
+        _allocate();
+
+        const u64 totalSlotN{_totalSlotN()};
+        for (u64 slotI{0u}; slotI < totalSlotN; ++slotI)
+        {
+            if (other._isPresent(slotI))
+            {
+                std::allocator_traits<A>::construct(_alloc, _keys + slotI, other._keys[slotI]);
+
+                if constexpr (_isMap)
+                {
+                    std::allocator_traits<A>::construct(_alloc, _values + slotI, other._values[slotI]);
+                }
+            }
+            else
+            {
+                _raw(_keys[slotI]) = _vacantKey;
+            }
+        }
+
+        _size = other._size;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline void FrozenRawMap<K, V, H, A>::_move(FrozenRawMap & other)
+    {
+        _size = std::exchange(other._size, 0u);
+        _bucketN = std::exchange(other._bucketN, 0u);
+        _stashN = std::exchange(other._stashN, 0u);
+        _haveSpecial = std::exchange(other._haveSpecial, false);
+        _keys = std::exchange(other._keys, nullptr);
+        _values = std::exchange(other._values, nullptr);
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    template <Compatible<K> K_>
+    inline u64 FrozenRawMap<K, V, H, A>::_findSlot(const K_ & key) const
+    {
+        if constexpr (!Rawable<K_>)
+        {
+            return _findSlot(K(key));
+        }
+        else
+        {
+            const _RawKey & rawKey{_raw(key)};
+            const u64 slotN{_slotN()};
+
+            // Special key case
+            if (rawKey == _vacantKey) [[unlikely]]
+            {
+                return _haveSpecial ? slotN : _totalSlotN();
+            }
+
+            const u64 mixedHash{_mixedHash(key)};
+
+            // Most keys are placed in their first bucket, so it is checked alone first
+            const u64 bucket1I{_bucket1(mixedHash)};
+            if (const u64 mask{_matchMask(rawKey, bucket1I)}; mask)
+            {
+                return bucket1I * _bucketWidth + u64(std::countr_zero(mask)) / _maskStride;
+            }
+
+            // A key only goes elsewhere once its first bucket is full, and buckets fill front to back and never empty, so
+            // a vacant last slot means the key is absent
+            if (_raw(_keys[bucket1I * _bucketWidth + _bucketWidth - 1u]) == _vacantKey)
+            {
+                return _totalSlotN();
+            }
+
+            const u64 bucket2I{_bucket2(mixedHash)};
+            if (const u64 mask{_matchMask(rawKey, bucket2I)}; mask)
+            {
+                return bucket2I * _bucketWidth + u64(std::countr_zero(mask)) / _maskStride;
+            }
+
+            // Stash case
+            if (_stashN) [[unlikely]]
+            {
+                for (u64 slotI{slotN + 1u}; slotI < _totalSlotN(); ++slotI)
+                {
+                    if (_raw(_keys[slotI]) == rawKey)
+                    {
+                        return slotI;
+                    }
+                }
+            }
+
+            return _totalSlotN();
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline u64 FrozenRawMap<K, V, H, A>::_matchMask(const _RawKey & rawKey, const u64 bucketI) const
+    {
+        const _RawKey * const rawKeys{reinterpret_cast<const _RawKey *>(_keys) + bucketI * _bucketWidth};
+        u64 mask{0u};
+
+        #ifdef QC_HASH_SSE2_ENABLED
+            if constexpr (_isSimdProbable)
+            {
+                constexpr u64 laneN{_private::simd::blockSize / sizeof(_RawKey)};
+
+                for (u64 laneI{0u}; laneI < _bucketWidth; laneI += laneN)
+                {
+                    mask |= u64{_private::simd::matchMask(_private::simd::load(rawKeys + laneI), rawKey)} << (laneI * sizeof(_RawKey));
+                }
+
+                return mask;
+            }
+            else
+        #endif
+        {
+            for (u64 laneI{0u}; laneI < _bucketWidth; ++laneI)
+            {
+                mask |= u64{rawKeys[laneI] == rawKey} << laneI;
+            }
+
+            return mask;
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline constexpr FrozenRawMap<K, V, H, A>::_Iterator::_Iterator(const FrozenRawMap * const map, const u64 slotI) :
+        _map{map},
+        _slotI{slotI}
+    {}
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::_Iterator::operator*() const -> reference
+    {
+        if constexpr (_isSet)
+        {
+            return _map->_keys[_slotI];
+        }
+        else
+        {
+            return reference{_map->_keys[_slotI], _map->_values[_slotI]};
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::_Iterator::operator->() const -> pointer
+    {
+        if constexpr (_isSet)
+        {
+            return _map->_keys + _slotI;
+        }
+        else
+        {
+            return pointer{**this};
+        }
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::_Iterator::operator++() -> _Iterator &
+    {
+        const u64 totalSlotN{_map->_totalSlotN()};
+
+        do
+        {
+            ++_slotI;
+        } while (_slotI < totalSlotN && !_map->_isPresent(_slotI));
+
+        if (_slotI == totalSlotN)
+        {
+            *this = _Iterator{};
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline auto FrozenRawMap<K, V, H, A>::_Iterator::operator++(int) -> _Iterator
+    {
+        const _Iterator temp{*this};
+        operator++();
+        return temp;
+    }
+
+    template <Rawable K, typename V, typename H, typename A>
+    inline bool FrozenRawMap<K, V, H, A>::_Iterator::operator==(const _Iterator & other) const
+    {
+        return _map == other._map && _slotI == other._slotI;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline InlineRawMap<K, V, N, H, A, P>::InlineRawMap(const H & hash, const A & alloc) :
+        _inlineN{},
+        _spilled{},
+        _keys{},
+        _map{minMapCapacity, hash, alloc}
+    {}
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline InlineRawMap<K, V, N, H, A, P>::InlineRawMap(const std::initializer_list<value_type> elements, const H & hash, const A & alloc) :
+        InlineRawMap{hash, alloc}
+    {
+        for (const value_type & element : elements)
+        {
+            insert(element);
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline InlineRawMap<K, V, N, H, A, P>::InlineRawMap(const InlineRawMap & other) :
+        _inlineN{},
+        _spilled{other._spilled},
+        _keys{},
+        _map{other._map}
+    {
+        _takeInline(other);
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline InlineRawMap<K, V, N, H, A, P>::InlineRawMap(InlineRawMap && other) :
+        _inlineN{},
+        _spilled{std::exchange(other._spilled, false)},
+        _keys{},
+        _map{std::move(other._map)}
+    {
+        _takeInline(std::move(other));
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::operator=(const InlineRawMap & other) -> InlineRawMap &
+    {
+        if (&other != this)
+        {
+            _destroyInline();
+            _map = other._map;
+            _spilled = other._spilled;
+            _takeInline(other);
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::operator=(InlineRawMap && other) -> InlineRawMap &
+    {
+        if (&other != this)
+        {
+            _destroyInline();
+            _map = std::move(other._map);
+            _spilled = std::exchange(other._spilled, false);
+            _takeInline(std::move(other));
+        }
+
+        return *this;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline InlineRawMap<K, V, N, H, A, P>::~InlineRawMap()
+    {
+        _destroyInline();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::insert(const value_type & element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
+        {
+            return _tryEmplace(element);
+        }
+        else
+        {
+            return _tryEmplace(element.first, element.second);
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::insert(value_type && element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
+        {
+            return _tryEmplace(std::move(element));
+        }
+        else
+        {
+            return _tryEmplace(std::move(element.first), std::move(element.second));
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_, typename V_>
+    inline auto InlineRawMap<K, V, N, H, A, P>::emplace(K_ && key, V_ && value) -> std::pair<iterator, bool> requires (_isMap)
+    {
+        return _tryEmplace(std::forward<K_>(key), std::forward<V_>(value));
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline auto InlineRawMap<K, V, N, H, A, P>::try_emplace(K_ && key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
+    {
+        static_assert(_isSet == (sizeof...(VArgs) == 0u), "Value arguments are required for maps and forbidden for sets");
+
+        return _tryEmplace(std::forward<K_>(key), std::forward<VArgs>(valueArgs)...);
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool InlineRawMap<K, V, N, H, A, P>::erase(const K_ & key)
+    {
+        if (_spilled)
+        {
+            return _map.erase(key);
+        }
+
+        const u64 i{_findInline(key)};
+        if (i >= _inlineN)
+        {
+            return false;
+        }
+
+        _eraseInline(i);
+        return true;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::erase(const iterator position)
+    {
+        if (position._owner)
+        {
+            _eraseInline(position._i);
+        }
+        else
+        {
+            _map.erase(position._it);
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::clear()
+    {
+        _destroyInline();
+        _map.clear();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline bool InlineRawMap<K, V, N, H, A, P>::contains(const K_ & key) const
+    {
+        return _spilled ? _map.contains(key) : _containsInline(key);
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline u64 InlineRawMap<K, V, N, H, A, P>::count(const K_ & key) const
+    {
+        return contains(key);
+    }
+
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<V> InlineRawMap<K, V, N, H, A, P>::at(const K_ & key) requires (_isMap)
+        {
+            return const_cast<V &>(static_cast<const InlineRawMap *>(this)->at(key));
+        }
 
-    // Same as `std::string` specialization
-    template <> struct FastHash<std::string_view> : FastHash<std::string> {};
+        template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<const V> InlineRawMap<K, V, N, H, A, P>::at(const K_ & key) const requires (_isMap)
+        {
+            if (_spilled)
+            {
+                return _map.at(key);
+            }
+
+            const u64 i{_findInline(key)};
+            if (i >= _inlineN)
+            {
+                throw std::out_of_range{"Element not found"};
+            }
+
+            return _value(i);
+        }
+    #endif
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_>
+    inline std::add_lvalue_reference_t<V> InlineRawMap<K, V, N, H, A, P>::operator[](K_ && key) requires (_isMap)
+    {
+        return (*_tryEmplace(std::forward<K_>(key)).first).second;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto InlineRawMap<K, V, N, H, A, P>::find(const K_ & key) -> iterator
+    {
+        if (_spilled)
+        {
+            return iterator{_map.find(key)};
+        }
+
+        const u64 i{_findInline(key)};
+        return i < _inlineN ? iterator{this, i} : end();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <Compatible<K> K_>
+    inline auto InlineRawMap<K, V, N, H, A, P>::find(const K_ & key) const -> const_iterator
+    {
+        if (_spilled)
+        {
+            return const_iterator{_map.find(key)};
+        }
+
+        const u64 i{_findInline(key)};
+        return i < _inlineN ? const_iterator{this, i} : end();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::begin() -> iterator
+    {
+        if (_spilled)
+        {
+            return iterator{_map.begin()};
+        }
+
+        return _inlineN ? iterator{this, 0u} : end();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::begin() const -> const_iterator
+    {
+        if (_spilled)
+        {
+            return const_iterator{_map.begin()};
+        }
+
+        return _inlineN ? const_iterator{this, 0u} : end();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::cbegin() const -> const_iterator
+    {
+        return begin();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::end() -> iterator
+    {
+        return iterator{};
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::end() const -> const_iterator
+    {
+        return const_iterator{};
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::cend() const -> const_iterator
+    {
+        return end();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::swap(InlineRawMap & other)
+    {
+        InlineRawMap temp{std::move(other)};
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline u64 InlineRawMap<K, V, N, H, A, P>::size() const
+    {
+        // The inline count is zero once spilled, and the table is empty until then
+        return _inlineN + _map.size();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline bool InlineRawMap<K, V, N, H, A, P>::empty() const
+    {
+        return !size();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline bool InlineRawMap<K, V, N, H, A, P>::spilled() const
+    {
+        return _spilled;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline const H & InlineRawMap<K, V, N, H, A, P>::hash_function() const
+    {
+        return _map.hash_function();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline const A & InlineRawMap<K, V, N, H, A, P>::get_allocator() const
+    {
+        return _map.get_allocator();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline K & InlineRawMap<K, V, N, H, A, P>::_key(const u64 i)
+    {
+        return reinterpret_cast<K *>(_keys)[i];
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline const K & InlineRawMap<K, V, N, H, A, P>::_key(const u64 i) const
+    {
+        return reinterpret_cast<const K *>(_keys)[i];
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_value(const u64 i) -> _Value &
+    {
+        return reinterpret_cast<_Value *>(_values)[i];
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_value(const u64 i) const -> const _Value &
+    {
+        return reinterpret_cast<const _Value *>(_values)[i];
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_>
+    inline u64 InlineRawMap<K, V, N, H, A, P>::_findInline(const K_ & key) const
+    {
+        if constexpr (!Rawable<K_>)
+        {
+            return _findInline(K(key));
+        }
+        else
+        {
+            const _RawKey & rawKey{_raw(key)};
+
+            if (!_inlineN)
+            {
+                return 0u;
+            }
+
+            #ifdef QC_HASH_SSE2_ENABLED
+                if constexpr (_isSimdScannable)
+                {
+                    constexpr u64 blockLaneN{_private::simd::blockSize / sizeof(_RawKey)};
+
+                    u64 mask{0u};
+                    for (u64 laneI{0u}; laneI < _laneN; laneI += blockLaneN)
+                    {
+                        mask |= u64{_private::simd::matchMask(_private::simd::load(_keys + laneI), rawKey)} << (laneI * sizeof(_RawKey));
+                    }
+
+                    // No match gives 64 trailing zeros, which is past every lane
+                    return u64(std::countr_zero(mask)) / sizeof(_RawKey);
+                }
+                else
+            #endif
+            {
+                for (u64 i{0u}; i < _inlineN; ++i)
+                {
+                    if (_keys[i] == rawKey)
+                    {
+                        return i;
+                    }
+                }
+
+                return _inlineN;
+            }
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_>
+    inline bool InlineRawMap<K, V, N, H, A, P>::_containsInline(const K_ & key) const
+    {
+        if constexpr (!Rawable<K_>)
+        {
+            return _containsInline(K(key));
+        }
+        else
+        {
+            #ifdef QC_HASH_SSE2_ENABLED
+                if constexpr (_isSimdScannable)
+                {
+                    const _RawKey & rawKey{_raw(key)};
+                    return _inlineN && _private::simd::matchAny<_laneN * sizeof(_RawKey) / _private::simd::blockSize>(_keys, rawKey);
+                }
+                else
+            #endif
+            {
+                return _findInline(key) < _inlineN;
+            }
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::_fillUnusedLanes()
+    {
+        if (_inlineN)
+        {
+            for (u64 laneI{_inlineN}; laneI < _laneN; ++laneI)
+            {
+                _keys[laneI] = _keys[0];
+            }
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename K_, typename... VArgs>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_tryEmplace(K_ && key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
+    {
+        if (!_spilled)
+        {
+            const u64 i{_findInline(key)};
+            if (i < _inlineN)
+            {
+                return {iterator{this, i}, false};
+            }
+
+            if (_inlineN < N)
+            {
+                std::construct_at(&_key(_inlineN), std::forward<K_>(key));
+                if constexpr (_isMap)
+                {
+                    std::construct_at(&_value(_inlineN), std::forward<VArgs>(valueArgs)...);
+                }
+
+                if (!_inlineN++)
+                {
+                    _fillUnusedLanes();
+                }
+
+                return {iterator{this, _inlineN - 1u}, true};
+            }
+
+            _spill();
+        }
+
+        const auto [it, inserted]{_map.try_emplace(std::forward<K_>(key), std::forward<VArgs>(valueArgs)...)};
+        return {iterator{it}, inserted};
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::_spill()
+    {
+        _map.reserve(N * 2u);
+
+        for (u64 i{0u}; i < _inlineN; ++i)
+        {
+            if constexpr (_isSet)
+            {
+                _map.insert(std::move(_key(i)));
+            }
+            else
+            {
+                _map.try_emplace(std::move(_key(i)), std::move(_value(i)));
+            }
+        }
+
+        _destroyInline();
+        _spilled = true;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::_eraseInline(const u64 i)
+    {
+        const u64 lastI{--_inlineN};
+
+        if (i != lastI)
+        {
+            _key(i) = std::move(_key(lastI));
+            if constexpr (_isMap)
+            {
+                _value(i) = std::move(_value(lastI));
+            }
+        }
+
+        std::destroy_at(&_key(lastI));
+        if constexpr (_isMap)
+        {
+            std::destroy_at(&_value(lastI));
+        }
+        _fillUnusedLanes();
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline void InlineRawMap<K, V, N, H, A, P>::_destroyInline()
+    {
+        for (u64 i{0u}; i < _inlineN; ++i)
+        {
+            std::destroy_at(&_key(i));
+            if constexpr (_isMap)
+            {
+                std::destroy_at(&_value(i));
+            }
+        }
+
+        _inlineN = 0u;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <typename Other>
+    inline void InlineRawMap<K, V, N, H, A, P>::_takeInline(Other && other)
+    {
+        constexpr bool move{!std::is_lvalue_reference_v<Other>};
+
+        for (u64 i{0u}; i < other._inlineN; ++i)
+        {
+            if constexpr (move)
+            {
+                std::construct_at(&_key(i), std::move(other._key(i)));
+                if constexpr (_isMap)
+                {
+                    std::construct_at(&_value(i), std::move(other._value(i)));
+                }
+            }
+            else
+            {
+                std::construct_at(&_key(i), other._key(i));
+                if constexpr (_isMap)
+                {
+                    std::construct_at(&_value(i), other._value(i));
+                }
+            }
+        }
+
+        _inlineN = other._inlineN;
+        _fillUnusedLanes();
+
+        if constexpr (move)
+        {
+            other._destroyInline();
+        }
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    inline bool operator==(const InlineRawMap<K, V, N, H, A, P> & m1, const InlineRawMap<K, V, N, H, A, P> & m2)
+    {
+        if (m1.size() != m2.size())
+        {
+            return false;
+        }
+
+        if (&m1 == &m2)
+        {
+            return true;
+        }
+
+        for (const auto & element : m1)
+        {
+            if constexpr (std::is_same_v<V, void>)
+            {
+                if (!m2.contains(element))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                const auto it{m2.find(element.first)};
+                if (it == m2.end() || it->second != element.second)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_> requires (constant && !constant_)
+    inline constexpr InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other) :
+        _owner{other._owner},
+        _i{other._i},
+        _it{other._it}
+    {}
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline constexpr InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::_Iterator(_Owner * const owner, const u64 i) :
+        _owner{owner},
+        _i{i}
+    {}
+
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline constexpr InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::_Iterator(const _MapIterator it) :
+        _it{it}
+    {}
 
-    namespace fastHash
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::operator*() const -> reference
     {
-        template <typename H> struct Constants;
-        template <> struct Constants<u64> { inline static constexpr u64 m{0xC6A4A7935BD1E995u}; inline static constexpr s32 r{47}; };
-        template <> struct Constants<u32> { inline static constexpr u32 m{0x5BD1E995u};         inline static constexpr s32 r{24}; };
-        template <typename H> inline constexpr H m{Constants<H>::m};
-        template <typename H> inline constexpr s32 r{Constants<H>::r};
-
-        template <UnsignedInteger H>
-        inline constexpr H mix(H v)
+        if (_owner)
         {
-            v *= m<H>;
-            v ^= v >> r<H>;
-            return v * m<H>;
+            if constexpr (_isSet)
+            {
+                return _owner->_key(_i);
+            }
+            else
+            {
+                return reference{_owner->_key(_i), _owner->_value(_i)};
+            }
         }
-
-        template <UnsignedInteger H, typename T>
-        inline constexpr H hash(const T & v)
+        else
         {
-            // IMPORTANT: These two cases must yield the same hash for the same input bytes
-
-            // Optimized case if the size of the key is less than or equal to the size of the hash
-            if constexpr (sizeof(T) <= sizeof(H))
+            if constexpr (_isSet)
             {
-                return (H(sizeof(T)) * m<H>) ^ mix(_private::getLowBytes<H>(v));
+                return *_it;
             }
-            // General case
             else
             {
-                return hash<H>(&v, sizeof(T));
+                // Works with both a pair and split storage's proxy
+                auto && element{*_it};
+                return reference{element.first, element.second};
             }
         }
+    }
 
-        // Based on Murmur2, but simplified, and doesn't require unaligned reads
-        template <UnsignedInteger H>
-        inline H hash(const void * const data, u64 length)
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::operator->() const -> pointer
+    {
+        if constexpr (_isSet)
         {
-            const std::byte * bytes{static_cast<const std::byte *>(data)};
-            H h{H(length)};
-
-            // Mix in `H` bytes worth at a time
-            while (length >= sizeof(H))
-            {
-                H w;
-                std::memcpy(&w, bytes, sizeof(H));
-
-                h *= m<H>;
-                h ^= mix(w);
-
-                bytes += sizeof(H);
-                length -= sizeof(H);
-            };
+            return &**this;
+        }
+        else
+        {
+            return pointer{**this};
+        }
+    }
 
-            // Mix in the last few bytes
-            if (length)
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::operator++() -> _Iterator &
+    {
+        if (_owner)
+        {
+            // Past the last inline element becomes the end iterator
+            if (++_i == _owner->_inlineN)
             {
-                H w{0u};
-                std::memcpy(&w, bytes, length);
-
-                h *= m<H>;
-                h ^= mix(w);
+                _owner = nullptr;
+                _i = 0u;
             }
-
-            return h;
         }
+        else
+        {
+            ++_it;
+        }
+
+        return *this;
     }
 
-    template <typename K>
-    inline RawType<K> & _raw(K & key)
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    inline auto InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::operator++(int) -> _Iterator
     {
-        return reinterpret_cast<RawType<K> &>(key);
+        const _Iterator temp{*this};
+        operator++();
+        return temp;
     }
 
-    template <typename K>
-    inline const RawType<K> & _raw(const K & key)
+    template <Rawable K, typename V, u64 N, typename H, typename A, typename P>
+    template <bool constant>
+    template <bool constant_>
+    inline bool InlineRawMap<K, V, N, H, A, P>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
     {
-        return reinterpret_cast<const RawType<K> &>(key);
+        return _owner == other._owner && _i == other._i && _it == other._it;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const u64 capacity, const H & hash, const A & alloc):
+    template <typename K, typename V, typename H, typename A>
+    inline MetaMap<K, V, H, A>::MetaMap(const u64 capacity, const H & hash, const A & alloc) :
         _size{},
-        _slotN{capacity <= minMapCapacity ? _private::minMapSlotN : std::bit_ceil(capacity << 1)},
-        _elements{},
-        _haveSpecial{},
+        _slotN{_slotNFor(capacity)},
+        _graveN{},
+        _controls{},
+        _slots{},
         _hash{hash},
         _alloc{alloc}
     {}
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const u64 capacity, const A & alloc) :
-        RawMap{capacity, H{}, alloc}
-    {}
-
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const A & alloc) :
-        RawMap{minMapCapacity, H{}, alloc}
-    {}
-
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename It>
-    inline RawMap<K, V, H, A>::RawMap(const It first, const It last, const u64 capacity, const H & hash, const A & alloc) :
-        RawMap{capacity, hash, alloc}
-    {
-        // Count number of elements to insert
-        u64 n{};
-        for (It it{first}; it != last; ++it, ++n);
-
-        reserve(n);
-
-        insert(first, last);
-    }
-
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename It>
-    inline RawMap<K, V, H, A>::RawMap(const It first, const It last, const u64 capacity, const A & alloc) :
-        RawMap{first, last, capacity, H{}, alloc}
-    {}
-
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const std::initializer_list<E> elements, u64 capacity, const H & hash, const A & alloc) :
-        RawMap{capacity ? capacity : elements.size(), hash, alloc}
+    template <typename K, typename V, typename H, typename A>
+    inline MetaMap<K, V, H, A>::MetaMap(const std::initializer_list<E> elements, const u64 capacity, const H & hash, const A & alloc) :
+        MetaMap{capacity > elements.size() ? capacity : elements.size(), hash, alloc}
     {
-        insert(elements);
+        for (const E & element : elements)
+        {
+            insert(element);
+        }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const std::initializer_list<E> elements, const u64 capacity, const A & alloc) :
-        RawMap{elements, capacity, H{}, alloc}
-    {}
-
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(const RawMap & other) :
+    template <typename K, typename V, typename H, typename A>
+    inline MetaMap<K, V, H, A>::MetaMap(const MetaMap & other) :
         _size{other._size},
         _slotN{other._slotN},
-        _elements{},
-        _haveSpecial{other._haveSpecial[0], other._haveSpecial[1]},
+        _graveN{other._graveN},
+        _controls{},
+        _slots{},
         _hash{other._hash},
         _alloc{std::allocator_traits<A>::select_on_container_copy_construction(other._alloc)}
     {
-        if (_size)
+        if (other._slots)
         {
-            _allocate<false>();
-            _forwardData<false>(other);
+            _allocate();
+            std::memcpy(_controls, other._controls, _slotN);
+
+            for (u64 slotI{0u}; slotI < _slotN; ++slotI)
+            {
+                if (_controls[slotI] < _emptyControl)
+                {
+                    _slots[slotI].hash = other._slots[slotI].hash;
+                    std::allocator_traits<A>::construct(_alloc, &_slots[slotI].element, other._slots[slotI].element);
+                }
+            }
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::RawMap(RawMap && other) :
+    template <typename K, typename V, typename H, typename A>
+    inline MetaMap<K, V, H, A>::MetaMap(MetaMap && other) :
         _size{std::exchange(other._size, 0u)},
-        _slotN{std::exchange(other._slotN, _private::minMapSlotN)},
-        _elements{std::exchange(other._elements, nullptr)},
-        _haveSpecial{std::exchange(other._haveSpecial[0], false), std::exchange(other._haveSpecial[1], false)},
+        _slotN{std::exchange(other._slotN, _slotNFor(minMapCapacity))},
+        _graveN{std::exchange(other._graveN, 0u)},
+        _controls{std::exchange(other._controls, nullptr)},
+        _slots{std::exchange(other._slots, nullptr)},
         _hash{std::move(other._hash)},
         _alloc{std::move(other._alloc)}
     {}
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A> & RawMap<K, V, H, A>::operator=(const std::initializer_list<E> elements)
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::operator=(const MetaMap & other) -> MetaMap &
     {
-        return *this = RawMap(elements);
+        if (&other != this)
+        {
+            MetaMap copy{other};
+            swap(copy);
+        }
+
+        return *this;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A> & RawMap<K, V, H, A>::operator=(const RawMap & other)
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::operator=(MetaMap && other) -> MetaMap &
     {
-        if (&other == this)
+        if (&other != this)
         {
-            return *this;
+            MetaMap moved{std::move(other)};
+            swap(moved);
         }
 
-        if (_elements)
+        return *this;
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline MetaMap<K, V, H, A>::~MetaMap()
+    {
+        if (_slots)
         {
-            _clear<false>();
-            if (!other._size || _slotN != other._slotN || _alloc != other._alloc)
-            {
-                _deallocate();
-            }
+            _destroyElements();
+            _deallocate();
         }
+    }
 
-        _size = other._size;
-        _slotN = other._slotN;
-        _haveSpecial[0] = other._haveSpecial[0];
-        _haveSpecial[1] = other._haveSpecial[1];
-        _hash = other._hash;
-        if constexpr (std::allocator_traits<A>::propagate_on_container_copy_assignment::value)
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::insert(const E & element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
         {
-            _alloc = std::allocator_traits<A>::select_on_container_copy_construction(other._alloc);
+            return _tryEmplace(element);
         }
-
-        if (_size)
+        else
         {
-            if (!_elements)
-            {
-                _allocate<false>();
-            }
+            return _tryEmplace(element.first, element.second);
+        }
+    }
 
-            _forwardData<false>(other);
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::insert(E && element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
+        {
+            return _tryEmplace(std::move(element));
+        }
+        else
+        {
+            return _tryEmplace(std::move(element.first), std::move(element.second));
         }
+    }
 
-        return *this;
+    template <typename K, typename V, typename H, typename A>
+    template <typename K_, typename V_>
+    inline auto MetaMap<K, V, H, A>::emplace(K_ && key, V_ && value) -> std::pair<iterator, bool> requires (_isMap)
+    {
+        return _tryEmplace(std::forward<K_>(key), std::forward<V_>(value));
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A> & RawMap<K, V, H, A>::operator=(RawMap && other)
+    template <typename K, typename V, typename H, typename A>
+    template <typename K_, typename... VArgs>
+    inline auto MetaMap<K, V, H, A>::try_emplace(K_ && key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
     {
-        if (&other == this)
+        static_assert(_isSet == (sizeof...(VArgs) == 0u), "Value arguments are required for maps and forbidden for sets");
+
+        return _tryEmplace(std::forward<K_>(key), std::forward<VArgs>(valueArgs)...);
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline bool MetaMap<K, V, H, A>::erase(const lookup_type key)
+    {
+        if (!_size)
         {
-            return *this;
+            return false;
         }
 
-        if (_elements)
+        const u64 slotI{_findSlot(key, _hash(key))};
+        if (slotI == _slotN)
         {
-            _clear<false>();
-            _deallocate();
+            return false;
         }
 
-        _size = other._size;
-        _slotN = other._slotN;
-        _haveSpecial[0] = other._haveSpecial[0];
-        _haveSpecial[1] = other._haveSpecial[1];
-        _hash = std::move(other._hash);
-        if constexpr (std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+        _eraseSlot(slotI);
+        return true;
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::erase(const iterator position)
+    {
+        _eraseSlot(u64(position._control - _controls));
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::clear()
+    {
+        if (_slots)
         {
-            _alloc = std::move(other._alloc);
+            _destroyElements();
+            std::memset(_controls, _emptyControl, _slotN);
         }
 
-        if (_alloc == other._alloc || std::allocator_traits<A>::propagate_on_container_move_assignment::value)
+        _size = 0u;
+        _graveN = 0u;
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline bool MetaMap<K, V, H, A>::contains(const lookup_type key) const
+    {
+        return _size ? _findSlot(key, _hash(key)) < _slotN : false;
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::count(const lookup_type key) const
+    {
+        return contains(key);
+    }
+
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        template <typename K, typename V, typename H, typename A>
+        inline std::add_lvalue_reference_t<V> MetaMap<K, V, H, A>::at(const lookup_type key) requires (_isMap)
         {
-            _elements = std::exchange(other._elements, nullptr);
-            other._size = {};
+            return const_cast<V &>(static_cast<const MetaMap *>(this)->at(key));
         }
-        else
+
+        template <typename K, typename V, typename H, typename A>
+        inline std::add_lvalue_reference_t<const V> MetaMap<K, V, H, A>::at(const lookup_type key) const requires (_isMap)
         {
-            if (_size)
+            if (!_size)
             {
-                _allocate<false>();
-                _forwardData<true>(other);
-                other._clear<false>();
-                other._size = 0u;
+                throw std::out_of_range{"Map is empty"};
             }
-            if (other._elements)
+
+            const u64 slotI{_findSlot(key, _hash(key))};
+
+            if (slotI == _slotN)
             {
-                other._deallocate();
+                throw std::out_of_range{"Element not found"};
             }
+
+            return _slots[slotI].element.second;
         }
+    #endif
 
-        other._slotN = _private::minMapSlotN;
-        other._haveSpecial[0] = false;
-        other._haveSpecial[1] = false;
+    template <typename K, typename V, typename H, typename A>
+    template <typename K_>
+    inline std::add_lvalue_reference_t<V> MetaMap<K, V, H, A>::operator[](K_ && key) requires (_isMap)
+    {
+        return _tryEmplace(std::forward<K_>(key)).first->second;
+    }
 
-        return *this;
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::find(const lookup_type key) -> iterator
+    {
+        return _size ? _iterator(_findSlot(key, _hash(key))) : end();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline RawMap<K, V, H, A>::~RawMap()
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::find(const lookup_type key) const -> const_iterator
     {
-        if (_elements)
+        return const_cast<MetaMap *>(this)->find(key);
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::begin() -> iterator
+    {
+        if (!_size)
         {
-            _clear<false>();
-            _deallocate();
+            return end();
         }
+
+        iterator it{_controls, _slots};
+        if (*_controls >= _emptyControl)
+        {
+            ++it;
+        }
+
+        return it;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::insert(const E & element) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::begin() const -> const_iterator
     {
-        static_assert(std::is_copy_constructible_v<E>);
+        return const_cast<MetaMap *>(this)->begin();
+    }
 
-        return emplace(element);
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::cbegin() const -> const_iterator
+    {
+        return begin();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::insert(E && element) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::end() -> iterator
     {
-        return emplace(std::move(element));
+        return iterator{};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename It>
-    inline void RawMap<K, V, H, A>::insert(It first, const It last)
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::end() const -> const_iterator
     {
-        while (first != last)
-        {
-            emplace(*first);
-            ++first;
-        }
+        return const_iterator{};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::insert(const std::initializer_list<E> elements)
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::cend() const -> const_iterator
     {
-        for (const E & element : elements)
-        {
-            emplace(element);
-        }
+        return end();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::emplace(const E & element) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::reserve(const u64 capacity)
     {
-        static_assert(std::is_copy_constructible_v<E>);
+        rehash(_slotNFor(capacity));
+    }
 
-        if constexpr (_isSet)
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::rehash(u64 slotN)
+    {
+        const u64 minSlotN{_slotNFor(_size)};
+        slotN = slotN > minSlotN ? std::bit_ceil(slotN) : minSlotN;
+
+        if (_slots)
         {
-            return try_emplace(element);
+            if (slotN != _slotN || _graveN)
+            {
+                _rehash(slotN);
+            }
         }
         else
         {
-            return try_emplace(element.first, element.second);
+            _slotN = slotN;
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::emplace(E && element) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::swap(MetaMap & other)
     {
-        if constexpr (_isSet)
-        {
-            return try_emplace(std::move(element));
-        }
-        else
+        std::swap(_size, other._size);
+        std::swap(_slotN, other._slotN);
+        std::swap(_graveN, other._graveN);
+        std::swap(_controls, other._controls);
+        std::swap(_slots, other._slots);
+        std::swap(_hash, other._hash);
+        if constexpr (std::allocator_traits<A>::propagate_on_container_swap::value)
         {
-            return try_emplace(std::move(element.first), std::move(element.second));
+            std::swap(_alloc, other._alloc);
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename K_, typename V_>
-    inline auto RawMap<K, V, H, A>::emplace(K_ && key, V_ && value) -> std::pair<iterator, bool> requires (!std::is_same_v<V, void>)
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::size() const
     {
-        return try_emplace(std::forward<K_>(key), std::forward<V_>(value));
+        return _size;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename... KArgs>
-    inline auto RawMap<K, V, H, A>::emplace(KArgs &&... keyArgs) -> std::pair<iterator, bool> requires (std::is_same_v<V, void>)
+    template <typename K, typename V, typename H, typename A>
+    inline bool MetaMap<K, V, H, A>::empty() const
     {
-        return try_emplace(K{std::forward<KArgs>(keyArgs)...});
+        return !_size;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename... KArgs, typename... VArgs>
-    inline auto RawMap<K, V, H, A>::emplace(const std::piecewise_construct_t, std::tuple<KArgs...> && keyArgs, std::tuple<VArgs...> && valueArgs) -> std::pair<iterator, bool> requires (!std::is_same_v<V, void>)
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::capacity() const
     {
-        return _emplace(std::move(keyArgs), std::move(valueArgs), std::index_sequence_for<KArgs...>(), std::index_sequence_for<VArgs...>());
+        return _slotN - _slotN / 8u;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename KTuple, typename VTuple, u64... kIndices, u64... vIndices>
-    inline auto RawMap<K, V, H, A>::_emplace(KTuple && kTuple, VTuple && vTuple, const std::index_sequence<kIndices...>, const std::index_sequence<vIndices...>) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::slot_n() const
     {
-        return try_emplace(K{std::move(std::get<kIndices>(kTuple))...}, std::move(std::get<vIndices>(vTuple))...);
+        return _slotN;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <typename K_, typename... VArgs>
-    inline auto RawMap<K, V, H, A>::try_emplace(K_ && key, VArgs &&... vArgs) -> std::pair<iterator, bool>
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::grave_n() const
     {
-        static_assert(!(_isMap && !sizeof...(VArgs) && !std::is_default_constructible_v<V>), "The value type must be default constructible in order to pass no value arguments");
-        static_assert(!(_isSet && sizeof...(VArgs)), "Sets do not have values");
-
-        // If we've yet to allocate memory, now is the time
-        if (!_elements)
-        {
-            _allocate<true>();
-        }
-
-        _FindKeyResult<true> findResult{_findKey<true>(key)};
-
-        // Key is already present
-        if (findResult.isPresent)
-        {
-            return {iterator{findResult.element}, false};
-        }
-
-        if (findResult.isSpecial) [[unlikely]]
-        {
-            _haveSpecial[findResult.specialI] = true;
-        }
-        else
-        {
-            // Rehash if we're at capacity
-            if ((_size - _haveSpecial[0] - _haveSpecial[1]) >= (_slotN >> 1)) [[unlikely]]
-            {
-                _rehash(_slotN << 1);
-                findResult = _findKey<true>(key);
-            }
-        }
+        return _graveN;
+    }
 
-        if constexpr (_isSet)
-        {
-            std::allocator_traits<A>::construct(_alloc, findResult.element, std::forward<K_>(key));
-        }
-        else
-        {
-            std::allocator_traits<A>::construct(_alloc, &findResult.element->first, std::forward<K_>(key));
-            std::allocator_traits<A>::construct(_alloc, &findResult.element->second, std::forward<VArgs>(vArgs)...);
-        }
+    template <typename K, typename V, typename H, typename A>
+    inline const H & MetaMap<K, V, H, A>::hash_function() const
+    {
+        return _hash;
+    }
 
-        ++_size;
+    template <typename K, typename V, typename H, typename A>
+    inline const A & MetaMap<K, V, H, A>::get_allocator() const
+    {
+        return _alloc;
+    }
 
-        return {iterator{findResult.element}, true};
+    template <typename K, typename V, typename H, typename A>
+    inline u8 MetaMap<K, V, H, A>::_tag(const u64 hash)
+    {
+        return u8(hash >> 57);
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline bool RawMap<K, V, H, A>::erase(const K_ & key)
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::_slotNFor(const u64 capacity)
     {
-        if (!_size)
+        u64 slotN{_groupWidth};
+        while (slotN - slotN / 8u < capacity)
         {
-            return false;
+            slotN <<= 1;
         }
 
-        const auto[element, isPresent]{_findKey<false>(key)};
+        return slotN;
+    }
 
-        if (isPresent)
+    template <typename K, typename V, typename H, typename A>
+    inline const K & MetaMap<K, V, H, A>::_key(const E & element)
+    {
+        if constexpr (_isSet)
         {
-            erase(iterator{element});
-            return true;
+            return element;
         }
         else
         {
-            return false;
+            return element.first;
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::erase(const iterator position)
+    template <typename K, typename V, typename H, typename A>
+    inline u32 MetaMap<K, V, H, A>::_matchGroup(const u8 * const group, const u8 control)
     {
-        E * const eraseElement{position._element};
-        _RawKey & rawKey{_raw(_key(*eraseElement))};
-        E * const specialElements{_elements + _slotN};
-
-        std::allocator_traits<A>::destroy(_alloc, eraseElement);
-
-        // General case
-        if (eraseElement < specialElements)
-        {
-            rawKey = _graveKey;
-        }
-        else [[unlikely]]
-        {
-            const auto specialI{eraseElement - specialElements};
-            _raw(_key(specialElements[specialI])) = _vacantSpecialKeys[specialI];
-            _haveSpecial[specialI] = false;
-        }
-
-        --_size;
+        #ifdef QC_HASH_SSE2_ENABLED
+            return _private::simd::matchMask(_private::simd::load(group), control);
+        #else
+            u32 mask{0u};
+            for (u64 i{0u}; i < _groupWidth; ++i)
+            {
+                mask |= u32{group[i] == control} << i;
+            }
+            return mask;
+        #endif
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::clear()
+    template <typename K, typename V, typename H, typename A>
+    inline u32 MetaMap<K, V, H, A>::_matchFree(const u8 * const group)
     {
-        _clear<true>();
+        #ifdef QC_HASH_SSE2_ENABLED
+            const _private::simd::Block block{_private::simd::load(group)};
+            return _private::simd::matchMask(block, _emptyControl) | _private::simd::matchMask(block, _graveControl);
+        #else
+            u32 mask{0u};
+            for (u64 i{0u}; i < _groupWidth; ++i)
+            {
+                mask |= u32{group[i] >= _emptyControl} << i;
+            }
+            return mask;
+        #endif
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool preserveInvariants>
-    inline void RawMap<K, V, H, A>::_clear()
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::_findSlot(const lookup_type key, const u64 hash) const
     {
-        if constexpr (std::is_trivially_destructible_v<E>)
+        const u8 tag{_tag(hash)};
+        const u64 groupMask{_slotN / _groupWidth - 1u};
+        u64 groupI{hash & groupMask};
+
+        for (u64 stepN{1u}; ; ++stepN)
         {
-            if constexpr (preserveInvariants)
+            const u8 * const group{_controls + groupI * _groupWidth};
+
+            for (u32 mask{_matchGroup(group, tag)}; mask; mask &= mask - 1u)
             {
-                if (_size)
+                const u64 slotI{groupI * _groupWidth + u64(std::countr_zero(mask))};
+                const _Slot & slot{_slots[slotI]};
+
+                // Only read the key's bytes once the full hash matches
+                if (slot.hash == hash && _key(slot.element) == key) [[likely]]
                 {
-                    _clearKeys();
-                    _size = {};
-                    _haveSpecial[0] = false;
-                    _haveSpecial[1] = false;
+                    return slotI;
                 }
             }
+
+            // A key is never placed past a group with an empty slot
+            if (_matchGroup(group, _emptyControl))
+            {
+                return _slotN;
+            }
+
+            groupI = (groupI + stepN) & groupMask;
         }
-        else
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline u64 MetaMap<K, V, H, A>::_findFreeSlot(const u64 hash) const
+    {
+        const u64 groupMask{_slotN / _groupWidth - 1u};
+        u64 groupI{hash & groupMask};
+
+        for (u64 stepN{1u}; ; ++stepN)
         {
-            if (_size)
+            const u32 mask{_matchFree(_controls + groupI * _groupWidth)};
+            if (mask)
             {
-                // General case
-                E * element{_elements};
-                u64 n{};
-                const u64 regularElementN{_size - _haveSpecial[0] - _haveSpecial[1]};
-                for (; n < regularElementN; ++element)
-                {
-                    _RawKey & rawKey{_raw(_key(*element))};
-                    if (_isPresent(rawKey))
-                    {
-                        std::allocator_traits<A>::destroy(_alloc, element);
-                        ++n;
-                    }
-                    if constexpr (preserveInvariants)
-                    {
-                        rawKey = _vacantKey;
-                    }
-                }
-                // Clear remaining graves
-                if constexpr (preserveInvariants)
-                {
-                    const E * const endRegularElement{_elements + _slotN};
-                    for (; element < endRegularElement; ++element)
-                    {
-                        _raw(_key(*element)) = _vacantKey;
-                    }
-                }
+                return groupI * _groupWidth + u64(std::countr_zero(mask));
+            }
 
-                // Special keys case
-                if (_haveSpecial[0]) [[unlikely]]
-                {
-                    element = _elements + _slotN;
-                    std::allocator_traits<A>::destroy(_alloc, element);
-                    if constexpr (preserveInvariants)
-                    {
-                        _raw(_key(*element)) = _vacantGraveKey;
-                        _haveSpecial[0] = false;
-                    }
-                }
-                if (_haveSpecial[1]) [[unlikely]]
-                {
-                    element = _elements + _slotN + 1;
-                    std::allocator_traits<A>::destroy(_alloc, element);
-                    if constexpr (preserveInvariants)
-                    {
-                        _raw(_key(*element)) = _vacantVacantKey;
-                        _haveSpecial[1] = false;
-                    }
-                }
+            groupI = (groupI + stepN) & groupMask;
+        }
+    }
 
-                if constexpr (preserveInvariants)
+    template <typename K, typename V, typename H, typename A>
+    template <typename K_, typename... VArgs>
+    inline auto MetaMap<K, V, H, A>::_tryEmplace(K_ && key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
+    {
+        const lookup_type keyView{key};
+        const u64 hash{_hash(keyView)};
+
+        if (_slots)
+        {
+            if (_size)
+            {
+                const u64 slotI{_findSlot(keyView, hash)};
+                if (slotI < _slotN)
                 {
-                    _size = {};
+                    return {_iterator(slotI), false};
                 }
             }
+
+            // Grow if at least three quarters of the capacity is live, otherwise just clear out the graves
+            if (_size + _graveN >= capacity()) [[unlikely]]
+            {
+                _rehash(_size >= capacity() - capacity() / 4u ? _slotN << 1 : _slotN);
+            }
+        }
+        else
+        {
+            _allocate();
         }
 
-    }
+        const u64 slotI{_findFreeSlot(hash)};
+        _Slot & slot{_slots[slotI]};
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline bool RawMap<K, V, H, A>::contains(const K_ & key) const
-    {
-        return _size ? _findKey<false>(key).isPresent : false;
+        if constexpr (_isSet)
+        {
+            std::allocator_traits<A>::construct(_alloc, &slot.element, std::forward<K_>(key));
+        }
+        else
+        {
+            std::allocator_traits<A>::construct(_alloc, &slot.element, std::piecewise_construct, std::forward_as_tuple(std::forward<K_>(key)), std::forward_as_tuple(std::forward<VArgs>(valueArgs)...));
+        }
+
+        slot.hash = hash;
+        _graveN -= _controls[slotI] == _graveControl;
+        _controls[slotI] = _tag(hash);
+        ++_size;
+
+        return {_iterator(slotI), true};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline u64 RawMap<K, V, H, A>::count(const K_ & key) const
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::_eraseSlot(const u64 slotI)
     {
-        return contains(key);
-    }
+        std::allocator_traits<A>::destroy(_alloc, &_slots[slotI].element);
+        --_size;
 
-    #ifdef QC_HASH_EXCEPTIONS_ENABLED
-        template <Rawable K, typename V, typename H, typename A>
-        template <Compatible<K> K_>
-        inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A>::at(const K_ & key) requires (!std::is_same_v<V, void>)
+        // No key can have been placed past a group that has had an empty slot since the last rehash, so the slot may be
+        // left empty rather than as a grave
+        if (_matchGroup(_controls + slotI / _groupWidth * _groupWidth, _emptyControl))
         {
-            return const_cast<V &>(static_cast<const RawMap *>(this)->at(key));
+            _controls[slotI] = _emptyControl;
         }
-
-        template <Rawable K, typename V, typename H, typename A>
-        template <Compatible<K> K_>
-        inline std::add_lvalue_reference_t<const V> RawMap<K, V, H, A>::at(const K_ & key) const requires (!std::is_same_v<V, void>)
+        else
         {
-            if (!_size)
-            {
-                throw std::out_of_range{"Map is empty"};
-            }
+            _controls[slotI] = _graveControl;
+            ++_graveN;
+        }
+    }
 
-            const auto [element, isPresent]{_findKey<false>(key)};
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::_rehash(const u64 slotN)
+    {
+        u8 * const oldControls{_controls};
+        _Slot * const oldSlots{_slots};
+        const u64 oldSlotN{_slotN};
 
-            if (!isPresent)
+        _slotN = slotN;
+        _allocate();
+
+        // Each slot's cached hash places it without reading its key
+        for (u64 oldSlotI{0u}; oldSlotI < oldSlotN; ++oldSlotI)
+        {
+            if (oldControls[oldSlotI] < _emptyControl)
             {
-                throw std::out_of_range{"Element not found"};
+                _Slot & oldSlot{oldSlots[oldSlotI]};
+                const u64 slotI{_findFreeSlot(oldSlot.hash)};
+                _Slot & slot{_slots[slotI]};
+
+                std::allocator_traits<A>::construct(_alloc, &slot.element, std::move(oldSlot.element));
+                std::allocator_traits<A>::destroy(_alloc, &oldSlot.element);
+                slot.hash = oldSlot.hash;
+                _controls[slotI] = oldControls[oldSlotI];
             }
-
-            return element->second;
         }
-    #endif
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A>::operator[](const K_ & key) requires (!std::is_same_v<V, void>)
-    {
-        return try_emplace(key).first->second;
+        _graveN = 0u;
+
+        _ControlAllocator controlAlloc{_alloc};
+        _SlotAllocator slotAlloc{_alloc};
+        std::allocator_traits<_ControlAllocator>::deallocate(controlAlloc, oldControls, oldSlotN + 1u);
+        std::allocator_traits<_SlotAllocator>::deallocate(slotAlloc, oldSlots, oldSlotN);
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline std::add_lvalue_reference_t<V> RawMap<K, V, H, A>::operator[](K_ && key) requires (!std::is_same_v<V, void>)
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::_allocate()
     {
-        return try_emplace(std::move(key)).first->second;
+        _ControlAllocator controlAlloc{_alloc};
+        _SlotAllocator slotAlloc{_alloc};
+        _controls = std::allocator_traits<_ControlAllocator>::allocate(controlAlloc, _slotN + 1u);
+        _slots = std::allocator_traits<_SlotAllocator>::allocate(slotAlloc, _slotN);
+
+        std::memset(_controls, _emptyControl, _slotN);
+        _controls[_slotN] = _endControl;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::begin() -> iterator
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::_deallocate()
     {
-        return const_cast<E *>(static_cast<const RawMap *>(this)->begin()._element);
+        _ControlAllocator controlAlloc{_alloc};
+        _SlotAllocator slotAlloc{_alloc};
+        std::allocator_traits<_ControlAllocator>::deallocate(controlAlloc, _controls, _slotN + 1u);
+        std::allocator_traits<_SlotAllocator>::deallocate(slotAlloc, _slots, _slotN);
+        _controls = nullptr;
+        _slots = nullptr;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::begin() const -> const_iterator
+    template <typename K, typename V, typename H, typename A>
+    inline void MetaMap<K, V, H, A>::_destroyElements()
     {
-        // General case
-        if (_size - _haveSpecial[0] - _haveSpecial[1]) [[likely]]
+        for (u64 slotI{0u}; slotI < _slotN; ++slotI)
         {
-            for (const E * element{_elements}; ; ++element)
+            if (_controls[slotI] < _emptyControl)
             {
-                if (_isPresent(_raw(_key(*element))))
-                {
-                    return const_iterator{element};
-                }
+                std::allocator_traits<A>::destroy(_alloc, &_slots[slotI].element);
             }
         }
+    }
 
-        // Special key cases
-        if (_haveSpecial[0]) [[unlikely]]
+    template <typename K, typename V, typename H, typename A>
+    inline auto MetaMap<K, V, H, A>::_iterator(const u64 slotI) -> iterator
+    {
+        return slotI < _slotN ? iterator{_controls + slotI, _slots + slotI} : end();
+    }
+
+    template <typename K, typename V, typename H, typename A>
+    inline bool operator==(const MetaMap<K, V, H, A> & m1, const MetaMap<K, V, H, A> & m2)
+    {
+        if (m1.size() != m2.size())
         {
-            return const_iterator{_elements + _slotN};
+            return false;
         }
-        if (_haveSpecial[1]) [[unlikely]]
+
+        if (&m1 == &m2)
         {
-            return const_iterator{_elements + _slotN + 1};
+            return true;
         }
 
-        return end();
+        for (const auto & element : m1)
+        {
+            if constexpr (std::is_same_v<V, void>)
+            {
+                if (!m2.contains(element))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                const auto it{m2.find(element.first)};
+                if (it == m2.end() || it->second != element.second)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::cbegin() const -> const_iterator
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    inline constexpr MetaMap<K, V, H, A>::_Iterator<constant>::_Iterator(const u8 * const control, _Slot * const slot) :
+        _control{control},
+        _slot{slot}
+    {}
+
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    template <bool constant_> requires (constant && !constant_)
+    inline constexpr MetaMap<K, V, H, A>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other) :
+        _control{other._control},
+        _slot{other._slot}
+    {}
+
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    inline auto MetaMap<K, V, H, A>::_Iterator<constant>::operator*() const -> reference
     {
-        return begin();
+        return _slot->element;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline typename RawMap<K, V, H, A>::iterator RawMap<K, V, H, A>::end()
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    inline auto MetaMap<K, V, H, A>::_Iterator<constant>::operator->() const -> pointer
     {
-        return iterator{};
+        return &_slot->element;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::end() const -> const_iterator
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    inline auto MetaMap<K, V, H, A>::_Iterator<constant>::operator++() -> _Iterator &
     {
-        return const_iterator{};
+        do
+        {
+            ++_control;
+            ++_slot;
+        } while (*_control >= _emptyControl && *_control != _endControl);
+
+        if (*_control == _endControl)
+        {
+            _control = nullptr;
+            _slot = nullptr;
+        }
+
+        return *this;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline auto RawMap<K, V, H, A>::cend() const -> const_iterator
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    inline auto MetaMap<K, V, H, A>::_Iterator<constant>::operator++(int) -> _Iterator
     {
-        return const_iterator{};
+        const _Iterator temp{*this};
+        operator++();
+        return temp;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline auto RawMap<K, V, H, A>::find(const K_ & key) -> iterator
+    template <typename K, typename V, typename H, typename A>
+    template <bool constant>
+    template <bool constant_>
+    inline bool MetaMap<K, V, H, A>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
     {
-        return const_cast<E *>(static_cast<const RawMap *>(this)->find(key)._element);
+        return _slot == other._slot;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline auto RawMap<K, V, H, A>::find(const K_ & key) const -> const_iterator
+    template <Rawable K, typename V, typename A>
+    inline DirectMap<K, V, A>::DirectMap(const A & alloc) :
+        _size{},
+        _presence{const_cast<u64 *>(_emptyPresence)},
+        _values{},
+        _alloc{alloc}
+    {}
+
+    template <Rawable K, typename V, typename A>
+    inline DirectMap<K, V, A>::DirectMap(const std::initializer_list<E> elements, const A & alloc) :
+        DirectMap{alloc}
     {
-        if (!_size)
+        for (const E & element : elements)
         {
-            return cend();
+            insert(element);
         }
-
-        const auto [element, isPresent]{_findKey<false>(key)};
-        return isPresent ? const_iterator{element} : cend();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline u64 RawMap<K, V, H, A>::slot(const K_ & key) const
+    template <Rawable K, typename V, typename A>
+    inline DirectMap<K, V, A>::DirectMap(const DirectMap & other) :
+        _size{other._size},
+        _presence{const_cast<u64 *>(_emptyPresence)},
+        _values{},
+        _alloc{std::allocator_traits<A>::select_on_container_copy_construction(other._alloc)}
     {
-        const _RawKey & rawKey{_raw(key)};
-        if (_isSpecial(rawKey)) [[unlikely]]
+        if (other._isAllocated())
         {
-            return _slotN + (rawKey == _vacantKey);
+            _allocate();
+            std::memcpy(_presence, other._presence, sizeof(_emptyPresence));
+
+            if constexpr (_isMap)
+            {
+                for (u64 i{_next(0u)}; i < _keyN; i = _next(i + 1u))
+                {
+                    std::allocator_traits<A>::construct(_alloc, _values + i, other._values[i]);
+                }
+            }
         }
-        else
+    }
+
+    template <Rawable K, typename V, typename A>
+    inline DirectMap<K, V, A>::DirectMap(DirectMap && other) :
+        _size{std::exchange(other._size, 0u)},
+        _presence{std::exchange(other._presence, const_cast<u64 *>(_emptyPresence))},
+        _values{std::exchange(other._values, nullptr)},
+        _alloc{std::move(other._alloc)}
+    {}
+
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::operator=(const DirectMap & other) -> DirectMap &
+    {
+        if (&other != this)
         {
-            return _slot(key);
+            DirectMap copy{other};
+            swap(copy);
         }
+
+        return *this;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <Compatible<K> K_>
-    inline u64 RawMap<K, V, H, A>::_slot(const K_ & key) const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::operator=(DirectMap && other) -> DirectMap &
     {
-        return _hash(key) & (_slotN - 1u);
+        if (&other != this)
+        {
+            DirectMap moved{std::move(other)};
+            swap(moved);
+        }
+
+        return *this;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::reserve(const u64 capacity)
+    template <Rawable K, typename V, typename A>
+    inline DirectMap<K, V, A>::~DirectMap()
     {
-        rehash(capacity << 1);
+        if (_isAllocated())
+        {
+            _destroyValues();
+            _deallocate();
+        }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::rehash(u64 slotN)
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::insert(const E & element) -> std::pair<iterator, bool>
     {
-        const u64 currentMinSlotN{_size <= minMapCapacity ? _private::minMapSlotN : ((_size - _haveSpecial[0] - _haveSpecial[1]) << 1)};
-        if (slotN < currentMinSlotN)
+        if constexpr (_isSet)
         {
-            slotN = currentMinSlotN;
+            return _tryEmplace(_index(element));
         }
         else
         {
-            slotN = std::bit_ceil(slotN);
+            return _tryEmplace(_index(element.first), element.second);
         }
+    }
 
-        if (slotN != _slotN)
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::insert(E && element) -> std::pair<iterator, bool>
+    {
+        if constexpr (_isSet)
         {
-            if (_elements)
-            {
-                _rehash(slotN);
-            }
-            else
-            {
-                _slotN = slotN;
-            }
+            return _tryEmplace(_index(element));
+        }
+        else
+        {
+            return _tryEmplace(_index(element.first), std::move(element.second));
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::_rehash(const u64 slotN)
+    template <Rawable K, typename V, typename A>
+    template <typename V_>
+    inline auto DirectMap<K, V, A>::emplace(const K & key, V_ && value) -> std::pair<iterator, bool> requires (_isMap)
     {
-        const u64 oldSize{_size};
-        const u64 oldSlotN{_slotN};
-        E * const oldElements{_elements};
-        const bool oldHaveSpecial[2]{_haveSpecial[0], _haveSpecial[1]};
+        return _tryEmplace(_index(key), std::forward<V_>(value));
+    }
 
-        _size = {};
-        _slotN = slotN;
-        _allocate<true>();
-        _haveSpecial[0] = false;
-        _haveSpecial[1] = false;
+    template <Rawable K, typename V, typename A>
+    template <typename... VArgs>
+    inline auto DirectMap<K, V, A>::try_emplace(const K & key, VArgs &&... valueArgs) -> std::pair<iterator, bool>
+    {
+        static_assert(_isSet == (sizeof...(VArgs) == 0u), "Value arguments are required for maps and forbidden for sets");
 
-        // General case
-        u64 n{};
-        const u64 regularElementN{oldSize - oldHaveSpecial[0] - oldHaveSpecial[1]};
-        for (E * element{oldElements}; n < regularElementN; ++element)
+        return _tryEmplace(_index(key), std::forward<VArgs>(valueArgs)...);
+    }
+
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline bool DirectMap<K, V, A>::erase(const K_ & key)
+    {
+        const u64 i{_index(static_cast<K>(key))};
+        if (!_has(i))
         {
-            if (_isPresent(_raw(_key(*element))))
-            {
-                emplace(std::move(*element));
-                std::allocator_traits<A>::destroy(_alloc, element);
-                ++n;
-            }
+            return false;
         }
 
-        // Special keys case
-        if (oldHaveSpecial[0]) [[unlikely]]
+        _eraseIndex(i);
+        return true;
+    }
+
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::erase(const iterator position)
+    {
+        _eraseIndex(position._i);
+    }
+
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::clear()
+    {
+        if (_isAllocated())
         {
-            E * const oldElement{oldElements + oldSlotN};
-            std::allocator_traits<A>::construct(_alloc, _elements + _slotN, std::move(*oldElement));
-            std::allocator_traits<A>::destroy(_alloc, oldElement);
-            ++_size;
-            _haveSpecial[0] = true;
+            _destroyValues();
+            std::memset(_presence, 0, sizeof(_emptyPresence));
+        }
+
+        _size = 0u;
+    }
+
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline bool DirectMap<K, V, A>::contains(const K_ & key) const
+    {
+        return _has(_index(static_cast<K>(key)));
+    }
+
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline u64 DirectMap<K, V, A>::count(const K_ & key) const
+    {
+        return contains(key);
+    }
+
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        template <Rawable K, typename V, typename A>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<V> DirectMap<K, V, A>::at(const K_ & key) requires (_isMap)
+        {
+            return const_cast<V &>(static_cast<const DirectMap *>(this)->at(key));
         }
-        if (oldHaveSpecial[1]) [[unlikely]]
+
+        template <Rawable K, typename V, typename A>
+        template <Compatible<K> K_>
+        inline std::add_lvalue_reference_t<const V> DirectMap<K, V, A>::at(const K_ & key) const requires (_isMap)
         {
-            E * const oldElement{oldElements + oldSlotN + 1};
-            std::allocator_traits<A>::construct(_alloc, _elements + _slotN + 1, std::move(*oldElement));
-            std::allocator_traits<A>::destroy(_alloc, oldElement);
-            ++_size;
-            _haveSpecial[1] = true;
+            const u64 i{_index(static_cast<K>(key))};
+            if (!_has(i))
+            {
+                throw std::out_of_range{"Element not found"};
+            }
+
+            return _values[i];
         }
+    #endif
 
-        std::allocator_traits<A>::deallocate(_alloc, oldElements, oldSlotN + 4u);
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline std::add_lvalue_reference_t<V> DirectMap<K, V, A>::operator[](const K_ & key) requires (_isMap)
+    {
+        const u64 i{_index(static_cast<K>(key))};
+        _tryEmplace(i);
+        return _values[i];
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::swap(RawMap & other)
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline auto DirectMap<K, V, A>::find(const K_ & key) -> iterator
     {
-        std::swap(_size, other._size);
-        std::swap(_slotN, other._slotN);
-        std::swap(_elements, other._elements);
-        std::swap(_haveSpecial, other._haveSpecial);
-        std::swap(_hash, other._hash);
-        if constexpr (std::allocator_traits<A>::propagate_on_container_swap::value)
-        {
-            std::swap(_alloc, other._alloc);
-        }
+        const u64 i{_index(static_cast<K>(key))};
+        return iterator{this, _has(i) ? i : _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline u64 RawMap<K, V, H, A>::size() const
+    template <Rawable K, typename V, typename A>
+    template <Compatible<K> K_>
+    inline auto DirectMap<K, V, A>::find(const K_ & key) const -> const_iterator
     {
-        return _size;
+        const u64 i{_index(static_cast<K>(key))};
+        return const_iterator{this, _has(i) ? i : _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline bool RawMap<K, V, H, A>::empty() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::begin() -> iterator
     {
-        return !_size;
+        return iterator{this, _size ? _next(0u) : _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline u64 RawMap<K, V, H, A>::capacity() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::begin() const -> const_iterator
     {
-        return _slotN >> 1;
+        return const_iterator{this, _size ? _next(0u) : _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline u64 RawMap<K, V, H, A>::slot_n() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::cbegin() const -> const_iterator
     {
-        return _slotN;
+        return begin();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline u64 RawMap<K, V, H, A>::max_size() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::end() -> iterator
     {
-        return (max_slot_n() >> 1) + 2u;
+        return iterator{this, _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline u64 RawMap<K, V, H, A>::max_slot_n() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::end() const -> const_iterator
     {
-        return u64{1u} << 63;
+        return const_iterator{this, _keyN};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline f32 RawMap<K, V, H, A>::load_factor() const
+    template <Rawable K, typename V, typename A>
+    inline auto DirectMap<K, V, A>::cend() const -> const_iterator
     {
-        return f32(_size) / f32(_slotN);
+        return end();
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline f32 RawMap<K, V, H, A>::max_load_factor() const
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::swap(DirectMap & other)
     {
-        return f32(minMapCapacity) / f32(_private::minMapSlotN);
+        std::swap(_size, other._size);
+        std::swap(_presence, other._presence);
+        std::swap(_values, other._values);
+        if constexpr (std::allocator_traits<A>::propagate_on_container_swap::value)
+        {
+            std::swap(_alloc, other._alloc);
+        }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline const H & RawMap<K, V, H, A>::hash_function() const
+    template <Rawable K, typename V, typename A>
+    inline u64 DirectMap<K, V, A>::size() const
     {
-        return _hash;
+        return _size;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline const A & RawMap<K, V, H, A>::get_allocator() const
+    template <Rawable K, typename V, typename A>
+    inline bool DirectMap<K, V, A>::empty() const
     {
-        return _alloc;
+        return !_size;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline K & RawMap<K, V, H, A>::_key(E & element)
+    template <Rawable K, typename V, typename A>
+    inline constexpr u64 DirectMap<K, V, A>::capacity()
     {
-        if constexpr (_isSet) return element;
-        else return element.first;
+        return _keyN;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline const K & RawMap<K, V, H, A>::_key(const E & element)
+    template <Rawable K, typename V, typename A>
+    inline const A & DirectMap<K, V, A>::get_allocator() const
     {
-        if constexpr (_isSet) return element;
-        else return element.first;
+        return _alloc;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline bool RawMap<K, V, H, A>::_isPresent(const _RawKey & key)
+    template <Rawable K, typename V, typename A>
+    inline u64 DirectMap<K, V, A>::_index(const K & key)
     {
-        return !_isSpecial(key);
+        return std::bit_cast<Unsigned<sizeof(K)>>(key);
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline bool RawMap<K, V, H, A>::_isSpecial(const _RawKey & key)
+    template <Rawable K, typename V, typename A>
+    inline K DirectMap<K, V, A>::_key(const u64 i)
     {
-        return key == _vacantKey || key == _graveKey;
+        return std::bit_cast<K>(Unsigned<sizeof(K)>(i));
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool zeroKeys>
-    inline void RawMap<K, V, H, A>::_allocate()
+    template <Rawable K, typename V, typename A>
+    inline bool DirectMap<K, V, A>::_isAllocated() const
     {
-        _elements = std::allocator_traits<A>::allocate(_alloc, _slotN + 4u);
-
-        if constexpr (zeroKeys)
-        {
-            _clearKeys();
-        }
-
-        // Set the trailing keys to special terminal values so iterators know when to stop
-        _raw(_key(_elements[_slotN + 2])) = _terminalKey;
-        _raw(_key(_elements[_slotN + 3])) = _terminalKey;
+        return _presence != _emptyPresence;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::_deallocate()
+    template <Rawable K, typename V, typename A>
+    inline bool DirectMap<K, V, A>::_has(const u64 i) const
     {
-        std::allocator_traits<A>::deallocate(_alloc, _elements, _slotN + 4u);
-        _elements = nullptr;
+        return (_presence[i >> 6] >> (i & 63u)) & 1u;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline void RawMap<K, V, H, A>::_clearKeys()
+    template <Rawable K, typename V, typename A>
+    inline u64 DirectMap<K, V, A>::_next(const u64 i) const
     {
-        // General case
-        E * const specialElements{_elements + _slotN};
-        for (E * element{_elements}; element < specialElements; ++element)
+        if (i >= _keyN)
         {
-            _raw(_key(*element)) = _vacantKey;
+            return _keyN;
         }
 
-        // Special key case
-        _raw(_key(specialElements[0])) = _vacantGraveKey;
-        _raw(_key(specialElements[1])) = _vacantVacantKey;
+        u64 wordI{i >> 6};
+        u64 word{_presence[wordI] & (~u64{0u} << (i & 63u))};
+
+        while (!word)
+        {
+            if (++wordI == _wordN)
+            {
+                return _keyN;
+            }
+
+            word = _presence[wordI];
+        }
+
+        return (wordI << 6) | u64(std::countr_zero(word));
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool move>
-    inline void RawMap<K, V, H, A>::_forwardData(std::conditional_t<move, RawMap, const RawMap> & other)
+    template <Rawable K, typename V, typename A>
+    template <typename... VArgs>
+    inline auto DirectMap<K, V, A>::_tryEmplace(const u64 i, VArgs &&... valueArgs) -> std::pair<iterator, bool>
     {
-        if constexpr (std::is_trivially_copyable_v<E>)
+        if (!_isAllocated())
         {
-            std::memcpy(_elements, other._elements, (_slotN + 2u) * sizeof(E));
+            _allocate();
+        }
+
+        u64 & word{_presence[i >> 6]};
+        const u64 bit{u64{1u} << (i & 63u)};
+
+        if constexpr (_isSet)
+        {
+            // No value to construct, so insertion needs no branch
+            const bool inserted{!(word & bit)};
+            word |= bit;
+            _size += inserted;
+            return {iterator{this, i}, inserted};
         }
         else
         {
-            using ElementForwardType = std::conditional_t<move, E &&, const E &>;
-
-            // General case
-            std::conditional_t<move, E, const E> * srcElement{other._elements};
-            const E * const srcEndElement{other._elements + _slotN};
-            E * dstElement{_elements};
-            for (; srcElement < srcEndElement; ++srcElement, ++dstElement)
+            if (word & bit)
             {
-                const _RawKey & rawSrcKey{_raw(_key(*srcElement))};
-                if (_isPresent(rawSrcKey))
-                {
-                    std::allocator_traits<A>::construct(_alloc, dstElement, static_cast<ElementForwardType>(*srcElement));
-                }
-                else
-                {
-                    _raw(_key(*dstElement)) = rawSrcKey;
-                }
+                return {iterator{this, i}, false};
             }
 
-            // Special keys case
-            if (_haveSpecial[0])
-            {
-                std::allocator_traits<A>::construct(_alloc, _elements + _slotN, static_cast<ElementForwardType>(other._elements[_slotN]));
-            }
-            else
-            {
-                _raw(_key(_elements[_slotN])) = _vacantGraveKey;
-            }
-            if (_haveSpecial[1])
-            {
-                std::allocator_traits<A>::construct(_alloc, _elements + _slotN + 1, static_cast<ElementForwardType>(other._elements[_slotN + 1]));
-            }
-            else
-            {
-                _raw(_key(_elements[_slotN + 1])) = _vacantVacantKey;
-            }
+            std::allocator_traits<A>::construct(_alloc, _values + i, std::forward<VArgs>(valueArgs)...);
+            word |= bit;
+            ++_size;
+            return {iterator{this, i}, true};
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool insertionForm, Compatible<K> K_>
-    inline auto RawMap<K, V, H, A>::_findKey(const K_ & key) const -> _FindKeyResult<insertionForm>
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::_eraseIndex(const u64 i)
     {
-        const _RawKey & rawKey{_raw(key)};
-
-        // Special key case
-        if (_isSpecial(rawKey)) [[unlikely]]
+        if constexpr (_isMap)
         {
-            const unsigned char specialI{rawKey == _vacantKey};
-            if constexpr (insertionForm)
-            {
-                return _FindKeyResult<insertionForm>{.element = _elements + _slotN + specialI, .isPresent = _haveSpecial[specialI], .isSpecial = true, .specialI = specialI};
-            }
-            else
-            {
-                return _FindKeyResult<insertionForm>{.element = _elements + _slotN + specialI, .isPresent = _haveSpecial[specialI]};
-            }
+            std::allocator_traits<A>::destroy(_alloc, _values + i);
         }
 
-        // General case
-
-        const E * const lastElement{_elements + _slotN};
+        _presence[i >> 6] &= ~(u64{1u} << (i & 63u));
+        --_size;
+    }
 
-        E * element{_elements + _slot(key)};
-        E * grave{};
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::_allocate()
+    {
+        _WordAllocator wordAlloc{_alloc};
+        _presence = std::allocator_traits<_WordAllocator>::allocate(wordAlloc, _wordN);
+        std::memset(_presence, 0, sizeof(_emptyPresence));
 
-        while (true)
+        if constexpr (_isMap)
         {
-            const _RawKey & rawSlotKey{_raw(_key(*element))};
-
-            if (rawSlotKey == rawKey)
-            {
-                if constexpr (insertionForm)
-                {
-                    return {.element = element, .isPresent = true, .isSpecial = false, .specialI = 0u};
-                }
-                else
-                {
-                    return {.element = element, .isPresent = true};
-                }
-            }
+            _ValueAllocator valueAlloc{_alloc};
+            _values = std::allocator_traits<_ValueAllocator>::allocate(valueAlloc, _keyN);
+        }
+    }
 
-            if (rawSlotKey == _vacantKey)
-            {
-                if constexpr (insertionForm)
-                {
-                    return {.element = grave ? grave : element, .isPresent = false, .isSpecial = false, .specialI = 0u};
-                }
-                else
-                {
-                    return {.element = element, .isPresent = false};
-                }
-            }
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::_deallocate()
+    {
+        _WordAllocator wordAlloc{_alloc};
+        std::allocator_traits<_WordAllocator>::deallocate(wordAlloc, _presence, _wordN);
+        _presence = const_cast<u64 *>(_emptyPresence);
 
-            if constexpr (insertionForm)
-            {
-                if (rawSlotKey == _graveKey)
-                {
-                    grave = element;
-                }
-            }
+        if constexpr (_isMap)
+        {
+            _ValueAllocator valueAlloc{_alloc};
+            std::allocator_traits<_ValueAllocator>::deallocate(valueAlloc, _values, _keyN);
+            _values = nullptr;
+        }
+    }
 
-            ++element;
-            if (element == lastElement) [[unlikely]]
+    template <Rawable K, typename V, typename A>
+    inline void DirectMap<K, V, A>::_destroyValues()
+    {
+        if constexpr (_isMap && !std::is_trivially_destructible_v<V>)
+        {
+            for (u64 i{_next(0u)}; i < _keyN; i = _next(i + 1u))
             {
-                element = _elements;
+                std::allocator_traits<A>::destroy(_alloc, _values + i);
             }
         }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
-    inline bool operator==(const RawMap<K, V, H, A> & m1, const RawMap<K, V, H, A> & m2)
+    template <Rawable K, typename V, typename A>
+    inline bool operator==(const DirectMap<K, V, A> & m1, const DirectMap<K, V, A> & m2)
     {
         if (m1.size() != m2.size())
         {
@@ -2085,9 +11370,7 @@ namespace qc::hash
             return true;
         }
 
-        const auto endIt{m2.cend()};
-
-        for (const auto & element : m1)
+        for (const auto element : m1)
         {
             if constexpr (std::is_same_v<V, void>)
             {
@@ -2099,7 +11382,7 @@ namespace qc::hash
             else
             {
                 const auto it{m2.find(element.first)};
-                if (it == endIt || it->second != element.second)
+                if (it == m2.end() || it->second != element.second)
                 {
                     return false;
                 }
@@ -2109,123 +11392,72 @@ namespace qc::hash
         return true;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
     template <bool constant_> requires (constant && !constant_)
-    inline constexpr RawMap<K, V, H, A>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other):
-        _element{other._element}
+    inline constexpr DirectMap<K, V, A>::_Iterator<constant>::_Iterator(const _Iterator<constant_> & other) :
+        _map{other._map},
+        _i{other._i}
     {}
 
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool constant>
-    inline constexpr RawMap<K, V, H, A>::_Iterator<constant>::_Iterator(E * const element) :
-        _element{element}
-    {}
-
-    template <Rawable K, typename V, typename H, typename A>
-    template <bool constant>
-    template <bool constant_> requires (constant && !constant_)
-    inline auto RawMap<K, V, H, A>::_Iterator<constant>::operator=(const _Iterator<constant_> & other) -> _Iterator &
-    {
-        _element = other._element;
-        return *this;
-    }
-
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
-    inline auto RawMap<K, V, H, A>::_Iterator<constant>::operator*() const -> E &
+    inline auto DirectMap<K, V, A>::_Iterator<constant>::operator*() const -> reference
     {
-        return *_element;
+        if constexpr (_isSet)
+        {
+            return _key(_i);
+        }
+        else
+        {
+            return reference{_key(_i), _map->_values[_i]};
+        }
     }
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
-    inline auto RawMap<K, V, H, A>::_Iterator<constant>::operator->() const -> E *
+    inline auto DirectMap<K, V, A>::_Iterator<constant>::operator->() const -> pointer
     {
-        return _element;
+        return pointer{**this};
     }
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
-    inline auto RawMap<K, V, H, A>::_Iterator<constant>::operator++() -> _Iterator &
+    inline auto DirectMap<K, V, A>::_Iterator<constant>::operator++() -> _Iterator &
     {
-        while (true)
-        {
-            ++_element;
-            const _RawKey & rawKey{_raw(_key(*_element))};
-
-            // Either general present case or terminal case
-            if (_isPresent(rawKey))
-            {
-                if (rawKey == _terminalKey) [[unlikely]]
-                {
-                    // Terminal case
-                    if (_raw(_key(_element[1])) == _terminalKey)
-                    {
-                        _element = nullptr;
-                    }
-                }
-
-                return *this;
-            }
-
-            // Either general absent case with terminal two ahead or special case
-            if (_raw(_key(_element[2])) == _terminalKey) [[unlikely]]
-            {
-                // At second special slot
-                if (_raw(_key(_element[1])) == _terminalKey) [[unlikely]]
-                {
-                    if (rawKey == _vacantVacantKey) [[likely]]
-                    {
-                        _element = nullptr;
-                    }
-
-                    return *this;
-                }
-
-                // At first special slot
-                if (_raw(_key(_element[3])) == _terminalKey) [[likely]]
-                {
-                    if (rawKey == _vacantGraveKey) [[likely]]
-                    {
-                        if (_raw(_key(_element[1])) == _vacantVacantKey) [[likely]]
-                        {
-                            _element = nullptr;
-                        }
-                        else
-                        {
-                            ++_element;
-                        }
-                    }
-
-                    return *this;
-                }
-            }
-        }
+        _i = _map->_next(_i + 1u);
+        return *this;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
-    inline auto RawMap<K, V, H, A>::_Iterator<constant>::operator++(int) -> _Iterator
+    inline auto DirectMap<K, V, A>::_Iterator<constant>::operator++(int) -> _Iterator
     {
         const _Iterator temp{*this};
         operator++();
         return temp;
     }
 
-    template <Rawable K, typename V, typename H, typename A>
+    template <Rawable K, typename V, typename A>
     template <bool constant>
     template <bool constant_>
-    inline bool RawMap<K, V, H, A>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
+    inline bool DirectMap<K, V, A>::_Iterator<constant>::operator==(const _Iterator<constant_> & other) const
     {
-        return _element == other._element;
+        return _i == other._i;
     }
+
+    template <Rawable K, typename V, typename A>
+    template <bool constant>
+    inline constexpr DirectMap<K, V, A>::_Iterator<constant>::_Iterator(_Map * const map, const u64 i) :
+        _map{map},
+        _i{i}
+    {}
 }
 
 namespace std
 {
-    template <typename K, typename V, typename H, typename A>
-    inline void swap(qc::hash::RawMap<K, V, H, A> & a, qc::hash::RawMap<K, V, H, A> & b)
+    template <typename K, typename V, typename H, typename A, typename P>
+    inline void swap(qc::hash::RawMap<K, V, H, A, P> & a, qc::hash::RawMap<K, V, H, A, P> & b)
     {
         a.swap(b);
     }
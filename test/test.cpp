@@ -6,7 +6,11 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <filesystem>
 #include <map>
+#include <unordered_set>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -82,6 +86,49 @@ struct qc::hash::RawFriend
         const u64 idealSlotI{set.slot(*it)};
         return slotI >= idealSlotI ? slotI - idealSlotI : set.slot_n() - idealSlotI + slotI;
     }
+
+    template <typename K, typename V, typename H, typename A, typename P>
+    static u64 graveN(const RawMap<K, V, H, A, P> & map)
+    {
+        u64 n{0u};
+        for (u64 slotI{0u}; map._elements && slotI < map._slotN; ++slotI)
+        {
+            n += _raw(map._key(map._elements[slotI])) == map._graveKey;
+        }
+        return n;
+    }
+
+    // Whether every element's probe sequence is unbroken, and no element sits further from its ideal slot than the element
+    // before it does plus one
+    template <typename K, typename V, typename H, typename A, typename P>
+    static bool isRobinHood(const RawMap<K, V, H, A, P> & map)
+    {
+        const u64 slotMask{map._slotN - 1u};
+        const auto dist{[&](const u64 slotI) { return (slotI - map.slot(map._key(map._elements[slotI]))) & slotMask; }};
+
+        for (u64 slotI{0u}; map._elements && slotI < map._slotN; ++slotI)
+        {
+            if (!map._isPresent(_raw(map._key(map._elements[slotI])))) continue;
+
+            const u64 d{dist(slotI)};
+            if (d)
+            {
+                const u64 prevSlotI{(slotI - 1u) & slotMask};
+                if (!map._isPresent(_raw(map._key(map._elements[prevSlotI]))) || dist(prevSlotI) + 1u < d)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    template <typename K, typename V, typename H, typename A, typename P>
+    static const K * keys(const RawMap<K, V, H, A, P> & map) requires (P::splitStorage)
+    {
+        return map._elements;
+    }
 };
 
 struct TrackedStats2
@@ -210,6 +257,11 @@ template <typename K, typename V> using MemRecordMap = RawMap<K, V, typename Raw
 using Tracked2MemRecordSet = RawSet<Tracked2, Tracked2Hash, qc::memory::RecordAllocator<Tracked2>>;
 using Tracked2MemRecordMap = RawMap<Tracked2, Tracked2, Tracked2Hash, qc::memory::RecordAllocator<Tracked2>>;
 
+struct SplitPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr bool splitStorage{true};
+};
+
 TEST(identityHash, general)
 {
     { // Standard
@@ -500,6 +552,105 @@ TEST(fastHash, zeroSequences)
     ASSERT_EQ(hash32_16, qc::hash::fastHash::hash<u32>(zeroArr.data(), 16u));
 }
 
+template <typename T> void testHashN(const std::span<const T> vs)
+{
+    for (u64 n{0u}; n <= vs.size(); ++n)
+    {
+        std::vector<u64> hashes(n, 0u);
+        qc::hash::FastHash<T>{}.hash_n(vs.first(n), hashes);
+        for (u64 i{0u}; i < n; ++i)
+        {
+            ASSERT_EQ(qc::hash::FastHash<T>{}(vs[i]), hashes[i]);
+        }
+    }
+}
+
+TEST(fastHash, hashN)
+{
+    struct Bytes4 { u8 bytes[4]; };
+    struct Bytes16 { u64 a, b; };
+
+    constexpr u64 n{37u};
+    qc::Random random{};
+
+    std::vector<u64> u64s(n);
+    std::vector<u32> u32s(n);
+    std::vector<s64> s64s(n);
+    std::vector<Bytes4> bytes4s(n);
+    std::vector<Bytes16> bytes16s(n);
+    for (u64 i{0u}; i < n; ++i)
+    {
+        u64s[i] = random.next<u64>();
+        u32s[i] = random.next<u32>();
+        s64s[i] = random.next<s64>();
+        bytes4s[i] = std::bit_cast<Bytes4>(random.next<u32>());
+        bytes16s[i] = {random.next<u64>(), random.next<u64>()};
+    }
+    u64s[0] = 0u;
+    u64s[1] = ~u64{};
+
+    testHashN<u64>(u64s);
+    testHashN<u32>(u32s);
+    testHashN<s64>(s64s);
+    testHashN<Bytes4>(bytes4s);
+    testHashN<Bytes16>(bytes16s);
+}
+
+TEST(fastHash, longData)
+{
+    std::array<u8, 320u> data{};
+    for (u64 i{0u}; i < data.size(); ++i)
+    {
+        data[i] = u8(i * 131u + 7u);
+    }
+
+    const auto hash{[&data](const u64 length) { return qc::hash::fastHash::hash<u64>(data.data(), length); }};
+
+    // Every length from below to well above the bulk length hashes differently
+    {
+        std::unordered_set<u64> hashes{};
+        for (u64 length{0u}; length <= data.size(); ++length)
+        {
+            hashes.insert(hash(length));
+        }
+        ASSERT_EQ(data.size() + 1u, hashes.size());
+    }
+
+    // Every single bit flip, including in the words left over after the stripes, changes the hash
+    {
+        constexpr u64 length{qc::hash::fastHash::bulkLength * 2u + 13u};
+        std::unordered_set<u64> hashes{hash(length)};
+        for (u64 bitI{0u}; bitI < length * 8u; ++bitI)
+        {
+            data[bitI / 8u] ^= u8(1u << (bitI % 8u));
+            hashes.insert(hash(length));
+            data[bitI / 8u] ^= u8(1u << (bitI % 8u));
+        }
+        ASSERT_EQ(length * 8u + 1u, hashes.size());
+    }
+
+    // Swapping words between lanes or stripes between steps changes the hash
+    {
+        constexpr u64 length{256u};
+        const u64 original{hash(length)};
+
+        std::swap_ranges(data.begin(), data.begin() + 8, data.begin() + 8);
+        ASSERT_NE(original, hash(length));
+        std::swap_ranges(data.begin(), data.begin() + 8, data.begin() + 8);
+
+        std::swap_ranges(data.begin(), data.begin() + 32, data.begin() + 32);
+        ASSERT_NE(original, hash(length));
+        std::swap_ranges(data.begin(), data.begin() + 32, data.begin() + 32);
+
+        ASSERT_EQ(original, hash(length));
+    }
+
+    // Objects and strings of the same bytes agree
+    const std::string str(reinterpret_cast<const char *>(data.data()), 100u);
+    ASSERT_EQ(hash(100u), qc::hash::FastHash<std::string>{}(str));
+    ASSERT_EQ(hash(data.size()), qc::hash::fastHash::hash<u64>(data));
+}
+
 TEST(set, constructor_default)
 {
     MemRecordSet<s32> s{};
@@ -828,19 +979,54 @@ TEST(set, insert_range)
     for (s32 i{0}; i < 100; ++i) values.emplace_back(i);
 
     Tracked2::resetTotals();
-    s.insert(values.cbegin(), values.cend());
+    ASSERT_EQ(100u, s.insert(values.cbegin(), values.cend()));
     ASSERT_EQ(100u, s.size());
     ASSERT_EQ(128u, s.capacity());
     for (s32 i{0}; i < 100; ++i)
     {
         ASSERT_TRUE(s.contains(Tracked2{i}));
     }
-    ASSERT_EQ(4u, s.get_allocator().stats().allocations);
+    // Sized up front, so no rehashing
+    ASSERT_EQ(1u, s.get_allocator().stats().allocations);
     ASSERT_EQ(100, Tracked2::totalStats.copyConstructs);
-    ASSERT_EQ(16 + 32 + 64, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(100 + 16 + 32 + 64, Tracked2::totalStats.destructs);
+    ASSERT_EQ(0, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(100, Tracked2::totalStats.destructs);
     ASSERT_EQ(0, Tracked2::totalStats.defConstructs);
     ASSERT_EQ(0, Tracked2::totalStats.assigns());
+
+    // Only new elements are counted
+    for (s32 i{50}; i < 150; ++i) values.emplace_back(i);
+    ASSERT_EQ(50u, s.insert(values.cbegin() + 100, values.cend()));
+    ASSERT_EQ(150u, s.size());
+    for (s32 i{0}; i < 150; ++i)
+    {
+        ASSERT_TRUE(s.contains(Tracked2{i}));
+    }
+}
+
+TEST(set, insert_inputRange)
+{
+    // Single pass ranges cannot be sized up front
+    std::istringstream stream{"5 3 5 9 1 3"};
+    RawSet<s32> s{};
+    ASSERT_EQ(4u, s.insert(std::istream_iterator<s32>{stream}, std::istream_iterator<s32>{}));
+    ASSERT_EQ(4u, s.size());
+    ASSERT_TRUE(s.contains(1) && s.contains(3) && s.contains(5) && s.contains(9));
+}
+
+TEST(map, insert_range)
+{
+    std::vector<std::pair<u64, u64>> values{};
+    for (u64 i{0u}; i < 10000u; ++i) values.emplace_back(i * 3u, i);
+
+    RawMap<u64, u64> m{};
+    ASSERT_EQ(10000u, m.insert(values.cbegin(), values.cend()));
+    ASSERT_EQ(10000u, m.size());
+    ASSERT_EQ(0u, m.insert(values.cbegin(), values.cend()));
+    for (u64 i{0u}; i < 10000u; ++i)
+    {
+        ASSERT_EQ(i, m.find(i * 3u)->second);
+    }
 }
 
 TEST(set, insert_initializerList)
@@ -1283,6 +1469,88 @@ TEST(set, maxLoadFactor)
     ASSERT_EQ(0.5f, s.max_load_factor());
 }
 
+TEST(set, maxLoadFactorRuntime)
+{
+    RawSet<s32> s{};
+    s.max_load_factor(0.75f);
+    ASSERT_EQ(0.75f, s.max_load_factor());
+    ASSERT_EQ(32u, s.slot_n());
+    ASSERT_EQ(24u, s.capacity());
+
+    for (s32 i{0}; i < 24; ++i)
+    {
+        s.insert(i);
+    }
+    ASSERT_EQ(32u, s.slot_n());
+
+    s.insert(24);
+    ASSERT_EQ(64u, s.slot_n());
+    ASSERT_EQ(48u, s.capacity());
+
+    // Lowering the max load factor grows if necessary
+    s.max_load_factor(0.25f);
+    ASSERT_EQ(128u, s.slot_n());
+    ASSERT_EQ(32u, s.capacity());
+    for (s32 i{0}; i < 25; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+
+    // Raising the max load factor does not shrink
+    s.max_load_factor(1.0f);
+    ASSERT_EQ(128u, s.slot_n());
+    ASSERT_EQ(127u, s.capacity());
+
+    s.reserve(1000u);
+    ASSERT_EQ(1024u, s.slot_n());
+
+    s.rehash(0u);
+    ASSERT_EQ(32u, s.slot_n());
+    ASSERT_EQ(31u, s.capacity());
+
+    RawSet<s32> s2{};
+    s2.swap(s);
+    ASSERT_EQ(1.0f, s2.max_load_factor());
+    ASSERT_EQ(0.5f, s.max_load_factor());
+}
+
+struct FullPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr f32 maxLoadFactor{1.0f};
+};
+
+TEST(set, maxLoadFactorPolicy)
+{
+    using FullSet = RawSet<u64, qc::hash::IdentityHash<u64>, std::allocator<u64>, FullPolicy>;
+
+    ASSERT_EQ(sizeof(RawSet<u64>), sizeof(FullSet));
+
+    FullSet s(100u);
+    ASSERT_EQ(1.0f, s.max_load_factor());
+    ASSERT_EQ(128u, s.slot_n());
+    ASSERT_EQ(127u, s.capacity());
+
+    // Every slot but one may be filled, even with collisions
+    for (u64 i{0u}; i < 127u; ++i)
+    {
+        s.insert(i * 128u);
+    }
+    ASSERT_EQ(128u, s.slot_n());
+    for (u64 i{0u}; i < 127u; ++i)
+    {
+        ASSERT_TRUE(s.contains(i * 128u));
+    }
+    ASSERT_FALSE(s.contains(127u * 128u));
+
+    s.insert(127u * 128u);
+    ASSERT_EQ(256u, s.slot_n());
+    ASSERT_EQ(128u, s.size());
+
+    FullSet s2{s};
+    ASSERT_EQ(s, s2);
+    ASSERT_EQ(1.0f, s2.max_load_factor());
+}
+
 TEST(set, getters)
 {
     RawSet<s32> s{};
@@ -1467,6 +1735,197 @@ TEST(set, stats)
     ASSERT_NEAR(1.25, stats.stdDev, 0.25);
 }
 
+TEST(set, statsApi)
+{
+    RawSet<u64> s{};
+    const u64 slotN{s.slot_n()};
+
+    {
+        const qc::hash::RawStats stats{s.stats()};
+        ASSERT_TRUE(stats.probeLengths.empty());
+        ASSERT_EQ(0.0, stats.meanDisplacement);
+        ASSERT_EQ(0u, stats.maxDisplacement);
+        ASSERT_EQ(0u, stats.largestCluster);
+        ASSERT_EQ(0u, stats.hashN);
+    }
+
+    // Three keys share slot 0 and run into slot 2, joined by the key in slot 3
+    s.insert({0u, slotN, slotN * 2u, 3u, 5u});
+
+    {
+        const qc::hash::RawStats stats{s.stats()};
+        ASSERT_EQ((std::vector<u64>{3u, 1u, 1u}), stats.probeLengths);
+        ASSERT_NEAR(0.6, stats.meanDisplacement, 1.0e-9);
+        ASSERT_EQ(2u, stats.maxDisplacement);
+        ASSERT_EQ(0u, stats.graveN);
+        ASSERT_EQ(4u, stats.largestCluster);
+        ASSERT_EQ(0u, stats.specialN);
+    }
+
+    // Graves still count toward clusters, and special elements are kept out of the histogram
+    s.erase(slotN);
+    s.insert(~u64{});
+
+    {
+        const qc::hash::RawStats stats{s.stats()};
+        ASSERT_EQ((std::vector<u64>{3u, 0u, 1u}), stats.probeLengths);
+        ASSERT_NEAR(0.5, stats.meanDisplacement, 1.0e-9);
+        ASSERT_EQ(2u, stats.maxDisplacement);
+        ASSERT_EQ(1u, stats.graveN);
+        ASSERT_EQ(4u, stats.largestCluster);
+        ASSERT_EQ(1u, stats.specialN);
+        ASSERT_EQ(0u, stats.lookupN);
+    }
+
+    // Agrees with the distances measured from the outside
+    qc::Random random{};
+    RawSet<s32> r(8192u);
+    for (u64 i{0u}; i < 8192u; ++i)
+    {
+        r.insert(random.next<s32>());
+    }
+    const qc::hash::RawStats stats{r.stats()};
+    const SetDistStats distStats{calcStats(r)};
+    u64 elementN{0u};
+    for (const u64 n : stats.probeLengths)
+    {
+        elementN += n;
+    }
+    ASSERT_EQ(r.size() - stats.specialN, elementN);
+    ASSERT_EQ(distStats.max, stats.maxDisplacement);
+    ASSERT_NEAR(distStats.mean, stats.meanDisplacement, 0.01);
+}
+
+struct CountingPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr bool countOperations{true};
+};
+
+TEST(set, countOperations)
+{
+    using CountingSet = RawSet<u64, qc::hash::IdentityHash<u64>, std::allocator<u64>, CountingPolicy>;
+    static_assert(sizeof(CountingSet) == sizeof(RawSet<u64>) + sizeof(u64) * 4u);
+
+    CountingSet s{};
+    const u64 keyN{s.capacity()};
+    for (u64 key{0u}; key < keyN; ++key)
+    {
+        s.insert(key);
+    }
+
+    qc::hash::RawStats stats{s.stats()};
+    ASSERT_EQ(keyN, stats.hashN);
+    ASSERT_EQ(0u, stats.lookupN);
+    ASSERT_EQ(0u, stats.rehashN);
+
+    // Each present key is in its ideal slot
+    for (u64 key{0u}; key < keyN; ++key)
+    {
+        ASSERT_TRUE(s.contains(key));
+    }
+    stats = s.stats();
+    ASSERT_EQ(keyN * 2u, stats.hashN);
+    ASSERT_EQ(keyN, stats.lookupN);
+    ASSERT_EQ(keyN, stats.probeN);
+
+    // Falls into slot 0 and must probe past every key to the first vacant slot
+    ASSERT_FALSE(s.contains(s.slot_n()));
+    stats = s.stats();
+    ASSERT_EQ(keyN * 2u + 1u, stats.hashN);
+    ASSERT_EQ(keyN + 1u, stats.lookupN);
+    ASSERT_EQ(keyN * 2u + 1u, stats.probeN);
+
+    // Growing rehashes the existing keys
+    s.insert(keyN);
+    stats = s.stats();
+    ASSERT_EQ(1u, stats.rehashN);
+    ASSERT_EQ(keyN * 3u + 2u, stats.hashN);
+    ASSERT_EQ(keyN + 1u, stats.lookupN);
+
+    // Special keys take no probes and are not counted as lookups
+    ASSERT_FALSE(s.contains(~u64{}));
+    ASSERT_EQ(keyN + 1u, s.stats().lookupN);
+}
+
+TEST(set, adaptiveHash)
+{
+    using AdaptiveSet = RawSet<u64, qc::hash::AdaptiveHash<u64>>;
+
+    {
+        qc::hash::AdaptiveHash<u64> hash{};
+        ASSERT_FALSE(hash.isMixing());
+        ASSERT_EQ(qc::hash::IdentityHash<u64>{}(12345u), hash(12345u));
+        hash.startMixing();
+        ASSERT_TRUE(hash.isMixing());
+        ASSERT_EQ(qc::hash::FastHash<u64>{}(12345u), hash(12345u));
+    }
+
+    // Sequential keys never probe, so identity hashing is kept
+    {
+        AdaptiveSet s{};
+        for (u64 key{0u}; key < 10000u; ++key)
+        {
+            s.insert(key);
+        }
+        ASSERT_FALSE(s.hash_function().isMixing());
+        ASSERT_EQ(0u, s.stats().maxDisplacement);
+    }
+
+    // Keys sharing their low 32 bits all fall into the same slot until the switch
+    {
+        constexpr u64 keyN{10000u};
+
+        AdaptiveSet s{};
+        for (u64 i{0u}; i < keyN; ++i)
+        {
+            ASSERT_TRUE(s.insert(i << 32).second);
+        }
+        ASSERT_TRUE(s.hash_function().isMixing());
+        ASSERT_EQ(keyN, s.size());
+        ASSERT_LT(s.stats().maxDisplacement, qc::hash::RawPolicy::adaptiveProbeLimit);
+
+        for (u64 i{0u}; i < keyN; ++i)
+        {
+            ASSERT_TRUE(s.contains(i << 32));
+        }
+        ASSERT_FALSE(s.contains(keyN << 32));
+
+        // The choice goes along with the hasher
+        const AdaptiveSet copy{s};
+        ASSERT_TRUE(copy.hash_function().isMixing());
+        ASSERT_EQ(s, copy);
+
+        for (u64 i{0u}; i < keyN; i += 2u)
+        {
+            ASSERT_TRUE(s.erase(i << 32));
+        }
+        ASSERT_EQ(keyN / 2u, s.size());
+        for (u64 i{0u}; i < keyN; ++i)
+        {
+            ASSERT_EQ(i % 2u == 1u, s.contains(i << 32));
+        }
+    }
+
+    // Range insertion hashes a window of keys ahead. A few leading keys put the switch partway through a window, and
+    // the rest of that window must then be hashed anew
+    {
+        std::vector<u64> keys{100u, 101u, 102u, 103u, 104u};
+        for (u64 i{5u}; i < 1000u; ++i)
+        {
+            keys.push_back(i << 32);
+        }
+
+        AdaptiveSet s{};
+        s.insert(keys.begin(), keys.end());
+        ASSERT_TRUE(s.hash_function().isMixing());
+        ASSERT_EQ(keys.size(), s.size());
+        for (const u64 key : keys)
+        {
+            ASSERT_TRUE(s.contains(key));
+        }
+    }
+}
+
 template <typename K, typename V> void testStaticMemory()
 {
     static constexpr u64 capacity{128u};
@@ -1474,12 +1933,12 @@ template <typename K, typename V> void testStaticMemory()
 
     MemRecordSet<K> s(capacity);
     s.emplace(K{});
-    ASSERT_EQ(sizeof(u64) * 4u, sizeof(RawSet<K>));
+    ASSERT_EQ(sizeof(u64) * 5u, sizeof(RawSet<K>));
     ASSERT_EQ((slotN + 4u) * sizeof(K), s.get_allocator().stats().current);
 
     MemRecordMap<K, V> m(capacity);
     m.emplace(K{}, V{});
-    ASSERT_EQ(sizeof(u64) * 4u, sizeof(RawMap<K, V>));
+    ASSERT_EQ(sizeof(u64) * 5u, sizeof(RawMap<K, V>));
     ASSERT_EQ((slotN + 4u) * sizeof(std::pair<K, V>), m.get_allocator().stats().current);
 }
 
@@ -1770,75 +2229,577 @@ TEST(set, smartPtrs)
     }
 }
 
-TEST(map, general)
+template <typename K, u64 slot>
+struct ConstantHash
 {
-    TrackedMap m{100};
-
-    Tracked2::resetTotals();
-    for (s32 i{0}; i < 25; ++i)
+    u64 operator()(const K &) const
     {
-        const auto [it, inserted]{m.emplace(Tracked2{i}, i + 100)};
-        ASSERT_TRUE(inserted);
-        ASSERT_EQ(i, it->first.val);
-        ASSERT_EQ(i + 100, it->second.val);
+        return slot;
     }
-    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(25, Tracked2::totalStats.destructs);
-    ASSERT_EQ(50, Tracked2::totalStats.all());
+};
 
-    Tracked2::resetTotals();
-    for (s32 i{25}; i < 50; ++i)
+template <typename K, typename H>
+static void testLongProbes()
+{
+    // All keys fall in the same slot, forming a single long chain that starts near the end and wraps around
+    RawSet<K, H> s(64u);
+    ASSERT_EQ(128u, s.slot_n());
+
+    for (K k{0u}; k < K(64u); ++k)
     {
-        const auto [it, inserted]{m.emplace(std::piecewise_construct, std::forward_as_tuple(i), std::forward_as_tuple(i + 100))};
-        ASSERT_TRUE(inserted);
-        ASSERT_EQ(i, it->first.val);
-        ASSERT_EQ(i + 100, it->second.val);
+        ASSERT_TRUE(s.insert(k).second);
     }
-    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(25, Tracked2::totalStats.destructs);
-    ASSERT_EQ(50, Tracked2::totalStats.all());
+    ASSERT_EQ(128u, s.slot_n());
+    for (K k{0u}; k < K(64u); ++k)
+    {
+        ASSERT_TRUE(s.contains(k));
+        ASSERT_EQ(k, *s.find(k));
+    }
+    ASSERT_FALSE(s.contains(K(64u)));
 
-    Tracked2::resetTotals();
-    for (s32 i{50}; i < 75; ++i)
+    // Graves are skipped by lookups
+    for (K k{0u}; k < K(64u); k += 2u)
     {
-        const auto [it, inserted]{m.try_emplace(Tracked2{i}, i + 100)};
-        ASSERT_TRUE(inserted);
-        ASSERT_EQ(i, it->first.val);
-        ASSERT_EQ(i + 100, it->second.val);
+        ASSERT_TRUE(s.erase(k));
+    }
+    for (K k{0u}; k < K(64u); ++k)
+    {
+        ASSERT_EQ(k % 2u == 1u, s.contains(k));
     }
-    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(25, Tracked2::totalStats.destructs);
-    ASSERT_EQ(50, Tracked2::totalStats.all());
 
-    Tracked2::resetTotals();
-    for (s32 i{50}; i < 75; ++i)
+    // Graves are reused by insertion, starting with the earliest in the chain
+    const u64 firstSlotI{s.slot(K(0u))};
+    ASSERT_TRUE(s.insert(K(100u)).second);
+    ASSERT_EQ(firstSlotI, RawFriend::slotI(s, s.find(K(100u))));
+    ASSERT_FALSE(s.insert(K(1u)).second);
+    ASSERT_FALSE(s.insert(K(63u)).second);
+    ASSERT_EQ(33u, s.size());
+
+    for (K k{0u}; k < K(64u); ++k)
     {
-        const auto [it, inserted]{m.try_emplace(Tracked2{i}, i + 100)};
-        ASSERT_FALSE(inserted);
-        ASSERT_EQ(i, it->first.val);
+        ASSERT_EQ(k % 2u == 1u, s.erase(k));
     }
-    ASSERT_EQ(0, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(25, Tracked2::totalStats.destructs);
-    ASSERT_EQ(25, Tracked2::totalStats.all());
+    ASSERT_TRUE(s.erase(K(100u)));
+    ASSERT_TRUE(s.empty());
+}
 
-    Tracked2::resetTotals();
-    for (s32 i{75}; i < 100; ++i)
+TEST(set, longProbes)
+{
+    testLongProbes<u8, ConstantHash<u8, 0u>>();
+    testLongProbes<u8, ConstantHash<u8, 100u>>();
+    testLongProbes<u8, ConstantHash<u8, 127u>>();
+    testLongProbes<u16, ConstantHash<u16, 0u>>();
+    testLongProbes<u16, ConstantHash<u16, 100u>>();
+    testLongProbes<u16, ConstantHash<u16, 127u>>();
+    testLongProbes<u32, ConstantHash<u32, 0u>>();
+    testLongProbes<u32, ConstantHash<u32, 100u>>();
+    testLongProbes<u32, ConstantHash<u32, 127u>>();
+    testLongProbes<u64, ConstantHash<u64, 0u>>();
+    testLongProbes<u64, ConstantHash<u64, 100u>>();
+    testLongProbes<u64, ConstantHash<u64, 127u>>();
+}
+
+TEST(set, batchLookup)
+{
+    RawSet<u64> s{};
+    std::vector<u64> keys{};
+    std::vector<bool> expected{};
+    for (u64 k{0u}; k < 1000u; ++k)
     {
-        const auto [it, inserted]{m.insert(std::pair<Tracked2, Tracked2>{Tracked2{i}, Tracked2{i + 100}})};
-        ASSERT_TRUE(inserted);
-        ASSERT_EQ(i, it->first.val);
-        ASSERT_EQ(i + 100, it->second.val);
+        keys.push_back(k * 7u);
+        expected.push_back(k % 3u != 0u);
+        if (k % 3u != 0u) s.insert(k * 7u);
+    }
+    keys.push_back(RawFriend::vacantKey<u64>);
+    expected.push_back(false);
+    keys.push_back(RawFriend::graveKey<u64>);
+    expected.push_back(true);
+    s.insert(RawFriend::graveKey<u64>);
+
+    const u64 presentN{s.size()};
+    bool out[1002];
+    std::vector<RawSet<u64>::iterator> its(keys.size());
+    std::vector<RawSet<u64>::const_iterator> cits(keys.size());
+    ASSERT_EQ(presentN, s.contains_batch(keys, out));
+    ASSERT_EQ(presentN, s.find_batch(keys, its));
+    ASSERT_EQ(presentN, std::as_const(s).find_batch(keys, cits));
+    for (u64 i{0u}; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(expected[i], out[i]);
+        ASSERT_EQ(s.find(keys[i]), its[i]);
+        ASSERT_EQ(std::as_const(s).find(keys[i]), cits[i]);
     }
-    ASSERT_EQ(100, Tracked2::totalStats.moveConstructs);
-    ASSERT_EQ(100, Tracked2::totalStats.destructs);
-    ASSERT_EQ(200, Tracked2::totalStats.all());
 
-    for (s32 i{0}; i < 100; ++i)
+    // Fewer keys than a window, and no keys
+    ASSERT_EQ(1u, s.contains_batch(std::span<const u64>{keys.data() + 2, 2u}, out));
+    ASSERT_TRUE(out[0]);
+    ASSERT_FALSE(out[1]);
+    ASSERT_EQ(0u, s.contains_batch({}, out));
+
+    // Empty set
+    s.clear();
+    ASSERT_EQ(0u, s.contains_batch(keys, out));
+    ASSERT_EQ(0u, s.find_batch(keys, its));
+    for (u64 i{0u}; i < keys.size(); ++i)
     {
-        #ifdef QC_HASH_EXCEPTIONS_ENABLED
-        ASSERT_EQ(i + 100, m.at(Tracked2{i}).val);
-        #endif
-        ASSERT_EQ(i + 100, m[Tracked2{i}].val);
+        ASSERT_FALSE(out[i]);
+        ASSERT_EQ(s.end(), its[i]);
+    }
+}
+
+template <typename K> void testBatchHashing()
+{
+    qc::Random random{};
+
+    std::vector<K> keys(1000u);
+    for (K & key : keys)
+    {
+        key = random.next<K>();
+    }
+
+    // Range insertion from contiguous keys hashes a window at a time
+    RawSet<K, qc::hash::FastHash<K>> s{};
+    s.insert(keys.begin(), keys.begin() + 600);
+    for (u64 i{0u}; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(i < 600u || std::find(keys.begin(), keys.begin() + 600, keys[i]) != keys.begin() + 600, s.contains(keys[i]));
+    }
+
+    std::unique_ptr<bool[]> out{new bool[keys.size()]};
+    ASSERT_EQ(s.size(), s.contains_batch(keys, std::span<bool>{out.get(), keys.size()}));
+    for (u64 i{0u}; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(s.contains(keys[i]), out[i]);
+    }
+}
+
+TEST(set, batchHashing)
+{
+    testBatchHashing<u64>();
+    testBatchHashing<u32>();
+    testBatchHashing<s64>();
+
+    // Batch hashes are counted per key
+    RawSet<u64, qc::hash::FastHash<u64>, std::allocator<u64>, CountingPolicy> s{};
+    const std::vector<u64> keys{1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u, 9u, 10u};
+    s.insert(keys.begin(), keys.end());
+    ASSERT_EQ(10u, s.stats().hashN);
+    bool out[10];
+    ASSERT_EQ(10u, s.contains_batch(keys, out));
+    ASSERT_EQ(20u, s.stats().hashN);
+}
+
+TEST(set, graves)
+{
+    MemRecordSet<u32> s(128u);
+    for (u32 key{0u}; key < 100u; ++key)
+    {
+        s.insert(key);
+    }
+    for (u32 key{0u}; key < 50u; ++key)
+    {
+        s.erase(key);
+    }
+    ASSERT_EQ(50u, s.grave_n());
+    ASSERT_EQ(50u, RawFriend::graveN(s));
+
+    // Reinserting into graves consumes them
+    for (u32 key{0u}; key < 10u; ++key)
+    {
+        s.insert(key);
+    }
+    ASSERT_EQ(40u, s.grave_n());
+    ASSERT_EQ(40u, RawFriend::graveN(s));
+
+    // Copies and moves carry the graves along
+    MemRecordSet<u32> copy{s};
+    ASSERT_EQ(40u, copy.grave_n());
+    MemRecordSet<u32> moved{std::move(copy)};
+    ASSERT_EQ(40u, moved.grave_n());
+    ASSERT_EQ(0u, copy.grave_n());
+
+    // Explicit purge happens in place
+    const u64 allocations{s.get_allocator().stats().allocations};
+    const u64 slotN{s.slot_n()};
+    s.purge_graves();
+    ASSERT_EQ(0u, s.grave_n());
+    ASSERT_EQ(0u, RawFriend::graveN(s));
+    ASSERT_EQ(slotN, s.slot_n());
+    ASSERT_EQ(allocations, s.get_allocator().stats().allocations);
+    ASSERT_EQ(60u, s.size());
+    for (u32 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_EQ(key < 10u || key >= 50u, s.contains(key));
+    }
+
+    s.clear();
+    ASSERT_EQ(0u, s.grave_n());
+}
+
+template <typename Policy>
+static void testGravePurging(const u64 size)
+{
+    qc::Random random{};
+    RawSet<u64, qc::hash::FastHash<u64>, std::allocator<u64>, Policy> s{};
+    std::vector<u64> keys{};
+
+    for (u64 i{0u}; i < size; ++i)
+    {
+        keys.push_back(random.next<u64>());
+        s.insert(keys.back());
+    }
+    const u64 slotN{s.slot_n()};
+
+    // Churn at a steady size with ever new keys
+    for (u64 i{0u}; i < 100000u; ++i)
+    {
+        const u64 keyI{random.next<u64>(keys.size())};
+        ASSERT_TRUE(s.erase(keys[keyI]));
+        keys[keyI] = random.next<u64>();
+        ASSERT_TRUE(s.insert(keys[keyI]).second);
+
+        // At least one slot must always stay vacant
+        ASSERT_LT(s.size() + s.grave_n(), s.slot_n());
+    }
+
+    // Graves are purged rather than growing, unless the table is too full for purging to pay off
+    if constexpr (Policy::maxLoadFactor < Policy::gravePurgeThreshold)
+    {
+        ASSERT_EQ(slotN, s.slot_n());
+    }
+    ASSERT_EQ(s.grave_n(), RawFriend::graveN(s));
+    ASSERT_EQ(size, s.size());
+    for (const u64 key : keys)
+    {
+        ASSERT_TRUE(s.contains(key));
+    }
+}
+
+TEST(set, gravePurging)
+{
+    testGravePurging<qc::hash::RawPolicy>(100u);
+    testGravePurging<qc::hash::RawPolicy>(10000u);
+    testGravePurging<FullPolicy>(1000u);
+}
+
+struct ShiftPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr bool backwardShiftErase{true};
+};
+
+template <typename H, typename Policy = ShiftPolicy>
+static void testBackwardShiftErase(const u64 keyN)
+{
+    qc::Random random{};
+    RawSet<u32, H, std::allocator<u32>, Policy> s{};
+    std::unordered_set<u32> reference{};
+
+    // Churn at a steady size
+    for (u64 i{0u}; i < 20000u; ++i)
+    {
+        const u32 key{random.next<u32>(u32(keyN))};
+        if (reference.size() < keyN / 2u)
+        {
+            ASSERT_EQ(reference.insert(key).second, s.insert(key).second);
+        }
+        else
+        {
+            ASSERT_EQ(reference.erase(key) != 0u, s.erase(key));
+        }
+    }
+
+    ASSERT_EQ(0u, RawFriend::graveN(s));
+    ASSERT_EQ(0u, s.grave_n());
+    ASSERT_EQ(reference.size(), s.size());
+    for (u32 key{0u}; key < keyN; ++key)
+    {
+        ASSERT_EQ(reference.contains(key), s.contains(key));
+    }
+}
+
+TEST(set, backwardShiftErase)
+{
+    testBackwardShiftErase<qc::hash::IdentityHash<u32>>(100u);
+    testBackwardShiftErase<qc::hash::FastHash<u32>>(1000u);
+    // Long chains that wrap around the end
+    testBackwardShiftErase<ConstantHash<u32, 127u>>(40u);
+    testBackwardShiftErase<ConstantHash<u32, 100u>>(40u);
+}
+
+struct RobinHoodPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr bool robinHood{true};
+};
+
+struct FullRobinHoodPolicy : RobinHoodPolicy
+{
+    inline static constexpr f32 maxLoadFactor{1.0f};
+};
+
+struct SplitRobinHoodPolicy : SplitPolicy
+{
+    inline static constexpr bool robinHood{true};
+};
+
+TEST(set, robinHood)
+{
+    testBackwardShiftErase<qc::hash::IdentityHash<u32>, RobinHoodPolicy>(100u);
+    testBackwardShiftErase<qc::hash::FastHash<u32>, RobinHoodPolicy>(1000u);
+    testBackwardShiftErase<ConstantHash<u32, 127u>, RobinHoodPolicy>(40u);
+    testBackwardShiftErase<ConstantHash<u32, 100u>, RobinHoodPolicy>(40u);
+
+    qc::Random random{};
+    RawSet<u64, qc::hash::FastHash<u64>, std::allocator<u64>, FullRobinHoodPolicy> s{};
+    std::vector<u64> keys{};
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        keys.push_back(random.next<u64>());
+        ASSERT_TRUE(s.insert(keys.back()).second);
+        ASSERT_TRUE(RawFriend::isRobinHood(s));
+    }
+    for (u64 i{0u}; i < 500u; ++i)
+    {
+        ASSERT_TRUE(s.erase(keys[i]));
+        ASSERT_TRUE(RawFriend::isRobinHood(s));
+    }
+    for (u64 i{0u}; i < keys.size(); ++i)
+    {
+        ASSERT_EQ(i >= 500u, s.contains(keys[i]));
+        ASSERT_FALSE(s.contains(random.next<u64>()));
+    }
+}
+
+TEST(map, robinHood)
+{
+    Tracked2::resetTotals();
+    {
+        RawMap<u32, Tracked2, qc::hash::IdentityHash<u32>, std::allocator<std::pair<u32, Tracked2>>, SplitRobinHoodPolicy> m{};
+
+        // Keys whose ideal slots collide and wrap around
+        for (u32 i{0u}; i < 20u; ++i)
+        {
+            const u32 key{(i % 2u ? 30u : 60u) + (i / 2u) * 64u};
+            ASSERT_TRUE(m.try_emplace(key, s32(key)).second);
+            ASSERT_TRUE(RawFriend::isRobinHood(m));
+        }
+        for (const auto & [key, value] : m)
+        {
+            ASSERT_EQ(s32(key), value.val);
+        }
+
+        auto copy{m};
+        copy.rehash(1024u);
+        ASSERT_EQ(m, copy);
+        ASSERT_TRUE(RawFriend::isRobinHood(copy));
+
+        for (u32 i{0u}; i < 20u; i += 3u)
+        {
+            ASSERT_TRUE(m.erase((i % 2u ? 30u : 60u) + (i / 2u) * 64u));
+            ASSERT_TRUE(RawFriend::isRobinHood(m));
+        }
+        ASSERT_EQ(13u, m.size());
+    }
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 20, Tracked2::totalStats.destructs);
+}
+
+struct ShiftSplitPolicy : SplitPolicy
+{
+    inline static constexpr bool backwardShiftErase{true};
+};
+
+TEST(map, backwardShiftErase)
+{
+    Tracked2::resetTotals();
+    {
+        RawMap<u32, Tracked2, ConstantHash<u32, 30u>, std::allocator<std::pair<u32, Tracked2>>, ShiftSplitPolicy> m{};
+        for (u32 key{0u}; key < 10u; ++key)
+        {
+            m.try_emplace(key, s32(key));
+        }
+
+        // Erasing from the front shifts the rest back
+        ASSERT_TRUE(m.erase(0u));
+        ASSERT_TRUE(m.erase(5u));
+        ASSERT_EQ(8u, m.size());
+        ASSERT_EQ(0u, RawFriend::graveN(m));
+        for (u32 key{0u}; key < 10u; ++key)
+        {
+            const auto it{m.find(key)};
+            if (key == 0u || key == 5u)
+            {
+                ASSERT_EQ(m.end(), it);
+            }
+            else
+            {
+                ASSERT_EQ(s32(key), it->second.val);
+            }
+        }
+    }
+    // Values constructed in place aren't counted as constructs
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 10, Tracked2::totalStats.destructs);
+}
+
+template <typename K>
+static void testForEach()
+{
+    qc::Random random{};
+    RawSet<K> s{};
+    std::vector<K> visited{};
+
+    s.for_each([&](const K & key) { visited.push_back(key); });
+    ASSERT_TRUE(visited.empty());
+
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        s.insert(K(random.next<u64>()));
+    }
+    for (u64 i{0u}; i < 300u; ++i)
+    {
+        s.erase(K(random.next<u64>()));
+    }
+    s.insert(K(RawFriend::vacantKey<K>));
+    s.insert(K(RawFriend::graveKey<K>));
+
+    // Same elements in the same order as iteration
+    std::as_const(s).for_each([&](const K & key) { visited.push_back(key); });
+    ASSERT_EQ(s.size(), visited.size());
+    u64 i{0u};
+    for (const K & key : s)
+    {
+        ASSERT_EQ(key, visited[i]);
+        ++i;
+    }
+}
+
+TEST(set, forEach)
+{
+    testForEach<u8>();
+    testForEach<u16>();
+    testForEach<u32>();
+    testForEach<u64>();
+    testForEach<s32>();
+}
+
+TEST(map, forEach)
+{
+    RawMap<u32, u32> m{};
+    RawMap<u32, u32, qc::hash::IdentityHash<u32>, std::allocator<std::pair<u32, u32>>, SplitPolicy> sm{};
+    for (u32 k{0u}; k < 1000u; k += 3u)
+    {
+        m.emplace(k, k);
+        sm.emplace(k, k);
+    }
+    m.emplace(RawFriend::graveKey<u32>, 7u);
+    sm.emplace(RawFriend::graveKey<u32>, 7u);
+
+    m.for_each([](std::pair<u32, u32> & element) { element.second *= 2u; });
+    sm.for_each([](const std::pair<const u32 &, u32 &> element) { element.second *= 2u; });
+
+    u64 n{0u};
+    std::as_const(m).for_each([&](const std::pair<u32, u32> & element) {
+        ASSERT_EQ(element.first == RawFriend::graveKey<u32> ? 14u : element.first * 2u, element.second);
+        ASSERT_EQ(element.second, sm.find(element.first)->second);
+        ++n;
+    });
+    ASSERT_EQ(m.size(), n);
+}
+
+TEST(map, batchLookup)
+{
+    RawMap<u32, u32> m{};
+    std::vector<u32> keys{};
+    for (u32 k{0u}; k < 100u; ++k)
+    {
+        keys.push_back(k);
+        if (k % 2u) m.emplace(k, k * 10u);
+    }
+
+    std::vector<RawMap<u32, u32>::iterator> its(keys.size());
+    ASSERT_EQ(50u, m.find_batch(keys, its));
+    for (u32 k{0u}; k < 100u; ++k)
+    {
+        if (k % 2u)
+        {
+            ASSERT_EQ(k * 10u, its[k]->second);
+            its[k]->second = k;
+        }
+        else
+        {
+            ASSERT_EQ(m.end(), its[k]);
+        }
+    }
+    ASSERT_EQ(7u, m[7u]);
+}
+
+TEST(map, general)
+{
+    TrackedMap m{100};
+
+    Tracked2::resetTotals();
+    for (s32 i{0}; i < 25; ++i)
+    {
+        const auto [it, inserted]{m.emplace(Tracked2{i}, i + 100)};
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(i, it->first.val);
+        ASSERT_EQ(i + 100, it->second.val);
+    }
+    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(25, Tracked2::totalStats.destructs);
+    ASSERT_EQ(50, Tracked2::totalStats.all());
+
+    Tracked2::resetTotals();
+    for (s32 i{25}; i < 50; ++i)
+    {
+        const auto [it, inserted]{m.emplace(std::piecewise_construct, std::forward_as_tuple(i), std::forward_as_tuple(i + 100))};
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(i, it->first.val);
+        ASSERT_EQ(i + 100, it->second.val);
+    }
+    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(25, Tracked2::totalStats.destructs);
+    ASSERT_EQ(50, Tracked2::totalStats.all());
+
+    Tracked2::resetTotals();
+    for (s32 i{50}; i < 75; ++i)
+    {
+        const auto [it, inserted]{m.try_emplace(Tracked2{i}, i + 100)};
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(i, it->first.val);
+        ASSERT_EQ(i + 100, it->second.val);
+    }
+    ASSERT_EQ(25, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(25, Tracked2::totalStats.destructs);
+    ASSERT_EQ(50, Tracked2::totalStats.all());
+
+    Tracked2::resetTotals();
+    for (s32 i{50}; i < 75; ++i)
+    {
+        const auto [it, inserted]{m.try_emplace(Tracked2{i}, i + 100)};
+        ASSERT_FALSE(inserted);
+        ASSERT_EQ(i, it->first.val);
+    }
+    ASSERT_EQ(0, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(25, Tracked2::totalStats.destructs);
+    ASSERT_EQ(25, Tracked2::totalStats.all());
+
+    Tracked2::resetTotals();
+    for (s32 i{75}; i < 100; ++i)
+    {
+        const auto [it, inserted]{m.insert(std::pair<Tracked2, Tracked2>{Tracked2{i}, Tracked2{i + 100}})};
+        ASSERT_TRUE(inserted);
+        ASSERT_EQ(i, it->first.val);
+        ASSERT_EQ(i + 100, it->second.val);
+    }
+    ASSERT_EQ(100, Tracked2::totalStats.moveConstructs);
+    ASSERT_EQ(100, Tracked2::totalStats.destructs);
+    ASSERT_EQ(200, Tracked2::totalStats.all());
+
+    for (s32 i{0}; i < 100; ++i)
+    {
+        #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        ASSERT_EQ(i + 100, m.at(Tracked2{i}).val);
+        #endif
+        ASSERT_EQ(i + 100, m[Tracked2{i}].val);
     }
 
     #ifdef QC_HASH_EXCEPTIONS_ENABLED
@@ -1906,6 +2867,94 @@ TEST(map, largeKey)
     }
 }
 
+TEST(map, splitStorage)
+{
+    using SplitMap = RawMap<u32, Tracked2, qc::hash::IdentityHash<u32>, std::allocator<std::pair<u32, Tracked2>>, SplitPolicy>;
+    static_assert(std::is_same_v<SplitMap::reference, std::pair<const u32 &, Tracked2 &>>);
+    static_assert(std::is_same_v<SplitMap::const_reference, std::pair<const u32 &, const Tracked2 &>>);
+    static_assert(sizeof(SplitMap::iterator) == 2u * sizeof(void *));
+    static_assert(sizeof(RawMap<u32, Tracked2>::iterator) == sizeof(void *));
+
+    const u32 graveKey{RawFriend::graveKey<u32>};
+    const u32 vacantKey{RawFriend::vacantKey<u32>};
+
+    Tracked2::resetTotals();
+    {
+        SplitMap m{};
+
+        // Includes the special keys
+        for (u32 key{0u}; key < 100u; ++key)
+        {
+            const auto [it, inserted]{m.try_emplace(key, s32(key + 1000u))};
+            ASSERT_TRUE(inserted);
+            ASSERT_EQ(key, it->first);
+            ASSERT_EQ(s32(key + 1000u), it->second.val);
+        }
+        ASSERT_TRUE(m.try_emplace(graveKey, -1).second);
+        ASSERT_TRUE(m.try_emplace(vacantKey, -2).second);
+        ASSERT_EQ(102u, m.size());
+
+        // Keys are contiguous, values are elsewhere
+        const u32 * const keys{RawFriend::keys(m)};
+        for (u32 key{0u}; key < 100u; ++key)
+        {
+            ASSERT_EQ(key, keys[key]);
+            ASSERT_EQ(s32(key + 1000u), m.find(key)->second.val);
+        }
+        ASSERT_EQ(-1, m.find(graveKey)->second.val);
+        ASSERT_EQ(-2, m.find(vacantKey)->second.val);
+
+        // Iteration visits every element with the matching value
+        u64 n{0u};
+        for (const auto & [key, value] : m)
+        {
+            if (key == graveKey) ASSERT_EQ(-1, value.val);
+            else if (key == vacantKey) ASSERT_EQ(-2, value.val);
+            else ASSERT_EQ(s32(key + 1000u), value.val);
+            ++n;
+        }
+        ASSERT_EQ(102u, n);
+
+        // Values are mutable through iterators
+        for (auto it{m.begin()}; it != m.end(); ++it)
+        {
+            it->second.val = -it->second.val;
+        }
+        ASSERT_EQ(-1050, m[50u].val);
+        ASSERT_EQ(1, m[graveKey].val);
+
+        // Copy, move, and rehash
+        SplitMap copy{m};
+        ASSERT_EQ(m, copy);
+        SplitMap moved{std::move(copy)};
+        ASSERT_EQ(m, moved);
+        moved.rehash(1024u);
+        ASSERT_EQ(m, moved);
+        moved[7u].val = 7;
+        ASSERT_NE(m, moved);
+
+        // Erase
+        for (u32 key{0u}; key < 100u; key += 2u)
+        {
+            ASSERT_TRUE(m.erase(key));
+        }
+        ASSERT_TRUE(m.erase(graveKey));
+        ASSERT_EQ(51u, m.size());
+        for (u32 key{1u}; key < 100u; key += 2u)
+        {
+            ASSERT_EQ(-s32(key + 1000u), m.find(key)->second.val);
+        }
+        ASSERT_EQ(m.end(), m.find(0u));
+
+        const SplitMap & cm{m};
+        SplitMap::const_iterator cit{m.find(vacantKey)};
+        ASSERT_EQ(cit, cm.find(vacantKey));
+        ASSERT_EQ(2, cit->second.val);
+    }
+    // The 102 values constructed in place aren't counted as constructs
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 102, Tracked2::totalStats.destructs);
+}
+
 TEST(map, iteratorAssignability)
 {
     static_assert(std::is_assignable_v<RawMap<s32, s32>::iterator, RawMap<s32, s32>::iterator>);
@@ -1914,6 +2963,1700 @@ TEST(map, iteratorAssignability)
     static_assert(std::is_assignable_v<RawMap<s32, s32>::const_iterator, RawMap<s32, s32>::const_iterator>);
 }
 
+TEST(concurrentSet, general)
+{
+    qc::hash::ConcurrentRawSet<u32> set{};
+    ASSERT_TRUE(set.empty());
+    ASSERT_EQ(qc::hash::config::minMapCapacity * 2u, set.slot_n());
+    ASSERT_EQ(qc::hash::config::minMapCapacity, set.capacity());
+
+    for (u32 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_TRUE(set.insert(key));
+        ASSERT_FALSE(set.insert(key));
+    }
+    ASSERT_EQ(100u, set.size());
+    ASSERT_EQ(256u, set.slot_n());
+
+    // Special keys
+    const u32 vacantKey{~u32{0u}};
+    const u32 graveKey{~u32{1u}};
+    ASSERT_FALSE(set.contains(vacantKey));
+    ASSERT_FALSE(set.contains(graveKey));
+    ASSERT_TRUE(set.insert(vacantKey));
+    ASSERT_FALSE(set.insert(vacantKey));
+    ASSERT_TRUE(set.contains(vacantKey));
+    ASSERT_FALSE(set.contains(graveKey));
+    ASSERT_TRUE(set.insert(graveKey));
+    ASSERT_EQ(102u, set.size());
+
+    for (u32 key{0u}; key < 100u; key += 2u)
+    {
+        ASSERT_TRUE(set.erase(key));
+        ASSERT_FALSE(set.erase(key));
+    }
+    ASSERT_TRUE(set.erase(vacantKey));
+    ASSERT_FALSE(set.erase(vacantKey));
+    ASSERT_EQ(51u, set.size());
+    for (u32 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_EQ(key % 2u == 1u, set.contains(key));
+    }
+    ASSERT_FALSE(set.contains(vacantKey));
+    ASSERT_TRUE(set.contains(graveKey));
+
+    // Graves are not reused, so churning through keys must eventually rehash, and with so few live elements the table
+    // stays the same size
+    for (u32 key{1000u}; key < 10000u; ++key)
+    {
+        ASSERT_TRUE(set.insert(key));
+        ASSERT_TRUE(set.erase(key));
+    }
+    ASSERT_EQ(51u, set.size());
+    ASSERT_EQ(256u, set.slot_n());
+    for (u32 key{1u}; key < 100u; key += 2u)
+    {
+        ASSERT_TRUE(set.contains(key));
+    }
+    ASSERT_TRUE(set.contains(graveKey));
+}
+
+TEST(concurrentSet, threads)
+{
+    static constexpr u64 threadN{8u};
+    static constexpr u64 keyN{100'000u};
+
+    qc::hash::ConcurrentRawSet<u64, qc::hash::FastHash<u64>> set{};
+    std::atomic<u64> insertedN{0u};
+    std::vector<std::thread> threads{};
+
+    // Every thread inserts every key, starting at different offsets, so exactly one insertion of each key succeeds
+    for (u64 threadI{0u}; threadI < threadN; ++threadI)
+    {
+        threads.emplace_back([&, threadI]{
+            u64 n{0u};
+            for (u64 i{0u}; i < keyN; ++i)
+            {
+                n += set.insert((i + threadI * (keyN / threadN)) % keyN);
+            }
+            insertedN += n;
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+    ASSERT_EQ(keyN, insertedN);
+    ASSERT_EQ(keyN, set.size());
+    for (u64 key{0u}; key < keyN; ++key)
+    {
+        ASSERT_TRUE(set.contains(key));
+    }
+
+    // Half the threads erase the even keys while the others insert new keys and check the odd keys
+    std::atomic<u64> erasedN{0u};
+    std::atomic<bool> isMissing{false};
+    for (u64 threadI{0u}; threadI < threadN; ++threadI)
+    {
+        if (threadI % 2u == 0u)
+        {
+            threads.emplace_back([&, threadI]{
+                u64 n{0u};
+                for (u64 key{threadI}; key < keyN; key += threadN)
+                {
+                    // Each even key is erased by two threads
+                    n += u64{set.erase(key)} + u64{set.erase((key + 2u) % keyN)};
+                }
+                erasedN += n;
+            });
+        }
+        else
+        {
+            threads.emplace_back([&, threadI]{
+                for (u64 i{0u}; i < keyN; ++i)
+                {
+                    set.insert(keyN * threadI + i);
+                    if (i % 2u == 1u && !set.contains(i))
+                    {
+                        isMissing = true;
+                    }
+                }
+            });
+        }
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(keyN / 2u, erasedN);
+    ASSERT_FALSE(isMissing);
+    ASSERT_EQ(keyN / 2u + keyN * (threadN / 2u), set.size());
+    for (u64 key{0u}; key < keyN; ++key)
+    {
+        ASSERT_EQ(key % 2u == 1u, set.contains(key));
+    }
+}
+
+TEST(concurrentMap, general)
+{
+    qc::hash::ConcurrentRawMap<u64, s32> map{};
+
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_TRUE(map.insert(key, s32(key)));
+        ASSERT_FALSE(map.insert(key, -1));
+    }
+    ASSERT_EQ(100u, map.size());
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_EQ(s32(key), map.find(key));
+    }
+    ASSERT_FALSE(map.find(100u));
+
+    for (u64 key{0u}; key < 200u; key += 2u)
+    {
+        ASSERT_EQ(key >= 100u, map.insert_or_assign(key, -s32(key)));
+    }
+    ASSERT_EQ(150u, map.size());
+    for (u64 key{0u}; key < 200u; ++key)
+    {
+        if (key % 2u == 0u)
+        {
+            ASSERT_EQ(-s32(key), map.find(key));
+        }
+        else
+        {
+            ASSERT_EQ(key < 100u, map.contains(key));
+        }
+    }
+
+    // Special keys
+    const u64 vacantKey{~u64{0u}};
+    const u64 graveKey{~u64{1u}};
+    ASSERT_TRUE(map.insert(vacantKey, 7));
+    ASSERT_FALSE(map.insert(vacantKey, 8));
+    ASSERT_EQ(7, map.find(vacantKey));
+    ASSERT_FALSE(map.find(graveKey));
+    ASSERT_TRUE(map.insert_or_assign(graveKey, 9));
+    ASSERT_FALSE(map.insert_or_assign(graveKey, 10));
+    ASSERT_EQ(10, map.find(graveKey));
+    ASSERT_EQ(152u, map.size());
+    ASSERT_TRUE(map.erase(graveKey));
+    ASSERT_FALSE(map.erase(graveKey));
+    ASSERT_FALSE(map.find(graveKey));
+    ASSERT_TRUE(map.insert(graveKey, 11));
+    ASSERT_EQ(11, map.find(graveKey));
+
+    for (u64 key{0u}; key < 200u; ++key)
+    {
+        ASSERT_EQ(key % 2u == 0u || key < 100u, map.erase(key));
+    }
+    ASSERT_EQ(2u, map.size());
+
+    // Elements survive rehashing
+    for (u64 key{0u}; key < 1000u; ++key)
+    {
+        ASSERT_TRUE(map.insert(key, s32(key)));
+    }
+    for (u64 key{0u}; key < 1000u; ++key)
+    {
+        ASSERT_EQ(s32(key), map.find(key));
+    }
+    ASSERT_EQ(7, map.find(vacantKey));
+    ASSERT_EQ(11, map.find(graveKey));
+    ASSERT_EQ(1002u, map.size());
+}
+
+TEST(concurrentMap, threads)
+{
+    static constexpr u64 threadN{8u};
+    static constexpr u64 keyN{50'000u};
+
+    qc::hash::ConcurrentRawMap<u32, u64, qc::hash::FastHash<u32>> map{};
+    std::atomic<bool> isWrong{false};
+    std::vector<std::thread> threads{};
+
+    // Values are a function of their key, so any value found must match, no matter how far along its insertion is
+    for (u64 threadI{0u}; threadI < threadN; ++threadI)
+    {
+        threads.emplace_back([&, threadI]{
+            for (u32 i{0u}; i < keyN; ++i)
+            {
+                const u32 key{u32((i * 7u + threadI * 1000u) % keyN)};
+                map.insert(key, u64(key) * 3u);
+
+                const u32 otherKey{key ^ 1u};
+                const std::optional<u64> value{map.find(otherKey)};
+                if (value && *value != u64(otherKey) * 3u)
+                {
+                    isWrong = true;
+                }
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+    ASSERT_FALSE(isWrong);
+    ASSERT_EQ(keyN, map.size());
+
+    // Assignments race each other, so each key must end up with one of the values assigned to it
+    for (u64 threadI{0u}; threadI < threadN; ++threadI)
+    {
+        threads.emplace_back([&, threadI]{
+            for (u32 key{0u}; key < keyN; ++key)
+            {
+                map.insert_or_assign(key, threadI);
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(keyN, map.size());
+    for (u32 key{0u}; key < keyN; ++key)
+    {
+        ASSERT_LT(*map.find(key), threadN);
+    }
+}
+
+TEST(shardedMap, general)
+{
+    qc::hash::ShardedRawMap<u32, std::string> map{qc::hash::config::minMapCapacity, 6u};
+    ASSERT_EQ(8u, map.shard_n());
+    ASSERT_TRUE(map.empty());
+
+    for (u32 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_TRUE(map.try_emplace(key, std::to_string(key)));
+        ASSERT_FALSE(map.try_emplace(key, "nope"));
+    }
+    ASSERT_TRUE(map.insert({100u, "100"}));
+    ASSERT_FALSE(map.insert({100u, "nope"}));
+    ASSERT_EQ(101u, map.size());
+
+    // Keys are spread across every shard
+    std::array<u32, 8u> shardSizes{};
+    for (u32 key{0u}; key <= 100u; ++key)
+    {
+        ASSERT_LT(map.shard(key), 8u);
+        ++shardSizes[map.shard(key)];
+        ASSERT_EQ(std::to_string(key), map.find(key));
+    }
+    for (const u32 shardSize : shardSizes)
+    {
+        ASSERT_GT(shardSize, 0u);
+    }
+    ASSERT_FALSE(map.find(101u));
+
+    ASSERT_FALSE(map.insert_or_assign(7u, "seven"));
+    ASSERT_TRUE(map.insert_or_assign(107u, "one hundred seven"));
+    ASSERT_EQ("seven"s, map.find(7u));
+    ASSERT_TRUE(map.visit(7u, [](std::pair<u32, std::string> & element) { element.second += "!"; }));
+    ASSERT_FALSE(map.visit(108u, [](std::pair<u32, std::string> &) { FAIL(); }));
+    const auto & cmap{map};
+    ASSERT_TRUE(cmap.visit(7u, [](const std::pair<u32, std::string> & element) { ASSERT_EQ("seven!"s, element.second); }));
+
+    ASSERT_TRUE(map.erase(107u));
+    ASSERT_FALSE(map.erase(107u));
+    ASSERT_TRUE(map.contains(100u));
+    ASSERT_FALSE(map.contains(107u));
+
+    u64 keySum{0u};
+    map.for_each([&](std::pair<u32, std::string> & element) { keySum += element.first; });
+    ASSERT_EQ(5050u, keySum);
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+}
+
+TEST(shardedMap, moveOnlyValues)
+{
+    qc::hash::ShardedRawMap<u64, std::unique_ptr<int>> map{};
+
+    ASSERT_TRUE(map.insert_or_assign(1u, std::make_unique<int>(1)));
+    ASSERT_FALSE(map.insert_or_assign(1u, std::make_unique<int>(2)));
+    ASSERT_TRUE(map.try_emplace(2u, std::make_unique<int>(3)));
+    ASSERT_EQ(2u, map.size());
+
+    ASSERT_TRUE(map.visit(1u, [](const std::pair<u64, std::unique_ptr<int>> & element) { ASSERT_EQ(2, *element.second); }));
+    ASSERT_TRUE(map.visit(2u, [](const std::pair<u64, std::unique_ptr<int>> & element) { ASSERT_EQ(3, *element.second); }));
+}
+
+TEST(shardedMap, batch)
+{
+    qc::hash::ShardedRawMap<u64, u64> map{};
+
+    std::vector<std::pair<u64, u64>> elements{};
+    for (u64 key{0u}; key < 1000u; ++key)
+    {
+        elements.emplace_back(key * 3u, key);
+    }
+    ASSERT_EQ(1000u, map.insert_batch(elements));
+    ASSERT_EQ(0u, map.insert_batch(elements));
+    ASSERT_EQ(1000u, map.size());
+
+    std::vector<u64> keys{};
+    for (u64 key{0u}; key < 3000u; ++key)
+    {
+        keys.push_back(key);
+    }
+    std::unique_ptr<bool[]> results{new bool[keys.size()]};
+    std::vector<std::optional<u64>> values(keys.size(), 7u);
+    ASSERT_EQ(1000u, map.contains_batch(keys, std::span<bool>{results.get(), keys.size()}));
+    ASSERT_EQ(1000u, map.find_batch(keys, values));
+    for (u64 key{0u}; key < 3000u; ++key)
+    {
+        ASSERT_EQ(key % 3u == 0u, results[key]);
+        if (key % 3u == 0u)
+        {
+            ASSERT_EQ(key / 3u, values[key]);
+        }
+        else
+        {
+            ASSERT_FALSE(values[key]);
+        }
+    }
+
+    ASSERT_EQ(1000u, map.erase_batch(keys));
+    ASSERT_TRUE(map.empty());
+    ASSERT_EQ(0u, map.erase_batch({}));
+}
+
+TEST(shardedSet, threads)
+{
+    static constexpr u64 threadN{8u};
+    static constexpr u64 keyN{20'000u};
+
+    qc::hash::ShardedRawSet<u64> set{};
+    std::atomic<u64> insertedN{0u};
+    std::atomic<u64> erasedN{0u};
+    std::vector<std::thread> threads{};
+
+    // Every thread inserts every key, then erases them again, half one at a time and half in batches
+    for (u64 threadI{0u}; threadI < threadN; ++threadI)
+    {
+        threads.emplace_back([&, threadI]{
+            std::vector<u64> keys{};
+            u64 n{0u};
+            for (u64 i{0u}; i < keyN; ++i)
+            {
+                const u64 key{(i + threadI * 1000u) % keyN};
+                n += set.try_emplace(key);
+                keys.push_back(key);
+            }
+            insertedN += n;
+
+            if (threadI % 2u)
+            {
+                erasedN += set.erase_batch(keys);
+            }
+            else
+            {
+                n = 0u;
+                for (const u64 key : keys)
+                {
+                    n += set.erase(key);
+                }
+                erasedN += n;
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(erasedN, insertedN);
+    ASSERT_GE(insertedN, keyN);
+    ASSERT_TRUE(set.empty());
+}
+
+struct ParallelRehashPolicy : qc::hash::RawPolicy
+{
+    inline static constexpr u64 parallelRehashSlotN{1024u};
+};
+
+struct SplitParallelRehashPolicy : SplitPolicy
+{
+    inline static constexpr u64 parallelRehashSlotN{1024u};
+};
+
+template <typename H>
+static void testParallelRehash(const u64 keyN, const std::initializer_list<u64> threadNs)
+{
+    qc::Random random{};
+    RawSet<u64, H> original{};
+    // Include the special keys
+    original.insert(u64(-1));
+    original.insert(u64(-2));
+    while (original.size() < keyN)
+    {
+        original.insert(random.next<u64>() % (keyN * 4u));
+    }
+
+    for (const u64 threadN : threadNs)
+    {
+        for (const u64 slotN : {original.slot_n() * 2u, original.slot_n() * 8u})
+        {
+            RawSet<u64, H> s{original};
+            s.rehash(slotN, threadN);
+            ASSERT_EQ(slotN, s.slot_n());
+            ASSERT_EQ(original.size(), s.size());
+            ASSERT_EQ(original, s);
+            for (const u64 key : original)
+            {
+                ASSERT_TRUE(s.contains(key));
+            }
+            ASSERT_FALSE(s.contains(keyN * 4u));
+        }
+    }
+}
+
+TEST(set, parallelRehash)
+{
+    testParallelRehash<qc::hash::FastHash<u64>>(10000u, {1u, 2u, 3u, 8u, 1000u});
+    testParallelRehash<qc::hash::IdentityHash<u64>>(10000u, {2u, 7u});
+    // One long chain that wraps around the end
+    testParallelRehash<ConstantHash<u64, 250u>>(60u, {2u, 4u});
+
+    // Shrinking or keeping the size is serial
+    RawSet<u64> s{};
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        s.insert(key);
+    }
+    s.reserve(10000u, 4u);
+    ASSERT_EQ(32768u, s.slot_n());
+    s.rehash(0u, 4u);
+    ASSERT_EQ(256u, s.slot_n());
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_TRUE(s.contains(key));
+    }
+}
+
+TEST(map, parallelRehash)
+{
+    RawMap<std::unique_ptr<u64>, std::string, qc::hash::IdentityHash<std::unique_ptr<u64>>, std::allocator<std::pair<std::unique_ptr<u64>, std::string>>, SplitParallelRehashPolicy> m{};
+    for (u64 i{0u}; i < 5000u; ++i)
+    {
+        ASSERT_TRUE(m.try_emplace(std::make_unique<u64>(i), std::to_string(i)).second);
+    }
+    m.reserve(100000u, 5u);
+    ASSERT_EQ(5000u, m.size());
+    u64 sum{0u};
+    for (const auto & [key, value] : m)
+    {
+        ASSERT_TRUE(m.contains(key));
+        ASSERT_EQ(std::to_string(*key), value);
+        sum += *key;
+    }
+    ASSERT_EQ(4999u * 5000u / 2u, sum);
+}
+
+TEST(set, parallelRehashPolicy)
+{
+    // Growth past the policy's threshold rehashes in parallel
+    RawSet<u64, qc::hash::FastHash<u64>, std::allocator<u64>, ParallelRehashPolicy> s{};
+    for (u64 key{0u}; key < 100000u; ++key)
+    {
+        ASSERT_TRUE(s.insert(key).second);
+    }
+    for (u64 key{0u}; key < 100000u; ++key)
+    {
+        ASSERT_TRUE(s.contains(key));
+    }
+    ASSERT_FALSE(s.contains(100000u));
+}
+
+template <typename P>
+static void testIncrementalSet()
+{
+    qc::hash::IncrementalRawSet<u64, qc::hash::FastHash<u64>, std::allocator<u64>, P> s{};
+    std::unordered_set<u64> reference{};
+    qc::Random random{};
+    bool sawMigration{false};
+
+    for (u64 i{0u}; i < 20000u; ++i)
+    {
+        // Mostly insert, sometimes erase, including the special keys
+        const u64 key{i % 1000u == 0u ? u64(-1) - (i / 1000u) % 2u : random.next<u64>() % 30000u};
+        if (i % 4u == 3u)
+        {
+            ASSERT_EQ(reference.erase(key) != 0u, s.erase(key));
+        }
+        else
+        {
+            const auto [it, inserted]{s.insert(key)};
+            ASSERT_EQ(reference.insert(key).second, inserted);
+            ASSERT_EQ(key, *it);
+        }
+        sawMigration |= s.migrating();
+
+        if (i % 997u == 0u)
+        {
+            ASSERT_EQ(reference.size(), s.size());
+            u64 n{0u};
+            for (const u64 k : s)
+            {
+                ASSERT_TRUE(reference.contains(k));
+                ++n;
+            }
+            ASSERT_EQ(reference.size(), n);
+        }
+    }
+    ASSERT_TRUE(sawMigration);
+
+    for (const u64 key : reference)
+    {
+        ASSERT_TRUE(s.contains(key));
+        ASSERT_EQ(key, *s.find(key));
+    }
+    ASSERT_FALSE(s.contains(30000u));
+    ASSERT_EQ(s.end(), s.find(30000u));
+}
+
+TEST(incrementalSet, general)
+{
+    testIncrementalSet<qc::hash::RawPolicy>();
+    testIncrementalSet<ShiftPolicy>();
+
+    qc::hash::IncrementalRawSet<u64> s{};
+    for (u64 key{0u}; !s.migrating(); ++key)
+    {
+        ASSERT_TRUE(s.insert(key).second);
+    }
+    const u64 size{s.size()};
+    ASSERT_EQ(64u, s.slot_n());
+
+    // Inserting a present key into a full table doesn't set off growth
+    {
+        qc::hash::IncrementalRawSet<u64> full{};
+        for (u64 key{0u}; full.size() < full.capacity(); ++key)
+        {
+            ASSERT_TRUE(full.insert(key).second);
+        }
+        ASSERT_FALSE(full.migrating());
+        const u64 slotN{full.slot_n()};
+        ASSERT_FALSE(full.insert(0u).second);
+        ASSERT_FALSE(full.try_emplace(full.size() - 1u).second);
+        ASSERT_FALSE(full.migrating());
+        ASSERT_EQ(slotN, full.slot_n());
+        ASSERT_TRUE(full.insert(full.size()).second);
+        ASSERT_TRUE(full.migrating());
+    }
+
+    // A copy made mid-migration continues independently
+    qc::hash::IncrementalRawSet<u64> copy{s};
+    ASSERT_TRUE(copy.migrating());
+    ASSERT_EQ(size, copy.size());
+
+    // Erasing through an iterator works in either table
+    for (auto it{s.begin()}; it != s.end(); )
+    {
+        const auto next{std::next(it)};
+        if (*it % 2u)
+        {
+            s.erase(it);
+        }
+        it = next;
+    }
+    ASSERT_EQ(size - size / 2u, s.size());
+
+    copy.finish_migration();
+    ASSERT_FALSE(copy.migrating());
+    ASSERT_EQ(size, copy.size());
+    for (u64 key{0u}; key < size; ++key)
+    {
+        ASSERT_TRUE(copy.contains(key));
+        ASSERT_EQ(key % 2u == 0u, s.contains(key));
+    }
+
+    qc::hash::IncrementalRawSet<u64> moved{std::move(s)};
+    ASSERT_TRUE(s.empty());
+    ASSERT_EQ(size - size / 2u, moved.size());
+
+    moved.clear();
+    ASSERT_FALSE(moved.migrating());
+    ASSERT_TRUE(moved.empty());
+}
+
+TEST(incrementalMap, general)
+{
+    Tracked2::resetTotals();
+    {
+        qc::hash::IncrementalRawMap<u32, Tracked2, qc::hash::FastHash<u32>, std::allocator<std::pair<u32, Tracked2>>, SplitPolicy> m{};
+        for (u32 key{0u}; key < 5000u; ++key)
+        {
+            ASSERT_TRUE(m.try_emplace(key, s32(key)).second);
+            ASSERT_FALSE(m.try_emplace(key, 0).second);
+        }
+        ASSERT_TRUE(m.try_emplace(u32(-1), -1).second);
+        for (u32 key{5000u}; key < 10000u; ++key)
+        {
+            ASSERT_TRUE(m.insert({key, Tracked2{s32(key)}}).second);
+        }
+        ASSERT_EQ(10001u, m.size());
+
+        for (u32 key{0u}; key < 10000u; ++key)
+        {
+            const auto it{m.find(key)};
+            ASSERT_NE(m.end(), it);
+            ASSERT_EQ(s32(key), it->second.val);
+        }
+        ASSERT_EQ(-1, m.find(u32(-1))->second.val);
+
+        for (const auto & [key, value] : std::as_const(m))
+        {
+            ASSERT_EQ(s32(key), value.val);
+        }
+
+        m.reserve(100000u);
+        ASSERT_FALSE(m.migrating());
+        ASSERT_EQ(10001u, m.size());
+    }
+    // The value constructor isn't tracked
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 10001, Tracked2::totalStats.destructs);
+}
+
+TEST(hugePageAllocator, general)
+{
+    static_assert(std::is_same_v<std::allocator_traits<qc::hash::HugePageAllocator<u64>>::rebind_alloc<u8>, qc::hash::HugePageAllocator<u8>>);
+    ASSERT_TRUE(qc::hash::HugePageAllocator<u64>{} == qc::hash::HugePageAllocator<u8>{});
+
+    // Small tables go through `operator new`, large ones are mapped
+    for (const u64 keyN : {100u, 1'000'000u})
+    {
+        RawSet<u64, qc::hash::FastHash<u64>, qc::hash::HugePageAllocator<u64>> s{};
+        for (u64 key{0u}; key < keyN; ++key)
+        {
+            ASSERT_TRUE(s.insert(key).second);
+        }
+        for (u64 key{0u}; key < keyN; ++key)
+        {
+            ASSERT_TRUE(s.contains(key));
+        }
+        ASSERT_EQ(keyN, s.size());
+
+        const auto copy{s};
+        ASSERT_EQ(s, copy);
+    }
+
+    // Not a multiple of the huge page size
+    qc::hash::HugePageAllocator<u8> alloc{};
+    u8 * const bytes{alloc.allocate(qc::hash::hugePageSize * 3u / 2u)};
+    bytes[0] = 1u;
+    bytes[qc::hash::hugePageSize * 3u / 2u - 1u] = 2u;
+    alloc.deallocate(bytes, qc::hash::hugePageSize * 3u / 2u);
+}
+
+TEST(map, snapshot)
+{
+    const std::string path{(std::filesystem::temp_directory_path() / "qc-hash-snapshot.bin").string()};
+
+    RawMap<u64, u32> m{};
+    for (u64 key{0u}; key < 10000u; ++key)
+    {
+        m.emplace(key * 3u, u32(key));
+    }
+    m.emplace(u64(-1), 7u);
+    m.erase(3u);
+    ASSERT_TRUE(m.save(path.c_str()));
+
+    {
+        std::optional<RawMap<u64, u32>> loaded{RawMap<u64, u32>::load(path.c_str())};
+        ASSERT_TRUE(loaded);
+        ASSERT_EQ(m, *loaded);
+        ASSERT_EQ(m.slot_n(), loaded->slot_n());
+        ASSERT_EQ(m.grave_n(), loaded->grave_n());
+
+        // Fully usable from then on
+        for (u64 key{0u}; key < 20000u; ++key)
+        {
+            loaded->emplace(key * 3u + 1u, 0u);
+        }
+        ASSERT_EQ(m.size() + 20000u, loaded->size());
+    }
+
+    #ifdef QC_HASH_MMAP_ENABLED
+    {
+        std::optional<qc::hash::RawMapView<u64, u32, qc::hash::IdentityHash<u64>, std::allocator<std::pair<u64, u32>>, qc::hash::RawPolicy>> view{RawMap<u64, u32>::view(path.c_str())};
+        ASSERT_TRUE(view);
+        ASSERT_EQ(m, view->map());
+        ASSERT_EQ(m.size(), view->size());
+        ASSERT_EQ(2u, view->find(6u)->second);
+        ASSERT_EQ(7u, view->find(u64(-1))->second);
+        ASSERT_FALSE(view->contains(3u));
+        u64 n{0u};
+        for (const auto & element : *view)
+        {
+            ASSERT_TRUE(m.contains(element.first));
+            ++n;
+        }
+        ASSERT_EQ(m.size(), n);
+
+        auto moved{std::move(*view)};
+        ASSERT_EQ(m.size(), moved.size());
+        ASSERT_TRUE(view->empty());
+    }
+    #endif
+
+    // Mismatched hashers and types are rejected
+    ASSERT_FALSE((RawMap<u64, u32, qc::hash::FastHash<u64>>::load(path.c_str())));
+    ASSERT_FALSE((RawMap<u64, u64>::load(path.c_str())));
+    ASSERT_FALSE((RawMap<u32, u32>::load(path.c_str())));
+    ASSERT_FALSE((RawSet<u64>::load(path.c_str())));
+    #ifdef QC_HASH_MMAP_ENABLED
+        ASSERT_FALSE((RawMap<u64, u32, qc::hash::FastHash<u64>>::view(path.c_str())));
+    #endif
+
+    // As are truncated snapshots
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1u);
+    ASSERT_FALSE((RawMap<u64, u32>::load(path.c_str())));
+    #ifdef QC_HASH_MMAP_ENABLED
+        ASSERT_FALSE((RawMap<u64, u32>::view(path.c_str())));
+    #endif
+
+    // Empty
+    ASSERT_TRUE(RawSet<u64>{}.save(path.c_str()));
+    ASSERT_TRUE(RawSet<u64>::load(path.c_str())->empty());
+
+    // Emptied by erasure, which writes no slots, so the graves must not come back
+    {
+        RawSet<u64> s{};
+        for (u64 key{0u}; key < 100u; ++key)
+        {
+            s.insert(key);
+        }
+        for (u64 key{0u}; key < 100u; ++key)
+        {
+            s.erase(key);
+        }
+        ASSERT_EQ(100u, s.grave_n());
+        ASSERT_TRUE(s.save(path.c_str()));
+
+        std::optional<RawSet<u64>> loaded{RawSet<u64>::load(path.c_str())};
+        ASSERT_TRUE(loaded);
+        ASSERT_TRUE(loaded->empty());
+        ASSERT_EQ(0u, loaded->grave_n());
+        loaded->insert(7u);
+        ASSERT_EQ(0u, loaded->grave_n());
+        ASSERT_TRUE(loaded->contains(7u));
+    }
+
+    // Corrupted headers that would leave no vacant slot are rejected
+    {
+        RawSet<u64> s{};
+        for (u64 key{0u}; key < 10u; ++key)
+        {
+            s.insert(key);
+        }
+        const auto corrupt{[&]<typename T>(const u64 offset, const T v) {
+            ASSERT_TRUE(s.save(path.c_str()));
+            std::FILE * const file{std::fopen(path.c_str(), "r+b")};
+            ASSERT_TRUE(file);
+            ASSERT_EQ(0, std::fseek(file, long(offset), SEEK_SET));
+            ASSERT_EQ(1u, std::fwrite(&v, sizeof(v), 1u, file));
+            ASSERT_EQ(0, std::fclose(file));
+        }};
+        using Header = qc::hash::_private::SnapshotHeader;
+
+        corrupt(offsetof(Header, maxLoadFactor), 0.0f);
+        ASSERT_FALSE(RawSet<u64>::load(path.c_str()));
+        corrupt(offsetof(Header, maxLoadFactor), 2.0f);
+        ASSERT_FALSE(RawSet<u64>::load(path.c_str()));
+        corrupt(offsetof(Header, maxLoadFactor), std::numeric_limits<f32>::quiet_NaN());
+        ASSERT_FALSE(RawSet<u64>::load(path.c_str()));
+        corrupt(offsetof(Header, size), u64{s.slot_n()});
+        ASSERT_FALSE(RawSet<u64>::load(path.c_str()));
+        corrupt(offsetof(Header, graveN), u64{s.slot_n() - s.size()});
+        ASSERT_FALSE(RawSet<u64>::load(path.c_str()));
+        #ifdef QC_HASH_MMAP_ENABLED
+            ASSERT_FALSE(RawSet<u64>::view(path.c_str()));
+        #endif
+
+        // Graves that still leave a vacant slot are fine
+        corrupt(offsetof(Header, graveN), u64{s.slot_n() - s.size() - 1u});
+        ASSERT_TRUE(RawSet<u64>::load(path.c_str()));
+    }
+
+    // Corrupted slot counts and sentinel slots are rejected
+    {
+        using Header = qc::hash::_private::SnapshotHeader;
+        const auto patch{[&]<typename T>(const u64 offset, const T v) {
+            std::FILE * const file{std::fopen(path.c_str(), "r+b")};
+            ASSERT_TRUE(file);
+            ASSERT_EQ(0, std::fseek(file, long(offset), SEEK_SET));
+            ASSERT_EQ(1u, std::fwrite(&v, sizeof(v), 1u, file));
+            ASSERT_EQ(0, std::fclose(file));
+        }};
+        const auto rejected{[&]() {
+            #ifdef QC_HASH_MMAP_ENABLED
+                ASSERT_FALSE(RawSet<u32>::view(path.c_str()));
+            #endif
+            ASSERT_FALSE(RawSet<u32>::load(path.c_str()));
+        }};
+
+        RawSet<u32> s{};
+        s.insert(7u);
+
+        // Too few slots to probe, even with the data sized to match
+        ASSERT_TRUE(s.save(path.c_str()));
+        patch(offsetof(Header, slotN), u64{2u});
+        patch(offsetof(Header, maxLoadFactor), 1.0f);
+        std::filesystem::resize_file(path, qc::hash::_private::snapshotDataOffset + (2u + 4u) * sizeof(u32));
+        rejected();
+
+        // Too few slots for an empty set, whose first insertion would then probe past the end
+        ASSERT_TRUE(RawSet<u32>{}.save(path.c_str()));
+        patch(offsetof(Header, slotN), u64{1u});
+        rejected();
+
+        // So many slots the allocation size overflows
+        ASSERT_TRUE(RawSet<u32>{}.save(path.c_str()));
+        patch(offsetof(Header, slotN), u64{1u} << 63);
+        rejected();
+        ASSERT_TRUE(s.save(path.c_str()));
+        patch(offsetof(Header, slotN), u64{1u} << 62);
+        rejected();
+
+        // Special and terminal slots that don't hold the expected keys
+        for (u64 i{0u}; i < 4u; ++i)
+        {
+            ASSERT_TRUE(s.save(path.c_str()));
+            patch(qc::hash::_private::snapshotDataOffset + (s.slot_n() + i) * sizeof(u32), u32{7u});
+            rejected();
+        }
+
+        // Unchanged, the same snapshot loads fine
+        ASSERT_TRUE(s.save(path.c_str()));
+        ASSERT_TRUE(RawSet<u32>::load(path.c_str())->contains(7u));
+    }
+
+    // Snapshots laid out by another probing policy are rejected
+    {
+        using LinearSet = RawSet<u64, qc::hash::IdentityHash<u64>>;
+        using RobinHoodSet = RawSet<u64, qc::hash::IdentityHash<u64>, std::allocator<u64>, RobinHoodPolicy>;
+        using ShiftSet = RawSet<u64, qc::hash::IdentityHash<u64>, std::allocator<u64>, ShiftPolicy>;
+
+        // 33 lands past 2, which is in its ideal slot, so a Robin Hood lookup would stop short of it
+        LinearSet linear{};
+        linear.insert(2u);
+        linear.insert(1u);
+        linear.insert(33u);
+        ASSERT_TRUE(linear.save(path.c_str()));
+        ASSERT_FALSE(RobinHoodSet::load(path.c_str()));
+        #ifdef QC_HASH_MMAP_ENABLED
+            ASSERT_FALSE(RobinHoodSet::view(path.c_str()));
+        #endif
+        ASSERT_TRUE(ShiftSet::load(path.c_str())->contains(33u));
+
+        RobinHoodSet robinHood{};
+        robinHood.insert(linear.begin(), linear.end());
+        ASSERT_TRUE(robinHood.save(path.c_str()));
+        ASSERT_FALSE(LinearSet::load(path.c_str()));
+        ASSERT_TRUE(RobinHoodSet::load(path.c_str())->contains(33u));
+
+        // Graves are only accepted by policies that expect them
+        linear.erase(1u);
+        ASSERT_EQ(1u, linear.grave_n());
+        ASSERT_TRUE(linear.save(path.c_str()));
+        ASSERT_FALSE(ShiftSet::load(path.c_str()));
+        ASSERT_TRUE(LinearSet::load(path.c_str())->contains(33u));
+    }
+
+    // Split storage
+    RawMap<u32, u64, qc::hash::FastHash<u32>, std::allocator<std::pair<u32, u64>>, SplitPolicy> split{};
+    for (u32 key{0u}; key < 1000u; ++key)
+    {
+        split.emplace(key, u64(key) << 32);
+    }
+    ASSERT_TRUE(split.save(path.c_str()));
+    ASSERT_EQ(split, *decltype(split)::load(path.c_str()));
+
+    ASSERT_FALSE(RawSet<u64>::load((path + ".missing").c_str()));
+    std::filesystem::remove(path);
+}
+
+TEST(frozenSet, general)
+{
+    qc::Random random{};
+
+    for (const u64 size : {0u, 1u, 100u, 10000u, 100000u})
+    {
+        RawSet<u64> s{};
+        while (s.size() < size)
+        {
+            s.insert(random.next<u64>());
+        }
+
+        const qc::hash::FrozenRawSet<u64> frozen{s.freeze()};
+        ASSERT_EQ(s.size(), frozen.size());
+        ASSERT_EQ(size == 0u, frozen.empty());
+        if (size >= 10000u)
+        {
+            ASSERT_GE(frozen.load_factor(), 0.9f);
+            ASSERT_LE(frozen.stash_n(), 8u);
+        }
+
+        for (const u64 key : s)
+        {
+            ASSERT_TRUE(frozen.contains(key));
+            ASSERT_EQ(key, *frozen.find(key));
+        }
+        for (u64 i{0u}; i < size; ++i)
+        {
+            const u64 key{random.next<u64>()};
+            ASSERT_EQ(s.contains(key), frozen.contains(key));
+        }
+
+        u64 n{0u};
+        for (const u64 key : frozen)
+        {
+            ASSERT_TRUE(s.contains(key));
+            ++n;
+        }
+        ASSERT_EQ(size, n);
+    }
+
+    // A mixing hasher's output picks the buckets as is
+    {
+        RawSet<u64, qc::hash::FastHash<u64>> s{};
+        while (s.size() < 10000u)
+        {
+            s.insert(random.next<u64>());
+        }
+
+        const qc::hash::FrozenRawSet<u64, qc::hash::FastHash<u64>> frozen{s};
+        ASSERT_GE(frozen.load_factor(), 0.9f);
+        ASSERT_LE(frozen.stash_n(), 8u);
+        for (const u64 key : s)
+        {
+            ASSERT_TRUE(frozen.contains(key));
+        }
+        for (u64 i{0u}; i < 10000u; ++i)
+        {
+            const u64 key{random.next<u64>()};
+            ASSERT_EQ(s.contains(key), frozen.contains(key));
+        }
+    }
+
+    // Special keys, including the vacant key, which gets a slot of its own
+    RawSet<u8> s{};
+    for (u32 key{0u}; key < 256u; ++key)
+    {
+        s.insert(u8(key));
+    }
+    qc::hash::FrozenRawSet<u8> frozen{s};
+    ASSERT_EQ(256u, frozen.size());
+    for (u32 key{0u}; key < 256u; ++key)
+    {
+        ASSERT_TRUE(frozen.contains(u8(key)));
+    }
+    ASSERT_EQ(256, std::distance(frozen.begin(), frozen.end()));
+
+    // Copy and move
+    qc::hash::FrozenRawSet<u8> copy{frozen};
+    ASSERT_EQ(256u, copy.size());
+    ASSERT_TRUE(copy.contains(u8(255u)));
+    qc::hash::FrozenRawSet<u8> moved{std::move(frozen)};
+    ASSERT_EQ(256u, moved.size());
+    ASSERT_TRUE(frozen.empty());
+    ASSERT_FALSE(frozen.contains(u8(7u)));
+    ASSERT_EQ(frozen.end(), frozen.begin());
+    frozen = copy;
+    ASSERT_EQ(256u, frozen.size());
+    copy = std::move(moved);
+    ASSERT_EQ(256u, copy.size());
+}
+
+TEST(frozenSet, stash)
+{
+    // Every key shares the same two buckets, so all but those buckets' worth must be stashed
+    RawSet<u64, ConstantHash<u64, 7u>> s{};
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        s.insert(key);
+    }
+
+    const qc::hash::FrozenRawSet<u64, ConstantHash<u64, 7u>> frozen{s.freeze()};
+    ASSERT_EQ(100u, frozen.size());
+    ASSERT_GE(frozen.stash_n(), 100u - 2u * 8u);
+    for (u64 key{0u}; key < 100u; ++key)
+    {
+        ASSERT_TRUE(frozen.contains(key));
+    }
+    ASSERT_FALSE(frozen.contains(100u));
+    ASSERT_EQ(100, std::distance(frozen.begin(), frozen.end()));
+}
+
+TEST(frozenMap, general)
+{
+    RawMap<s32, u64> m{};
+    for (s32 key{-5000}; key < 5000; ++key)
+    {
+        m.emplace(key, u64(key * 2));
+    }
+
+    const qc::hash::FrozenRawMap<s32, u64> frozen{m.freeze()};
+    ASSERT_EQ(m.size(), frozen.size());
+    for (s32 key{-5000}; key < 5000; ++key)
+    {
+        const auto it{frozen.find(key)};
+        ASSERT_NE(frozen.end(), it);
+        ASSERT_EQ(key, it->first);
+        ASSERT_EQ(u64(key * 2), it->second);
+    }
+    ASSERT_FALSE(frozen.contains(5000));
+    ASSERT_EQ(0u, frozen.count(5000));
+    ASSERT_EQ(1u, frozen.count(-1));
+    ASSERT_EQ(frozen.end(), frozen.find(-5001));
+
+    // Heterogeneous lookup
+    ASSERT_TRUE(frozen.contains(s16(7)));
+    ASSERT_TRUE(frozen.contains(u16(7u)));
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        ASSERT_EQ(14u, frozen.at(s8(7)));
+        ASSERT_THROW(static_cast<void>(frozen.at(5000)), std::out_of_range);
+    #endif
+
+    u64 sum{0u};
+    for (const auto & [key, value] : frozen)
+    {
+        ASSERT_EQ(m.find(key)->second, value);
+        sum += value;
+    }
+    ASSERT_EQ(u64(-10000), sum);
+
+    // Split storage
+    RawMap<u32, u64, qc::hash::FastHash<u32>, std::allocator<std::pair<u32, u64>>, SplitPolicy> split{};
+    for (u32 key{0u}; key < 1000u; ++key)
+    {
+        split.emplace(key, u64(key) << 32);
+    }
+    const auto frozenSplit{split.freeze()};
+    for (u32 key{0u}; key < 1000u; ++key)
+    {
+        ASSERT_EQ(u64(key) << 32, frozenSplit.find(key)->second);
+    }
+}
+
+TEST(frozenMap, move)
+{
+    RawMap<std::unique_ptr<s32>, std::unique_ptr<s32>> m{};
+    for (s32 i{0}; i < 1000; ++i)
+    {
+        m.emplace(std::make_unique<s32>(i), std::make_unique<s32>(-i));
+    }
+
+    std::vector<const s32 *> keys{};
+    for (const auto & element : m)
+    {
+        keys.push_back(element.first.get());
+    }
+
+    const qc::hash::FrozenRawMap<std::unique_ptr<s32>, std::unique_ptr<s32>> frozen{std::move(m).freeze()};
+    ASSERT_TRUE(m.empty());
+    ASSERT_EQ(1000u, frozen.size());
+    for (const s32 * const key : keys)
+    {
+        ASSERT_EQ(-*key, *frozen.find(key)->second);
+    }
+
+    s32 sum{0};
+    for (const auto & element : frozen)
+    {
+        sum += *element.first;
+    }
+    ASSERT_EQ(999 * 1000 / 2, sum);
+
+    // Keys and values are destroyed with the frozen map
+    Tracked2::resetTotals();
+    {
+        TrackedMap tracked{};
+        for (s32 i{0}; i < 100; ++i)
+        {
+            tracked.emplace(Tracked2{i}, Tracked2{i});
+        }
+        const auto frozenTracked{std::move(tracked).freeze()};
+        ASSERT_EQ(100u, frozenTracked.size());
+        ASSERT_EQ(7, frozenTracked.find(Tracked2{7})->second.val);
+    }
+    // The value constructor is not counted
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 201, Tracked2::totalStats.destructs);
+}
+
+TEST(stringSet, general)
+{
+    qc::hash::StringSet<> s{};
+    ASSERT_TRUE(s.empty());
+    ASSERT_FALSE(s.contains("a"));
+    ASSERT_EQ(s.end(), s.begin());
+
+    // Short keys live in the string object, long keys do not
+    const auto key{[](const u64 i) { return i % 2u ? std::to_string(i) : std::string(40u, 'x') + std::to_string(i); }};
+
+    for (u64 i{0u}; i < 10000u; ++i)
+    {
+        ASSERT_TRUE(s.insert(key(i)).second);
+    }
+    ASSERT_EQ(10000u, s.size());
+    ASSERT_FALSE(s.insert(key(7u)).second);
+    ASSERT_FALSE(s.try_emplace(std::string_view{key(8u)}).second);
+    ASSERT_LE(s.size(), s.capacity());
+
+    for (u64 i{0u}; i < 10000u; ++i)
+    {
+        const std::string k{key(i)};
+        ASSERT_TRUE(s.contains(k));
+        ASSERT_TRUE(s.contains(std::string_view{k}));
+        ASSERT_TRUE(s.contains(k.c_str()));
+        ASSERT_EQ(k, *s.find(k));
+    }
+    ASSERT_FALSE(s.contains("10000"));
+    ASSERT_FALSE(s.contains(""));
+
+    u64 n{0u};
+    for (const std::string & k : s)
+    {
+        ASSERT_TRUE(s.contains(k));
+        ++n;
+    }
+    ASSERT_EQ(10000u, n);
+
+    // Erase half, leaving graves behind, then reinsert over them
+    for (u64 i{0u}; i < 10000u; i += 2u)
+    {
+        ASSERT_TRUE(s.erase(key(i)));
+    }
+    ASSERT_FALSE(s.erase(key(0u)));
+    ASSERT_EQ(5000u, s.size());
+    for (u64 i{0u}; i < 10000u; ++i)
+    {
+        ASSERT_EQ(i % 2u == 1u, s.contains(key(i)));
+    }
+    for (u64 i{0u}; i < 10000u; i += 2u)
+    {
+        ASSERT_TRUE(s.insert(key(i)).second);
+    }
+    ASSERT_EQ(10000u, s.size());
+
+    // Churning erasures and insertions never lets graves fill the table
+    const u64 slotN{s.slot_n()};
+    for (u64 i{10000u}; i < 200000u; ++i)
+    {
+        s.erase(key(i - 10000u));
+        s.insert(key(i));
+    }
+    ASSERT_EQ(10000u, s.size());
+    ASSERT_EQ(slotN, s.slot_n());
+    ASSERT_LE(s.size() + s.grave_n(), s.capacity());
+
+    // Empty key
+    ASSERT_TRUE(s.insert("").second);
+    ASSERT_TRUE(s.contains(""));
+
+    // Erase by iterator
+    s.erase(s.find(""));
+    ASSERT_FALSE(s.contains(""));
+
+    // Copy, move, and equality
+    qc::hash::StringSet<> copy{s};
+    ASSERT_EQ(s, copy);
+    copy.erase(key(199999u));
+    ASSERT_NE(s, copy);
+    copy = s;
+    ASSERT_EQ(s, copy);
+    qc::hash::StringSet<> moved{std::move(copy)};
+    ASSERT_EQ(s, moved);
+    ASSERT_TRUE(copy.empty());
+    copy = std::move(moved);
+    ASSERT_EQ(s, copy);
+
+    s.clear();
+    ASSERT_TRUE(s.empty());
+    ASSERT_FALSE(s.contains(key(199999u)));
+    ASSERT_EQ(s.end(), s.begin());
+}
+
+TEST(stringMap, general)
+{
+    qc::hash::StringMap<u64> m{{"one", 1u}, {"two", 2u}, {"three", 3u}};
+    ASSERT_EQ(3u, m.size());
+    ASSERT_EQ(2u, m.find("two")->second);
+    #ifdef QC_HASH_EXCEPTIONS_ENABLED
+        ASSERT_EQ(3u, m.at("three"));
+        ASSERT_THROW(static_cast<void>(m.at("four")), std::out_of_range);
+    #endif
+
+    m["four"] = 4u;
+    ++m[std::string_view{"four"}];
+    ASSERT_EQ(5u, m.find(std::string{"four"})->second);
+    ASSERT_FALSE(m.emplace("one", 10u).second);
+    ASSERT_EQ(1u, m.find("one")->second);
+    ASSERT_TRUE(m.try_emplace(std::string{"five"}, 5u).second);
+
+    u64 sum{0u};
+    for (const auto & [key, value] : m)
+    {
+        sum += value;
+    }
+    ASSERT_EQ(1u + 2u + 3u + 5u + 5u, sum);
+
+    // Reserving rehashes from the cached hashes
+    m.reserve(1000u);
+    ASSERT_GE(m.capacity(), 1000u);
+    ASSERT_EQ(5u, m.size());
+    ASSERT_EQ(3u, m.find("three")->second);
+
+    // Move-only values
+    qc::hash::StringMap<std::unique_ptr<s32>> p{};
+    for (s32 i{0}; i < 1000; ++i)
+    {
+        p.emplace(std::to_string(i), std::make_unique<s32>(i));
+    }
+    for (s32 i{0}; i < 1000; ++i)
+    {
+        ASSERT_EQ(i, *p.find(std::to_string(i))->second);
+    }
+}
+
+TEST(generic, selection)
+{
+    struct Big { u64 v[8]; };
+
+    static_assert(std::is_same_v<qc::hash::Map<u32, u64>, RawMap<u32, u64>>);
+    static_assert(std::is_same_v<qc::hash::Set<s16>, qc::hash::DirectSet<s16>>);
+    static_assert(std::is_same_v<qc::hash::Map<u8, std::string>, qc::hash::DirectMap<u8, std::string>>);
+    static_assert(std::is_same_v<qc::hash::Map<u16, u64>, qc::hash::DirectMap<u16, u64>>);
+    static_assert(std::is_same_v<qc::hash::Map<u16, std::pair<u64, u64>>, RawMap<u16, std::pair<u64, u64>>>);
+    static_assert(std::is_same_v<qc::hash::Set<std::pair<u64, u64>>, RawSet<std::pair<u64, u64>, qc::hash::FastHash<std::pair<u64, u64>>>>);
+    static_assert(std::is_same_v<typename qc::hash::Map<u64, Big>::value_type, std::pair<u64, Big>>);
+    static_assert(std::is_same_v<typename qc::hash::Map<u64, Big>::reference, std::pair<const u64 &, Big &>>);
+    static_assert(std::is_same_v<qc::hash::Map<std::string, s32>, qc::hash::StringMap<s32>>);
+    static_assert(std::is_same_v<qc::hash::Set<std::string>, qc::hash::StringSet<>>);
+    static_assert(std::is_same_v<qc::hash::Set<std::string_view>, qc::hash::MetaSet<std::string_view>>);
+}
+
+struct VectorHash
+{
+    u64 operator()(const std::vector<u8> & v) const
+    {
+        return qc::hash::fastHash::hash<u64>(v.data(), v.size());
+    }
+};
+
+TEST(generic, general)
+{
+    qc::hash::Map<std::string, u64> strings{};
+    strings["a"] = 1u;
+    ASSERT_EQ(1u, strings.find("a")->second);
+
+    // Keys that are neither uniquely representable nor strings
+    qc::hash::Set<std::string_view> views{};
+    ASSERT_TRUE(views.insert("abc").second);
+    ASSERT_FALSE(views.insert(std::string_view{"abc"}).second);
+    ASSERT_TRUE(views.contains("abc"));
+    ASSERT_FALSE(views.contains("abcd"));
+
+    qc::hash::MetaMap<std::vector<u8>, u64, VectorHash> vectors{};
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        ASSERT_TRUE(vectors.emplace(std::vector<u8>(i % 50u + 1u, u8(i)), i).second);
+    }
+    ASSERT_EQ(1000u, vectors.size());
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        ASSERT_EQ(i, vectors.find(std::vector<u8>(i % 50u + 1u, u8(i)))->second);
+    }
+    ASSERT_TRUE(vectors.erase(std::vector<u8>(4u, u8(3u))));
+    ASSERT_FALSE(vectors.contains(std::vector<u8>(4u, u8(3u))));
+
+    struct Big { u64 v[8]; };
+    qc::hash::Map<u64, Big> big{};
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        big.emplace(i, Big{{i}});
+    }
+    ASSERT_EQ(7u, big.find(7u)->second.v[0]);
+}
+
+TEST(map, floatKeys)
+{
+    using qc::hash::CanonicalFloat;
+
+    static_assert(qc::hash::Rawable<CanonicalFloat<f32>>);
+    static_assert(qc::hash::Rawable<CanonicalFloat<f64>>);
+    static_assert(std::is_same_v<qc::hash::RawType<CanonicalFloat<f32>>, u32>);
+    static_assert(std::is_same_v<qc::hash::RawType<CanonicalFloat<f64>>, u64>);
+    static_assert(std::is_same_v<qc::hash::Map<f64, u64>, RawMap<CanonicalFloat<f64>, u64>>);
+    static_assert(std::is_same_v<qc::hash::Set<f32>, RawSet<CanonicalFloat<f32>>>);
+
+    // Zeros and NaNs are canonicalized
+    ASSERT_EQ(std::bit_cast<u64>(0.0), std::bit_cast<u64>(f64(CanonicalFloat{-0.0})));
+    ASSERT_EQ(std::bit_cast<u32>(0.0f), std::bit_cast<u32>(f32(CanonicalFloat{-0.0f})));
+    const f64 nan1{std::numeric_limits<f64>::quiet_NaN()};
+    const f64 nan2{std::bit_cast<f64>(std::bit_cast<u64>(nan1) | 0x8000'0000'0000'1234u)};
+    const f64 nan3{std::numeric_limits<f64>::signaling_NaN()};
+    ASSERT_TRUE(std::isnan(nan2));
+    ASSERT_EQ(CanonicalFloat{nan1}, CanonicalFloat{nan2});
+    ASSERT_EQ(CanonicalFloat{nan1}, CanonicalFloat{nan3});
+    ASSERT_TRUE(std::isnan(f64(CanonicalFloat{nan3})));
+    ASSERT_NE(CanonicalFloat{std::numeric_limits<f64>::infinity()}, CanonicalFloat{nan1});
+    ASSERT_NE(CanonicalFloat{std::numeric_limits<f64>::infinity()}, CanonicalFloat{-std::numeric_limits<f64>::infinity()});
+    ASSERT_NE(CanonicalFloat{std::numeric_limits<f64>::denorm_min()}, CanonicalFloat{0.0});
+    ASSERT_EQ(-1.5, f64(CanonicalFloat{-1.5}));
+
+    // Plain floats are canonicalized on the way in
+    qc::hash::Map<f64, u64> m{};
+    ASSERT_TRUE(m.emplace(0.0, 1u).second);
+    ASSERT_FALSE(m.emplace(-0.0, 2u).second);
+    ASSERT_TRUE(m.emplace(nan1, 3u).second);
+    ASSERT_FALSE(m.emplace(nan2, 4u).second);
+    ASSERT_FALSE(m.try_emplace(nan3, 5u).second);
+    ASSERT_EQ(2u, m.size());
+    ASSERT_EQ(1u, m.find(-0.0)->second);
+    ASSERT_EQ(3u, m.find(nan2)->second);
+    ASSERT_TRUE(m.contains(nan3));
+    ASSERT_EQ(1u, m.count(-0.0));
+    ASSERT_EQ(m.slot(0.0), m.slot(-0.0));
+    ASSERT_EQ(m.slot(CanonicalFloat{nan1}), m.slot(nan2));
+
+    // Whole numbers have all zero low bits, but must still spread well
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        ++m[f64(i)];
+        ++m[-f64(i)];
+    }
+    ASSERT_EQ(1u + 999u * 2u + 1u, m.size());
+    ASSERT_EQ(3u, m[0.0]);
+    ASSERT_EQ(1u, m[999.0]);
+    ASSERT_TRUE(m.contains(CanonicalFloat{-999.0}));
+    ASSERT_FALSE(m.contains(1.5));
+    ASSERT_TRUE(m.erase(-0.0));
+    ASSERT_FALSE(m.contains(0.0));
+    ASSERT_TRUE(m.erase(nan2));
+    ASSERT_FALSE(m.erase(nan1));
+
+    qc::hash::Set<f64> s{};
+    std::vector<f64> keys{};
+    for (u64 i{0u}; i < 1000u; ++i)
+    {
+        keys.push_back(f64(i));
+    }
+    keys.push_back(-0.0);
+    ASSERT_EQ(1000u, s.insert(keys.begin(), keys.end()));
+    ASSERT_TRUE(s.contains(-0.0));
+    ASSERT_TRUE(s.contains(999.0));
+    const SetDistStats stats{calcStats(s)};
+    ASSERT_LT(stats.mean, 1.0);
+    ASSERT_LT(stats.max, 16u);
+
+    // As they are for frozen maps
+    {
+        qc::hash::Map<f64, u64> source{};
+        source.emplace(0.0, 1u);
+        source.emplace(nan1, 2u);
+        const qc::hash::FrozenRawMap<CanonicalFloat<f64>, u64> frozen{source};
+        ASSERT_TRUE(frozen.contains(-0.0));
+        ASSERT_TRUE(frozen.contains(nan2));
+        ASSERT_TRUE(frozen.contains(-nan1));
+        ASSERT_EQ(1u, frozen.find(-0.0)->second);
+        ASSERT_EQ(2u, frozen.find(nan3)->second);
+        ASSERT_FALSE(frozen.contains(1.5));
+    }
+
+    // And for inline maps, both inline and spilled
+    {
+        qc::hash::InlineRawSet<CanonicalFloat<f64>, 4u> inlineS{};
+        ASSERT_TRUE(inlineS.insert(0.0).second);
+        ASSERT_FALSE(inlineS.try_emplace(-0.0).second);
+        ASSERT_TRUE(inlineS.insert(nan1).second);
+        ASSERT_FALSE(inlineS.insert(nan2).second);
+        ASSERT_EQ(2u, inlineS.size());
+        ASSERT_TRUE(inlineS.contains(-0.0));
+        ASSERT_TRUE(inlineS.contains(nan3));
+        ASSERT_NE(inlineS.end(), inlineS.find(-nan1));
+        ASSERT_FALSE(inlineS.contains(1.5));
+        ASSERT_TRUE(inlineS.erase(-0.0));
+        ASSERT_FALSE(inlineS.contains(0.0));
+
+        for (u64 i{1u}; i <= 8u; ++i)
+        {
+            inlineS.insert(f64(i));
+        }
+        ASSERT_TRUE(inlineS.try_emplace(-0.0).second);
+        ASSERT_FALSE(inlineS.try_emplace(0.0).second);
+        ASSERT_EQ(10u, inlineS.size());
+        ASSERT_TRUE(inlineS.contains(-0.0));
+        ASSERT_TRUE(inlineS.contains(nan2));
+    }
+}
+
+TEST(directSet, general)
+{
+    qc::hash::DirectSet<s16> s{};
+    static_assert(qc::hash::DirectSet<s16>::capacity() == 65536u);
+    ASSERT_TRUE(s.empty());
+    ASSERT_FALSE(s.contains(s16(7)));
+    ASSERT_EQ(s.end(), s.begin());
+
+    for (s32 k{-32768}; k < 32768; k += 3)
+    {
+        ASSERT_TRUE(s.insert(s16(k)).second);
+        ASSERT_FALSE(s.insert(s16(k)).second);
+    }
+    ASSERT_EQ(21846u, s.size());
+
+    // Heterogeneous lookup converts by value, so narrower negative keys work
+    ASSERT_TRUE(s.contains(s8(-125)));
+    ASSERT_FALSE(s.contains(s8(-124)));
+    ASSERT_TRUE(s.contains(s16(-32768)));
+    ASSERT_TRUE(s.contains(s16(32767)));
+    ASSERT_FALSE(s.contains(s16(32766)));
+
+    // Iteration is in raw key order
+    u64 n{0u};
+    u16 prev{0u};
+    for (const s16 k : s)
+    {
+        ASSERT_EQ(0, (s32(k) + 32768) % 3);
+        ASSERT_TRUE(n == 0u || u16(k) > prev);
+        prev = u16(k);
+        ++n;
+    }
+    ASSERT_EQ(s.size(), n);
+    ASSERT_EQ(s16(1), *s.begin());
+
+    for (s32 k{-32768}; k < 32768; k += 6)
+    {
+        ASSERT_TRUE(s.erase(s16(k)));
+        ASSERT_FALSE(s.erase(s16(k)));
+    }
+    ASSERT_EQ(21846u - 10923u, s.size());
+    ASSERT_FALSE(s.contains(s16(-32768)));
+    ASSERT_TRUE(s.contains(s16(-32765)));
+
+    s.erase(s.find(s16(-32765)));
+    ASSERT_FALSE(s.contains(s16(-32765)));
+    ASSERT_EQ(s.end(), s.find(s16(-32765)));
+
+    qc::hash::DirectSet<s16> s2{s};
+    ASSERT_EQ(s, s2);
+    ASSERT_TRUE(s2.erase(s16(1)));
+    ASSERT_NE(s, s2);
+
+    s.clear();
+    ASSERT_TRUE(s.empty());
+    ASSERT_EQ(s.end(), s.begin());
+    ASSERT_FALSE(s.contains(s16(1)));
+
+    qc::hash::DirectSet<u8> s3{u8(255u), u8(0u), u8(64u), u8(63u)};
+    ASSERT_EQ(4u, s3.size());
+    std::vector<u8> keys(s3.begin(), s3.end());
+    ASSERT_EQ((std::vector<u8>{0u, 63u, 64u, 255u}), keys);
+}
+
+TEST(directMap, general)
+{
+    Tracked2::resetTotals();
+    {
+        qc::hash::DirectMap<u8, Tracked2> m{};
+        for (u64 i{0u}; i < 256u; i += 2u)
+        {
+            ASSERT_TRUE(m.emplace(u8(i), Tracked2{s32(i)}).second);
+            ASSERT_FALSE(m.try_emplace(u8(i), s32(i + 1u)).second);
+        }
+        ASSERT_EQ(128u, m.size());
+        ASSERT_EQ(10, m.find(u8(10u))->second.val);
+        ASSERT_EQ(m.end(), m.find(u8(11u)));
+        ASSERT_TRUE(m.contains(u8(254u)));
+
+        for (auto [key, value] : m)
+        {
+            ASSERT_EQ(s32(key), value.val);
+            value = Tracked2{s32(key) * 2};
+        }
+        ASSERT_EQ(20, m.find(u8(10u))->second.val);
+
+        ASSERT_EQ(0, m[u8(11u)].val);
+        ASSERT_EQ(129u, m.size());
+
+        qc::hash::DirectMap<u8, Tracked2> m2{std::move(m)};
+        ASSERT_TRUE(m.empty());
+        ASSERT_EQ(129u, m2.size());
+        m = m2;
+        ASSERT_EQ(m, m2);
+
+        ASSERT_TRUE(m2.erase(u8(10u)));
+        ASSERT_FALSE(m2.contains(u8(10u)));
+        ASSERT_NE(m, m2);
+
+        m.clear();
+        ASSERT_TRUE(m.empty());
+        m.insert({u8(5u), Tracked2{5}});
+        ASSERT_EQ(1u, m.size());
+    }
+    // The 257 temporaries made from a value are not counted as constructions
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 257, Tracked2::totalStats.destructs);
+
+    enum class Opcode : u8 { nop, load, store, halt = 255 };
+    qc::hash::DirectMap<Opcode, std::string> names{};
+    names[Opcode::load] = "load";
+    names[Opcode::halt] = "halt";
+    ASSERT_EQ("halt", names.find(Opcode::halt)->second);
+    ASSERT_FALSE(names.contains(Opcode::store));
+    ASSERT_EQ(Opcode::load, names.begin()->first);
+}
+
+TEST(inlineSet, general)
+{
+    using Set = qc::hash::InlineRawSet<u64, 8u, qc::hash::IdentityHash<u64>, qc::memory::RecordAllocator<u64>>;
+
+    Set s{};
+    ASSERT_TRUE(s.empty());
+    ASSERT_EQ(s.end(), s.begin());
+    ASSERT_FALSE(s.contains(0u));
+
+    // Zero must not match the unused lanes
+    ASSERT_TRUE(s.insert(0u).second);
+    ASSERT_FALSE(s.insert(0u).second);
+    for (u64 k{1u}; k < 8u; ++k)
+    {
+        ASSERT_TRUE(s.insert(k * 1000u).second);
+    }
+    ASSERT_EQ(8u, s.size());
+    ASSERT_FALSE(s.spilled());
+    ASSERT_EQ(0u, s.get_allocator().stats().allocations);
+    for (u64 k{1u}; k < 8u; ++k)
+    {
+        ASSERT_TRUE(s.contains(k * 1000u));
+        ASSERT_FALSE(s.contains(k * 1000u + 1u));
+        ASSERT_EQ(k * 1000u, *s.find(k * 1000u));
+    }
+    ASSERT_TRUE(s.contains(u32(7000u)));
+
+    u64 sum{0u};
+    for (const u64 k : s)
+    {
+        sum += k;
+    }
+    ASSERT_EQ(28000u, sum);
+
+    // Erasing moves the last element into the hole
+    ASSERT_TRUE(s.erase(3000u));
+    ASSERT_FALSE(s.erase(3000u));
+    ASSERT_EQ(7u, s.size());
+    ASSERT_FALSE(s.contains(3000u));
+    ASSERT_TRUE(s.contains(7000u));
+    s.erase(s.find(0u));
+    ASSERT_FALSE(s.contains(0u));
+    ASSERT_EQ(6u, u64(std::distance(s.begin(), s.end())));
+
+    Set s2{s};
+    ASSERT_EQ(s, s2);
+    ASSERT_TRUE(s.insert(3000u).second);
+    ASSERT_TRUE(s.insert(0u).second);
+    ASSERT_FALSE(s.spilled());
+    ASSERT_NE(s, s2);
+
+    // The ninth element spills everything to the table
+    ASSERT_TRUE(s.insert(8000u).second);
+    ASSERT_TRUE(s.spilled());
+    ASSERT_EQ(1u, s.get_allocator().stats().allocations);
+    ASSERT_EQ(9u, s.size());
+    for (u64 k{0u}; k < 9u; ++k)
+    {
+        ASSERT_TRUE(s.contains(k * 1000u));
+    }
+    for (u64 k{9u}; k < 100u; ++k)
+    {
+        ASSERT_TRUE(s.insert(k * 1000u).second);
+    }
+    ASSERT_EQ(100u, s.size());
+    ASSERT_EQ(100u, u64(std::distance(s.begin(), s.end())));
+    ASSERT_TRUE(s.erase(50000u));
+    ASSERT_FALSE(s.contains(50000u));
+
+    Set s3{std::move(s)};
+    ASSERT_TRUE(s3.spilled());
+    ASSERT_EQ(99u, s3.size());
+    ASSERT_TRUE(s.empty());
+    ASSERT_FALSE(s.spilled());
+
+    s3.swap(s2);
+    ASSERT_EQ(6u, s3.size());
+    ASSERT_FALSE(s3.spilled());
+    ASSERT_EQ(99u, s2.size());
+
+    s2.clear();
+    ASSERT_TRUE(s2.empty());
+    ASSERT_TRUE(s2.spilled());
+}
+
+TEST(inlineMap, general)
+{
+    Tracked2::resetTotals();
+    {
+        qc::hash::InlineRawMap<u32, Tracked2, 4u> m{};
+        for (u32 k{0u}; k < 4u; ++k)
+        {
+            ASSERT_TRUE(m.try_emplace(k, s32(k)).second);
+            ASSERT_FALSE(m.try_emplace(k, s32(k) + 1).second);
+        }
+        ASSERT_FALSE(m.spilled());
+        ASSERT_EQ(2, m.find(2u)->second.val);
+        ASSERT_EQ(m.end(), m.find(4u));
+        for (auto [key, value] : m)
+        {
+            ASSERT_EQ(s32(key), value.val);
+        }
+
+        m[1u].val = 10;
+        ASSERT_EQ(10, m.find(1u)->second.val);
+        ASSERT_TRUE(m.erase(0u));
+        ASSERT_EQ(3u, m.size());
+        ASSERT_EQ(3, m.find(3u)->second.val);
+
+        auto m2{m};
+        ASSERT_EQ(m, m2);
+
+        ASSERT_EQ(0, m[4u].val);
+        ASSERT_EQ(0, m[5u].val);
+        ASSERT_TRUE(m.spilled());
+        ASSERT_EQ(5u, m.size());
+        ASSERT_EQ(10, m.find(1u)->second.val);
+        ASSERT_EQ(3, m.find(3u)->second.val);
+        for (auto [key, value] : m)
+        {
+            value.val = s32(key) * 2;
+        }
+        ASSERT_EQ(8, m.find(4u)->second.val);
+
+        m2 = m;
+        ASSERT_TRUE(m2.spilled());
+        ASSERT_EQ(m, m2);
+        m2 = qc::hash::InlineRawMap<u32, Tracked2, 4u>{{7u, Tracked2{7}}};
+        ASSERT_FALSE(m2.spilled());
+        ASSERT_EQ(1u, m2.size());
+        ASSERT_EQ(7, m2.find(7u)->second.val);
+    }
+    // The temporaries made from a value are not counted as constructions
+    ASSERT_EQ(Tracked2::totalStats.constructs() + 4 + 1, Tracked2::totalStats.destructs);
+
+    qc::hash::InlineRawSet<std::unique_ptr<int>> s{};
+    int * const p{new int{5}};
+    s.insert(std::unique_ptr<int>{p});
+    ASSERT_TRUE(s.contains(p));
+    ASSERT_EQ(5, **s.begin());
+    ASSERT_TRUE(s.erase(p));
+    ASSERT_TRUE(s.empty());
+}
+
 template <typename K, typename K_>
 concept HeterogeneityCompiles = requires (RawSet<K> set, RawMap<K, s32> map, const K_ & k, const qc::hash::IdentityHash<K> identityHash, const qc::hash::FastHash<K> fastHash)
 {
@@ -2140,6 +4883,8 @@ TEST(rawable, general)
 
     static_assert(!qc::hash::Rawable<f32>);
     static_assert(!qc::hash::Rawable<f64>);
+    static_assert(qc::hash::Rawable<qc::hash::CanonicalFloat<f32>>);
+    static_assert(qc::hash::Rawable<qc::hash::CanonicalFloat<f64>>);
 
     static_assert(qc::hash::Rawable<std::shared_ptr<f32>>);
     static_assert(qc::hash::Rawable<std::unique_ptr<f32>>);